@@ -0,0 +1,177 @@
+#include "BenchmarkHarness.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace Bench
+{
+    std::vector<Benchmark*>& getRegistry()
+    {
+        static std::vector<Benchmark*> registry;
+        return registry;
+    }
+
+    Benchmark* registerBenchmark(const std::string& name, std::function<void(State&)> function)
+    {
+        // Registered benchmarks live for the whole run
+        auto* benchmark = new Benchmark(name, std::move(function));
+        getRegistry().push_back(benchmark);
+        return benchmark;
+    }
+
+    std::string Runner::makeName(const Benchmark& benchmark, const std::vector<std::int64_t>& arguments)
+    {
+        std::string name = benchmark.name;
+        for (size_t i = 0; i < arguments.size(); ++i)
+        {
+            name += "/";
+            if (i < benchmark.argumentNames.size())
+                name += benchmark.argumentNames[i] + ":";
+            name += std::to_string(arguments[i]);
+        }
+        return name;
+    }
+
+    Result Runner::run(const std::string& name, Benchmark& benchmark, const std::vector<std::int64_t>& arguments, double minSeconds)
+    {
+        State state(arguments, minSeconds);
+        benchmark.function(state);
+
+        Result result;
+        result.name = name;
+        result.label = state.label;
+        result.error = state.error;
+        result.iterations = state.numIterations;
+        result.counters = state.counters;
+
+        double elapsedNs = state.getElapsedSeconds() * 1.0e9;
+        if (state.numIterations > 0)
+            result.nsPerIteration = elapsedNs / static_cast<double>(state.numIterations);
+        if (state.itemsProcessed > 0)
+            result.nsPerItem = elapsedNs / static_cast<double>(state.itemsProcessed);
+
+        return result;
+    }
+
+    void Runner::printHeader()
+    {
+        std::printf("%-72s %14s %12s %12s\n", "Benchmark", "ns/iter", "ns/item", "iterations");
+        std::printf("%s\n", std::string(113, '-').c_str());
+    }
+
+    void Runner::printResult(const Result& result)
+    {
+        if (!result.error.empty())
+        {
+            std::printf("%-72s ERROR: %s\n", result.name.c_str(), result.error.c_str());
+            return;
+        }
+
+        std::printf("%-72s %14.1f %12.3f %12lld", result.name.c_str(), result.nsPerIteration, result.nsPerItem,
+                    static_cast<long long>(result.iterations));
+
+        for (const auto& counter : result.counters)
+            std::printf("  %s=%.4g", counter.first.c_str(), counter.second);
+
+        if (!result.label.empty())
+            std::printf("  %s", result.label.c_str());
+
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+
+    bool Runner::writeJson(const std::vector<Result>& results) const
+    {
+        std::ofstream stream(options.jsonOutputPath);
+        if (!stream)
+            return false;
+
+        stream << "{\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const auto& result = results[i];
+            stream << "    { \"name\": \"" << result.name << "\""
+                   << ", \"iterations\": " << result.iterations
+                   << ", \"ns_per_iteration\": " << result.nsPerIteration
+                   << ", \"ns_per_item\": " << result.nsPerItem;
+
+            for (const auto& counter : result.counters)
+                stream << ", \"" << counter.first << "\": " << counter.second;
+
+            if (!result.label.empty())
+                stream << ", \"label\": \"" << result.label << "\"";
+            if (!result.error.empty())
+                stream << ", \"error\": \"" << result.error << "\"";
+
+            stream << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        stream << "  ]\n}\n";
+        return true;
+    }
+
+    int Runner::runAll()
+    {
+        std::vector<Result> results;
+        bool hadError = false;
+
+        if (!options.listOnly)
+            printHeader();
+
+        for (auto* benchmark : getRegistry())
+        {
+            auto argumentSets = benchmark->argumentSets;
+            if (argumentSets.empty())
+                argumentSets.emplace_back();
+
+            for (const auto& arguments : argumentSets)
+            {
+                auto name = makeName(*benchmark, arguments);
+                if (!options.filter.empty() && name.find(options.filter) == std::string::npos)
+                    continue;
+
+                if (options.listOnly)
+                {
+                    std::printf("%s\n", name.c_str());
+                    continue;
+                }
+
+                auto result = run(name, *benchmark, arguments, options.minSeconds);
+                hadError = hadError || !result.error.empty();
+                printResult(result);
+                results.push_back(std::move(result));
+            }
+        }
+
+        if (!options.jsonOutputPath.empty() && !writeJson(results))
+        {
+            std::fprintf(stderr, "Could not write %s\n", options.jsonOutputPath.c_str());
+            return 1;
+        }
+
+        return hadError ? 1 : 0;
+    }
+
+    Options parseCommandLine(int argc, char* argv[])
+    {
+        Options options;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            const char* argument = argv[i];
+
+            if (std::strncmp(argument, "--filter=", 9) == 0)
+                options.filter = argument + 9;
+            else if (std::strncmp(argument, "--min-time=", 11) == 0)
+                options.minSeconds = std::atof(argument + 11);
+            else if (std::strncmp(argument, "--json=", 7) == 0)
+                options.jsonOutputPath = argument + 7;
+            else if (std::strcmp(argument, "--list") == 0)
+                options.listOnly = true;
+            else
+                std::fprintf(stderr, "Ignoring unknown option %s\n", argument);
+        }
+
+        return options;
+    }
+}
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// Minimal Google-Benchmark-style harness.
+// Benchmarks are plain functions taking a Bench::State, registered with
+// ESKILATOR_BENCHMARK and optionally given argument sets:
+//
+//     static void renderBlock(Bench::State& state)
+//     {
+//         ... setup using state.range(0) ...
+//         while (state.keepRunning())
+//             ... timed work ...
+//         state.setItemsProcessed(state.iterations() * blockSize);
+//     }
+//     ESKILATOR_BENCHMARK(renderBlock)->args({ 64 })->args({ 512 });
+//
+// Items are reported as ns/item, so benchmarks that count sample frames as
+// items report ns/sample directly.
+namespace Bench
+{
+    using Clock = std::chrono::steady_clock;
+
+    class State
+    {
+    public:
+        State(std::vector<std::int64_t> arguments, double minimumSeconds)
+            : args(std::move(arguments)), minSeconds(minimumSeconds) {}
+
+        // Returns true while more timed iterations are needed
+        bool keepRunning()
+        {
+            if (numIterations == 0 && !running)
+            {
+                running = true;
+                start = Clock::now();
+                return true;
+            }
+
+            ++numIterations;
+
+            if (numIterations >= nextCheck)
+            {
+                // Re-check the clock at growing intervals to keep its cost out of short benchmarks
+                nextCheck = numIterations + checkInterval;
+                checkInterval = checkInterval < 4096 ? checkInterval * 2 : checkInterval;
+                if (getElapsedSeconds() >= minSeconds)
+                {
+                    pauseTiming();
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // Exclude setup work done inside the loop from the measurement
+        void pauseTiming()
+        {
+            if (running)
+            {
+                accumulated += Clock::now() - start;
+                running = false;
+            }
+        }
+
+        void resumeTiming()
+        {
+            if (!running)
+            {
+                start = Clock::now();
+                running = true;
+            }
+        }
+
+        std::int64_t range(size_t index) const { return index < args.size() ? args[index] : 0; }
+        std::int64_t iterations() const { return numIterations; }
+
+        void setItemsProcessed(std::int64_t items) { itemsProcessed = items; }
+        void setLabel(const std::string& newLabel) { label = newLabel; }
+        void skipWithError(const std::string& message) { error = message; }
+
+        double getElapsedSeconds() const
+        {
+            auto total = accumulated;
+            if (running)
+                total += Clock::now() - start;
+            return std::chrono::duration<double>(total).count();
+        }
+
+        std::map<std::string, double> counters;
+
+    private:
+        friend class Runner;
+
+        std::vector<std::int64_t> args;
+        double minSeconds;
+        std::int64_t numIterations = 0;
+        std::int64_t nextCheck = 1;
+        std::int64_t checkInterval = 1;
+        std::int64_t itemsProcessed = 0;
+        bool running = false;
+        Clock::time_point start;
+        Clock::duration accumulated { 0 };
+        std::string label;
+        std::string error;
+    };
+
+    class Benchmark
+    {
+    public:
+        Benchmark(std::string benchmarkName, std::function<void(State&)> benchmarkFunction)
+            : name(std::move(benchmarkName)), function(std::move(benchmarkFunction)) {}
+
+        Benchmark* args(std::vector<std::int64_t> arguments)
+        {
+            argumentSets.push_back(std::move(arguments));
+            return this;
+        }
+
+        Benchmark* argNames(std::vector<std::string> names)
+        {
+            argumentNames = std::move(names);
+            return this;
+        }
+
+        std::string name;
+        std::function<void(State&)> function;
+        std::vector<std::vector<std::int64_t>> argumentSets;
+        std::vector<std::string> argumentNames;
+    };
+
+    struct Result
+    {
+        std::string name;
+        std::string label;
+        std::string error;
+        std::int64_t iterations = 0;
+        double nsPerIteration = 0.0;
+        double nsPerItem = 0.0;
+        std::map<std::string, double> counters;
+    };
+
+    struct Options
+    {
+        std::string filter;          // Only run benchmarks whose name contains this
+        double minSeconds = 0.2;     // Minimum timed duration per benchmark
+        std::string jsonOutputPath;  // Optional machine-readable results
+        bool listOnly = false;
+    };
+
+    std::vector<Benchmark*>& getRegistry();
+    Benchmark* registerBenchmark(const std::string& name, std::function<void(State&)> function);
+
+    class Runner
+    {
+    public:
+        explicit Runner(Options runnerOptions) : options(std::move(runnerOptions)) {}
+
+        // Runs every registered benchmark matching the filter, returns non-zero on errors
+        int runAll();
+
+        static Result run(const std::string& name, Benchmark& benchmark, const std::vector<std::int64_t>& arguments, double minSeconds);
+        static std::string makeName(const Benchmark& benchmark, const std::vector<std::int64_t>& arguments);
+
+    private:
+        Options options;
+
+        static void printHeader();
+        static void printResult(const Result& result);
+        bool writeJson(const std::vector<Result>& results) const;
+    };
+
+    // Parse --filter=, --min-time=, --json=, --list
+    Options parseCommandLine(int argc, char* argv[]);
+
+    // Prevent the optimiser from discarding a result
+    template <typename Type>
+    inline void doNotOptimise(Type const& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+}
+
+#define ESKILATOR_BENCHMARK_CONCAT_INNER(a, b) a##b
+#define ESKILATOR_BENCHMARK_CONCAT(a, b) ESKILATOR_BENCHMARK_CONCAT_INNER(a, b)
+
+#define ESKILATOR_BENCHMARK(function) \
+    static ::Bench::Benchmark* ESKILATOR_BENCHMARK_CONCAT(eskilatorBenchmark_, __LINE__) = \
+        ::Bench::registerBenchmark(#function, function)
+
+#define ESKILATOR_BENCHMARK_NAMED(name, function) \
+    static ::Bench::Benchmark* ESKILATOR_BENCHMARK_CONCAT(eskilatorBenchmark_, __LINE__) = \
+        ::Bench::registerBenchmark(name, function)
@@ -0,0 +1,13 @@
+#include "BenchmarkHarness.h"
+
+#include <JuceHeader.h>
+
+// Usage: Eskilator_Benchmarks [--filter=substring] [--min-time=seconds] [--json=path] [--list]
+int main(int argc, char* argv[])
+{
+    // The processor benchmarks construct GliderAudioProcessor, which needs JUCE's singletons
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    Bench::Runner runner(Bench::parseCommandLine(argc, argv));
+    return runner.runAll();
+}
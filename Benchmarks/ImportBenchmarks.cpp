@@ -0,0 +1,247 @@
+#include "BenchmarkHarness.h"
+#include "ResourceUsage.h"
+#include "TestSignals.h"
+#include "PluginProcessor.h"
+#include "SampleManager.h"
+#include "SampleCache.h"
+
+#include <vector>
+
+// Session load cost: SampleManager::loadSample across formats, file sizes, rate
+// conversion and channel counts, warm loads from the sample cache, and
+// getStateInformation / setStateInformation round trips with banks of generated samples.
+//
+// Import arguments: file format (TestSignals::FileFormat), file sample rate, channels
+// and the size of the PCM payload in kB (the file size for WAV / AIFF; FLAC and OGG
+// hold the same audio in less). Files are imported into a 48 kHz session.
+// State arguments: samples in the bank, and whether the files are touched before every
+// restore (so none of the loaded audio can be kept).
+//
+// ns/iter is the wall time of one load or round trip. Counters: allocs and alloc_mb
+// per iteration (see ResourceUsage.h for what is counted where) and peak_rss_mb, the
+// process peak since the benchmark's files were generated (Linux) or since start.
+namespace
+{
+    constexpr double SESSION_SAMPLE_RATE = 48000.0;
+    constexpr int SESSION_BLOCK_SIZE = 512;
+    constexpr double BANK_SAMPLE_SECONDS = 1.0;
+    constexpr double MEGABYTE = 1024.0 * 1024.0;
+
+    // Allocations inside the measured calls and the peak resident size over the run
+    class UsageMeter
+    {
+    public:
+        UsageMeter() { ResourceUsage::resetPeakResidentBytes(); }
+
+        void begin() { start = ResourceUsage::getAllocations(); }
+
+        void end()
+        {
+            const auto now = ResourceUsage::getAllocations();
+            count += now.count - start.count;
+            bytes += now.bytes - start.bytes;
+        }
+
+        void report(Bench::State& state) const
+        {
+            const double iterations = static_cast<double>(juce::jmax<std::int64_t>(1, state.iterations()));
+            state.counters["allocs"] = static_cast<double>(count) / iterations;
+            state.counters["alloc_mb"] = static_cast<double>(bytes) / iterations / MEGABYTE;
+
+            if (const auto peak = ResourceUsage::getPeakResidentBytes(); peak > 0)
+                state.counters["peak_rss_mb"] = static_cast<double>(peak) / MEGABYTE;
+        }
+
+    private:
+        ResourceUsage::Allocations start;
+        std::int64_t count = 0;
+        std::int64_t bytes = 0;
+    };
+
+    void importSample(Bench::State& state)
+    {
+        const auto format = static_cast<TestSignals::FileFormat>(state.range(0));
+        const double fileSampleRate = static_cast<double>(state.range(1));
+        const int numChannels = static_cast<int>(state.range(2));
+        const double payloadBytes = static_cast<double>(state.range(3)) * 1024.0;
+
+        const double bytesPerSecond = fileSampleRate * numChannels * TestSignals::getBitsPerSample(format) / 8;
+        const auto file = TestSignals::getToneFile(fileSampleRate, numChannels, payloadBytes / bytesPerSecond, format);
+        state.setLabel(TestSignals::getFormatName(format));
+        if (file == juce::File())
+        {
+            state.skipWithError(std::string("could not write a ") + TestSignals::getFormatName(format) + " file");
+            return;
+        }
+
+        SampleManager sampleManager;
+        sampleManager.clearSampleBank();
+        UsageMeter meter;
+        std::int64_t framesLoaded = 0;
+
+        while (state.keepRunning())
+        {
+            meter.begin();
+            const bool loaded = sampleManager.loadSample(file, SESSION_SAMPLE_RATE);
+            meter.end();
+
+            state.pauseTiming();
+            if (!loaded)
+            {
+                state.skipWithError("loadSample failed");
+                return;
+            }
+            framesLoaded += sampleManager.getSampleBuffer(0)->getNumSamples();
+            sampleManager.clearSampleBank();
+            state.resumeTiming();
+        }
+
+        // Items are frames delivered at the session rate
+        state.setItemsProcessed(framesLoaded);
+        state.counters["file_mb"] = static_cast<double>(file.getSize()) / MEGABYTE;
+        meter.report(state);
+    }
+
+    // Loads of a file already in the sample cache: an index lookup and a memory map
+    void cachedImport(Bench::State& state)
+    {
+        const double payloadBytes = static_cast<double>(state.range(0)) * 1024.0;
+        const auto format = TestSignals::FileFormat::Wav24;
+        const double bytesPerSecond = 48000.0 * 2 * TestSignals::getBitsPerSample(format) / 8;
+        const auto file = TestSignals::getToneFile(48000.0, 2, payloadBytes / bytesPerSecond, format);
+        if (file == juce::File())
+        {
+            state.skipWithError("could not write a WAV file");
+            return;
+        }
+
+        const auto cacheDirectory = juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("EskilatorBenchmarkCache");
+        cacheDirectory.deleteRecursively();
+
+        SampleManager sampleManager;
+        sampleManager.setCache(std::make_shared<SampleCache>(cacheDirectory));
+        sampleManager.clearSampleBank();
+
+        // The first load decodes and fills the cache
+        if (!sampleManager.loadSample(file, SESSION_SAMPLE_RATE))
+        {
+            state.skipWithError("loadSample failed");
+            return;
+        }
+        sampleManager.clearSampleBank();
+
+        UsageMeter meter;
+        std::int64_t framesLoaded = 0;
+
+        while (state.keepRunning())
+        {
+            meter.begin();
+            const bool loaded = sampleManager.loadSample(file, SESSION_SAMPLE_RATE);
+            meter.end();
+
+            state.pauseTiming();
+            if (!loaded)
+            {
+                state.skipWithError("loadSample failed");
+                return;
+            }
+            framesLoaded += sampleManager.getSampleBuffer(0)->getNumSamples();
+            sampleManager.clearSampleBank();
+            state.resumeTiming();
+        }
+
+        state.setItemsProcessed(framesLoaded);
+        state.counters["file_mb"] = static_cast<double>(file.getSize()) / MEGABYTE;
+        meter.report(state);
+        cacheDirectory.deleteRecursively();
+    }
+
+    void stateRoundTrip(Bench::State& state)
+    {
+        const int numSamples = static_cast<int>(state.range(0));
+        const bool touchFiles = state.range(1) != 0;
+
+        GliderAudioProcessor processor;
+        processor.setRateAndBufferSizeDetails(SESSION_SAMPLE_RATE, SESSION_BLOCK_SIZE);
+        processor.prepareToPlay(SESSION_SAMPLE_RATE, SESSION_BLOCK_SIZE);
+        processor.clearSampleBank();
+
+        std::vector<juce::File> files;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto file = TestSignals::getToneFile(SESSION_SAMPLE_RATE, 2, BANK_SAMPLE_SECONDS,
+                                                       TestSignals::FileFormat::Wav24, i);
+            if (file == juce::File())
+            {
+                state.skipWithError("could not write the bank samples");
+                return;
+            }
+            processor.loadSample(file);
+            files.push_back(file);
+        }
+
+        juce::MemoryBlock stateData;
+        UsageMeter meter;
+
+        juce::int64 touches = 0;
+
+        while (state.keepRunning())
+        {
+            if (touchFiles)
+            {
+                // A new modification time every restore
+                state.pauseTiming();
+                const auto stamp = juce::Time::getCurrentTime() + juce::RelativeTime::seconds(static_cast<double>(++touches));
+                for (const auto& file : files)
+                    file.setLastModificationTime(stamp);
+                state.resumeTiming();
+            }
+
+            meter.begin();
+            stateData.reset();
+            processor.getStateInformation(stateData);
+            processor.setStateInformation(stateData.getData(), static_cast<int>(stateData.getSize()));
+            meter.end();
+        }
+
+        if (processor.getSampleCount() != numSamples)
+            state.skipWithError("the restored bank has " + std::to_string(processor.getSampleCount()) + " samples");
+
+        // Items are samples restored
+        state.setItemsProcessed(state.iterations() * numSamples);
+        state.counters["state_kb"] = static_cast<double>(stateData.getSize()) / 1024.0;
+        meter.report(state);
+        processor.releaseResources();
+    }
+
+    enum Argument { Format, Rate, Channels, Kilobytes };
+
+    // Reference point the sweeps vary one argument of: a 10 MB, 48 kHz, stereo, 24-bit WAV
+    std::vector<std::int64_t> makeArguments(Argument argument, std::int64_t value)
+    {
+        std::vector<std::int64_t> arguments { static_cast<std::int64_t>(TestSignals::FileFormat::Wav24), 48000, 2, 10000 };
+        arguments[static_cast<size_t>(argument)] = value;
+        return arguments;
+    }
+
+    Bench::Benchmark* addSweep(const std::string& name, Argument argument, std::vector<std::int64_t> values)
+    {
+        auto* benchmark = Bench::registerBenchmark("Import/" + name, importSample);
+        benchmark->argNames({ "format", "rate", "ch", "kb" });
+        for (auto value : values)
+            benchmark->args(makeArguments(argument, value));
+        return benchmark;
+    }
+}
+
+static Bench::Benchmark* formatBenchmark = addSweep("Format", Format, { 0, 1, 2, 3, 4, 5 });
+static Bench::Benchmark* fileSizeBenchmark = addSweep("FileSize", Kilobytes, { 100, 1000, 10000, 100000, 1000000 });
+static Bench::Benchmark* rateConversionBenchmark = addSweep("RateConversion", Rate, { 22050, 44100, 48000, 88200, 96000, 192000 });
+static Bench::Benchmark* channelsBenchmark = addSweep("Channels", Channels, { 1, 2, 4, 8 });
+
+static Bench::Benchmark* cachedBenchmark = Bench::registerBenchmark("Import/Cached", cachedImport)
+    ->argNames({ "kb" })->args({ 1000 })->args({ 10000 })->args({ 100000 });
+
+static Bench::Benchmark* stateBenchmark = Bench::registerBenchmark("State/RoundTrip", stateRoundTrip)
+    ->argNames({ "samples", "touch" })->args({ 1, 0 })->args({ 4, 0 })->args({ 16, 0 })->args({ 64, 0 })->args({ 128, 0 })
+    ->args({ 16, 1 })->args({ 128, 1 });
@@ -0,0 +1,115 @@
+#include "BenchmarkHarness.h"
+#include "KernelDispatch.h"
+
+#include <random>
+#include <type_traits>
+#include <vector>
+
+// Cost of the double-precision output path against the float one, following
+// GliderAudioProcessor::renderAudioSegment: the float engine renders with the
+// envelope x gain folded into the kernel, the double engine renders at unity
+// gain into float scratch and applies envelope and gain in double.
+// Arguments: output channels, block size.
+namespace
+{
+    constexpr std::uint32_t SOURCE_FRAMES = 1 << 18;
+
+    struct PrecisionFixture
+    {
+        PrecisionFixture()
+        {
+            std::mt19937 generator(99);
+            std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+            for (auto& channel : sourceData)
+            {
+                channel.resize(SOURCE_FRAMES);
+                for (auto& value : channel)
+                    value = distribution(generator);
+            }
+        }
+
+        std::vector<float> sourceData[2];
+    };
+
+    const PrecisionFixture& getFixture()
+    {
+        static PrecisionFixture fixture;
+        return fixture;
+    }
+
+    template <typename SampleType>
+    void renderPath(Bench::State& state)
+    {
+        const auto& fixture = getFixture();
+        const auto& kernels = KernelDispatch::selectKernels();
+        const int outputChannels = static_cast<int>(state.range(0));
+        const int blockSize = static_cast<int>(state.range(1));
+        constexpr bool rendersInPlace = std::is_same_v<SampleType, float>;
+
+        RenderKernels::Source source;
+        source.numChannels = 2;
+        source.numFrames = SOURCE_FRAMES;
+        source.channels[0] = fixture.sourceData[0].data();
+        source.channels[1] = fixture.sourceData[1].data();
+        const RenderKernels::CrossfadeTable noCrossfade;
+
+        std::vector<SampleType> hostData[2] = { std::vector<SampleType>(static_cast<size_t>(blockSize)),
+                                                std::vector<SampleType>(static_cast<size_t>(blockSize)) };
+        std::vector<float> scratchData[2] = { std::vector<float>(static_cast<size_t>(blockSize)),
+                                              std::vector<float>(static_cast<size_t>(blockSize)) };
+        std::vector<float> envelope(static_cast<size_t>(blockSize), 0.8f);
+        std::vector<float> frameGains(static_cast<size_t>(blockSize));
+        const std::vector<float> unityGains(static_cast<size_t>(blockSize), 1.0f);
+        const SampleType baseGain = static_cast<SampleType>(0.5);
+
+        float* outputs[2] = { nullptr, nullptr };
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            if constexpr (rendersInPlace)
+                outputs[channel] = hostData[channel].data();
+            else
+                outputs[channel] = scratchData[channel].data();
+        }
+
+        auto kernel = kernels.getVoiceKernel(2, outputChannels, false, false);
+        RenderKernels::VoiceState voiceState;
+        voiceState.phaseIncrement = FixedPointPhase::fromDouble(1.0594630943592953);
+
+        while (state.keepRunning())
+        {
+            if (FixedPointPhase::getIndex(voiceState.phase) > SOURCE_FRAMES / 2)
+                voiceState.phase = 0;
+
+            if constexpr (rendersInPlace)
+            {
+                kernels.applyEnvelopeGain(frameGains.data(), envelope.data(), baseGain, blockSize);
+                kernel(source, outputs, blockSize, frameGains.data(), voiceState, noCrossfade);
+            }
+            else
+            {
+                kernel(source, outputs, blockSize, unityGains.data(), voiceState, noCrossfade);
+                for (int channel = 0; channel < outputChannels; ++channel)
+                    for (int i = 0; i < blockSize; ++i)
+                        hostData[channel][static_cast<size_t>(i)] = static_cast<SampleType>(outputs[channel][i])
+                                                                  * static_cast<SampleType>(envelope[static_cast<size_t>(i)]) * baseGain;
+            }
+
+            Bench::doNotOptimise(hostData[0][0]);
+        }
+
+        state.setItemsProcessed(state.iterations() * blockSize);
+    }
+
+    Bench::Benchmark* addPrecisionArguments(Bench::Benchmark* benchmark)
+    {
+        benchmark->argNames({ "out", "block" });
+        for (int outputChannels = 1; outputChannels <= 2; ++outputChannels)
+            for (int blockSize : { 64, 512 })
+                benchmark->args({ outputChannels, blockSize });
+        return benchmark;
+    }
+}
+
+static Bench::Benchmark* floatPathBenchmark = addPrecisionArguments(Bench::registerBenchmark("RenderPath/float", renderPath<float>));
+static Bench::Benchmark* doublePathBenchmark = addPrecisionArguments(Bench::registerBenchmark("RenderPath/double", renderPath<double>));
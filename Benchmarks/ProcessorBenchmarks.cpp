@@ -0,0 +1,177 @@
+#include "BenchmarkHarness.h"
+#include "TestSignals.h"
+#include "PluginProcessor.h"
+
+#include <vector>
+
+// GliderAudioProcessor driven headlessly through processBlock, the way a host runs it.
+// Arguments: block size, sample rate, channels (bus layout and sample), glide steps
+// (0 = glide off), note interval in samples (0 = one note held for the length of the
+// sample) and sample length in seconds.
+//
+// Each note change sends the next note-on followed by the previous note-off at the
+// same sample, so gliding is legato and every event splits the block into another
+// renderAudioSegment. MIDI is generated per block into a preallocated buffer, as a
+// host would. Items are output frames, so ns/item is ns/sample; voices_per_core is
+// how many monophonic instances one core could run in real time at that rate.
+namespace
+{
+    constexpr float GLIDE_TIME_MS = 80.0f;
+    constexpr int NOTE_PATTERN[] = { 60, 55, 62, 57, 64, 53 };
+    constexpr int NUM_PATTERN_NOTES = static_cast<int>(sizeof(NOTE_PATTERN) / sizeof(NOTE_PATTERN[0]));
+
+    void setParameter(juce::AudioProcessorValueTreeState& apvts, const juce::String& parameterID, float value)
+    {
+        if (auto* parameter = apvts.getParameter(parameterID))
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    class NoteSequence
+    {
+    public:
+        NoteSequence(juce::int64 changeInterval, int blockSize)
+            : interval(changeInterval)
+        {
+            // Two events per change, each well under 16 bytes of MidiBuffer storage
+            const auto changesPerBlock = blockSize / juce::jmax<juce::int64>(1, interval) + 1;
+            midi.ensureSize(static_cast<size_t>(changesPerBlock * 2 * 16));
+        }
+
+        juce::MidiBuffer& nextBlock(int blockSize)
+        {
+            midi.clear();
+
+            // First change at or after the start of this block
+            auto change = ((frame + interval - 1) / interval) * interval;
+            for (; change < frame + blockSize; change += interval)
+            {
+                const int nextNote = NOTE_PATTERN[noteIndex];
+                const int position = static_cast<int>(change - frame);
+
+                midi.addEvent(juce::MidiMessage::noteOn(1, nextNote, 0.8f), position);
+                if (currentNote >= 0)
+                    midi.addEvent(juce::MidiMessage::noteOff(1, currentNote), position);
+
+                currentNote = nextNote;
+                noteIndex = (noteIndex + 1) % NUM_PATTERN_NOTES;
+            }
+
+            frame += blockSize;
+            return midi;
+        }
+
+    private:
+        juce::int64 interval;
+        juce::int64 frame = 0;
+        int noteIndex = 0;
+        int currentNote = -1;
+        juce::MidiBuffer midi;
+    };
+
+    void processBlock(Bench::State& state)
+    {
+        const int blockSize = static_cast<int>(state.range(0));
+        const double sampleRate = static_cast<double>(state.range(1));
+        const int numChannels = static_cast<int>(state.range(2));
+        const int glideSteps = static_cast<int>(state.range(3));
+        const auto noteInterval = state.range(4);
+        const double sampleSeconds = static_cast<double>(state.range(5));
+
+        const auto sampleFile = TestSignals::getToneFile(sampleRate, numChannels, sampleSeconds);
+        if (sampleFile == juce::File())
+        {
+            state.skipWithError("could not write the test sample");
+            return;
+        }
+
+        GliderAudioProcessor processor;
+
+        const auto channelSet = numChannels == 1 ? juce::AudioChannelSet::mono() : juce::AudioChannelSet::stereo();
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(channelSet);
+        layout.outputBuses.add(channelSet);
+        if (!processor.setBusesLayout(layout))
+        {
+            state.skipWithError("bus layout not supported");
+            return;
+        }
+
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        processor.clearSampleBank();
+        processor.loadSample(sampleFile);
+        if (!processor.hasSample())
+        {
+            state.skipWithError("could not load the test sample");
+            return;
+        }
+
+        auto& apvts = processor.getAPVTS();
+        setParameter(apvts, "glideTime", glideSteps > 0 ? GLIDE_TIME_MS : 0.0f);
+        if (glideSteps > 0)
+            setParameter(apvts, "glideSteps", static_cast<float>(glideSteps));
+
+        // A held note is re-triggered when it reaches the end of the sample
+        const auto sampleFrames = static_cast<juce::int64>(sampleSeconds * sampleRate);
+        NoteSequence notes(noteInterval > 0 ? noteInterval : sampleFrames, blockSize);
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+
+        while (state.keepRunning())
+        {
+            processor.processBlock(buffer, notes.nextBlock(blockSize));
+            Bench::doNotOptimise(buffer.getReadPointer(0)[0]);
+        }
+
+        const auto frames = state.iterations() * blockSize;
+        state.setItemsProcessed(frames);
+
+        if (frames > 0)
+        {
+            const double nsPerSample = state.getElapsedSeconds() * 1.0e9 / static_cast<double>(frames);
+            state.counters["voices_per_core"] = 1.0e9 / (nsPerSample * sampleRate);
+        }
+
+        // The governor reacts to the measured load; flag runs it degraded
+        if (processor.getQualityTier() != CpuGovernor::QualityTier::Full)
+            state.setLabel(std::string("governor: ") + CpuGovernor::getTierName(processor.getQualityTier()));
+
+        processor.releaseResources();
+    }
+
+    enum Argument { Block, Rate, Channels, Glide, Interval, Seconds };
+
+    // Reference point the sweeps vary one argument of: 512 frames at 48 kHz, stereo,
+    // 8-step glide, a note every 100 ms, 2 s sample
+    std::vector<std::int64_t> makeArguments(Argument argument, std::int64_t value)
+    {
+        std::vector<std::int64_t> arguments { 512, 48000, 2, 8, 4800, 2 };
+        arguments[static_cast<size_t>(argument)] = value;
+        return arguments;
+    }
+
+    Bench::Benchmark* addSweep(const std::string& name, Argument argument, std::vector<std::int64_t> values)
+    {
+        auto* benchmark = Bench::registerBenchmark("Processor/" + name, processBlock);
+        benchmark->argNames({ "block", "rate", "ch", "glide", "interval", "seconds" });
+        for (auto value : values)
+            benchmark->args(makeArguments(argument, value));
+        return benchmark;
+    }
+}
+
+static Bench::Benchmark* blockSizeBenchmark = addSweep("BlockSize", Block, { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 });
+static Bench::Benchmark* sampleRateBenchmark = addSweep("SampleRate", Rate, { 44100, 48000, 88200, 96000, 176400, 192000 });
+static Bench::Benchmark* channelsBenchmark = addSweep("Channels", Channels, { 1, 2 });
+static Bench::Benchmark* glideBenchmark = addSweep("Glide", Glide, { 0, 2, 4, 8, 16 });
+static Bench::Benchmark* denseMidiBenchmark = addSweep("DenseMidi", Interval, { 4, 16, 64, 256 });
+
+// Held notes through long samples (streaming from memory rather than cache)
+static Bench::Benchmark* longSampleBenchmark = []
+{
+    auto* benchmark = Bench::registerBenchmark("Processor/LongSample", processBlock);
+    benchmark->argNames({ "block", "rate", "ch", "glide", "interval", "seconds" });
+    for (std::int64_t seconds : { 1, 60, 300 })
+        benchmark->args({ 512, 48000, 2, 0, 0, seconds });
+    return benchmark;
+}();
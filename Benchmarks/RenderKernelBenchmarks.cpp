@@ -0,0 +1,228 @@
+#include "BenchmarkHarness.h"
+#include "RenderKernels.h"
+#include "KernelDispatch.h"
+
+#include <cmath>
+#include <random>
+
+// Specialised voice kernels against the generic (runtime-branching) path, plus the
+// envelope-gain, import resampling and import analysis kernels, for every instruction
+// set the running CPU supports (RenderKernel/<ISA>, EnvelopeGain/<ISA>, Resample/<ISA>,
+// Analysis/<ISA>).
+// Voice kernel arguments: source channels, output channels, crossfade, gliding, morph, block size.
+namespace
+{
+    constexpr std::uint32_t SOURCE_FRAMES = 1 << 20;
+    constexpr int CROSSFADE_LENGTH = 4096;
+
+    struct KernelFixture
+    {
+        KernelFixture()
+        {
+            std::mt19937 generator(1234);
+            std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+            for (auto& channel : sourceData)
+            {
+                channel.resize(SOURCE_FRAMES);
+                for (auto& value : channel)
+                    value = distribution(generator);
+            }
+
+            crossfadeGains.resize(CROSSFADE_LENGTH + 1);
+            for (int i = 0; i <= CROSSFADE_LENGTH; ++i)
+                crossfadeGains[static_cast<size_t>(i)] = static_cast<float>(std::sin(0.5 * 3.14159265358979 * i / CROSSFADE_LENGTH));
+        }
+
+        RenderKernels::Source makeSource(int numChannels) const
+        {
+            RenderKernels::Source source;
+            source.numChannels = numChannels;
+            source.numFrames = SOURCE_FRAMES;
+            source.channels[0] = sourceData[0].data();
+            source.channels[1] = sourceData[numChannels > 1 ? 1 : 0].data();
+
+            // The restart crossfade fades out of the same source
+            source.fadeOutChannels[0] = source.channels[0];
+            source.fadeOutChannels[1] = source.channels[1];
+            source.fadeOutNumFrames = SOURCE_FRAMES;
+            return source;
+        }
+
+        // Same source, blended halfway with the channels swapped
+        RenderKernels::Source makeMorphSource(int numChannels) const
+        {
+            auto source = makeSource(numChannels);
+            source.morphChannels[0] = sourceData[1].data();
+            source.morphChannels[1] = sourceData[0].data();
+            source.morphAmount = 0.5f;
+            return source;
+        }
+
+        RenderKernels::VoiceState makeState() const
+        {
+            RenderKernels::VoiceState state;
+            state.phase = FixedPointPhase::fromDouble(17.25);
+            state.phaseIncrement = FixedPointPhase::fromDouble(1.0594630943592953);
+            state.oldPhase = FixedPointPhase::fromDouble(40000.5);
+            state.oldPhaseIncrement = FixedPointPhase::fromDouble(0.8908987181403393);
+            state.ratio = 1.0594630943592953;
+            state.ratioIncrement = 1.0000001;
+            return state;
+        }
+
+        std::vector<float> sourceData[2];
+        std::vector<float> crossfadeGains;
+    };
+
+    const KernelFixture& getFixture()
+    {
+        static KernelFixture fixture;
+        return fixture;
+    }
+
+    void runKernelBenchmark(Bench::State& state, const KernelDispatch::KernelTable* kernels)
+    {
+        const auto& fixture = getFixture();
+        const int sourceChannels = static_cast<int>(state.range(0));
+        const int outputChannels = static_cast<int>(state.range(1));
+        const bool crossfade = state.range(2) != 0;
+        const bool gliding = state.range(3) != 0;
+        const bool morph = state.range(4) != 0;
+        const int blockSize = static_cast<int>(state.range(5));
+
+        auto source = morph ? fixture.makeMorphSource(sourceChannels) : fixture.makeSource(sourceChannels);
+        const RenderKernels::CrossfadeTable crossfadeTable { fixture.crossfadeGains.data(), CROSSFADE_LENGTH };
+
+        std::vector<float> outputData[2] = { std::vector<float>(static_cast<size_t>(blockSize)),
+                                             std::vector<float>(static_cast<size_t>(blockSize)) };
+        float* outputs[2] = { outputData[0].data(), outputData[1].data() };
+        std::vector<float> frameGains(static_cast<size_t>(blockSize), 0.5f);
+
+        // No table means the generic path (the baseline build's)
+        auto kernel = kernels != nullptr ? kernels->getVoiceKernel(sourceChannels, outputChannels, crossfade, gliding, morph) : nullptr;
+        const auto renderGeneric = KernelDispatch::getBaselineKernels().renderVoiceGeneric;
+        auto voiceState = fixture.makeState();
+
+        while (state.keepRunning())
+        {
+            // Rewind well before the end of the source and keep the crossfade in range
+            if (FixedPointPhase::getIndex(voiceState.phase) > SOURCE_FRAMES / 2)
+                voiceState = fixture.makeState();
+            voiceState.crossfadeCount = 0;
+
+            if (kernel == nullptr)
+                renderGeneric(source, outputs, outputChannels, blockSize, frameGains.data(),
+                              voiceState, crossfade, gliding, crossfadeTable);
+            else
+                kernel(source, outputs, blockSize, frameGains.data(), voiceState, crossfadeTable);
+
+            Bench::doNotOptimise(outputData[0][0]);
+        }
+
+        state.setItemsProcessed(state.iterations() * blockSize);
+    }
+
+    void runEnvelopeGainBenchmark(Bench::State& state, const KernelDispatch::KernelTable& kernels)
+    {
+        const int blockSize = static_cast<int>(state.range(0));
+        std::vector<float> envelope(static_cast<size_t>(blockSize), 0.75f);
+        std::vector<float> gains(static_cast<size_t>(blockSize));
+
+        while (state.keepRunning())
+        {
+            kernels.applyEnvelopeGain(gains.data(), envelope.data(), 0.5f, blockSize);
+            Bench::doNotOptimise(gains[0]);
+        }
+
+        state.setItemsProcessed(state.iterations() * blockSize);
+    }
+
+    void runResampleBenchmark(Bench::State& state, const KernelDispatch::KernelTable& kernels)
+    {
+        // 44.1 kHz source imported at 48 kHz
+        const auto& fixture = getFixture();
+        const double sourceStep = 44100.0 / 48000.0;
+        const int destinationLength = static_cast<int>(SOURCE_FRAMES / sourceStep);
+        std::vector<float> destination(static_cast<size_t>(destinationLength));
+
+        while (state.keepRunning())
+        {
+            kernels.resampleLinear(fixture.sourceData[0].data(), static_cast<int>(SOURCE_FRAMES),
+                                   destination.data(), destinationLength, sourceStep);
+            Bench::doNotOptimise(destination[0]);
+        }
+
+        state.setItemsProcessed(state.iterations() * destinationLength);
+    }
+
+    void runAnalysisBenchmark(Bench::State& state, const KernelDispatch::KernelTable& kernels)
+    {
+        // One pass of each conditioning reduction over a stereo source
+        const auto& fixture = getFixture();
+        const int numFrames = static_cast<int>(SOURCE_FRAMES);
+
+        while (state.keepRunning())
+        {
+            double sum = 0.0;
+            double sumOfSquares = 0.0;
+            kernels.findSums(fixture.sourceData[0].data(), numFrames, &sum, &sumOfSquares);
+            Bench::doNotOptimise(sumOfSquares);
+            Bench::doNotOptimise(kernels.findPeak(fixture.sourceData[0].data(), numFrames));
+            Bench::doNotOptimise(kernels.findDifferencePeak(fixture.sourceData[0].data(), fixture.sourceData[1].data(), numFrames));
+        }
+
+        state.setItemsProcessed(state.iterations() * numFrames);
+    }
+
+    Bench::Benchmark* addKernelArguments(Bench::Benchmark* benchmark)
+    {
+        benchmark->argNames({ "src", "out", "xfade", "glide", "morph", "block" });
+        for (int sourceChannels = 1; sourceChannels <= 2; ++sourceChannels)
+            for (int outputChannels = 1; outputChannels <= 2; ++outputChannels)
+                for (int crossfade = 0; crossfade <= 1; ++crossfade)
+                    for (int gliding = 0; gliding <= 1; ++gliding)
+                        for (int morph = 0; morph <= 1; ++morph)
+                            for (int blockSize : { 64, 512 })
+                                benchmark->args({ sourceChannels, outputChannels, crossfade, gliding, morph, blockSize });
+        return benchmark;
+    }
+
+    bool registerKernelBenchmarks()
+    {
+        using KernelDispatch::InstructionSet;
+
+        addKernelArguments(Bench::registerBenchmark("RenderKernel/generic",
+                                                    [] (Bench::State& state) { runKernelBenchmark(state, nullptr); }));
+
+        // Only the instruction sets this CPU can run
+        for (auto instructionSet : { InstructionSet::Generic, InstructionSet::SSE2, InstructionSet::NEON,
+                                     InstructionSet::AVX2, InstructionSet::AVX512 })
+        {
+            if (!KernelDispatch::isAvailable(instructionSet))
+                continue;
+
+            const auto* kernels = &KernelDispatch::selectKernels(instructionSet);
+            const std::string name = KernelDispatch::getName(instructionSet);
+
+            addKernelArguments(Bench::registerBenchmark("RenderKernel/" + name,
+                                                        [kernels] (Bench::State& state) { runKernelBenchmark(state, kernels); }));
+
+            Bench::registerBenchmark("EnvelopeGain/" + name,
+                                     [kernels] (Bench::State& state) { runEnvelopeGainBenchmark(state, *kernels); })
+                ->argNames({ "block" })
+                ->args({ 64 })
+                ->args({ 512 });
+
+            Bench::registerBenchmark("Resample/" + name,
+                                     [kernels] (Bench::State& state) { runResampleBenchmark(state, *kernels); });
+
+            Bench::registerBenchmark("Analysis/" + name,
+                                     [kernels] (Bench::State& state) { runAnalysisBenchmark(state, *kernels); });
+        }
+
+        return true;
+    }
+}
+
+static const bool kernelBenchmarksRegistered = registerKernelBenchmarks();
@@ -0,0 +1,135 @@
+#include "ResourceUsage.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <string>
+
+#if defined (__unix__) || defined (__APPLE__)
+ #include <sys/resource.h>
+#endif
+
+namespace
+{
+    std::atomic<std::int64_t> allocationCount { 0 };
+    std::atomic<std::int64_t> allocationBytes { 0 };
+
+    inline void countAllocation(size_t size) noexcept
+    {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocationBytes.fetch_add(static_cast<std::int64_t>(size), std::memory_order_relaxed);
+    }
+}
+
+namespace ResourceUsage
+{
+    Allocations getAllocations() noexcept
+    {
+        return { allocationCount.load(std::memory_order_relaxed), allocationBytes.load(std::memory_order_relaxed) };
+    }
+
+    bool resetPeakResidentBytes()
+    {
+#if defined (__linux__)
+        // "5" resets VmHWM to the current resident size (Linux 4.0+)
+        std::ofstream clearRefs("/proc/self/clear_refs");
+        clearRefs << "5";
+        clearRefs.flush();
+        return clearRefs.good();
+#else
+        return false;
+#endif
+    }
+
+    std::int64_t getPeakResidentBytes()
+    {
+#if defined (__linux__)
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line))
+            if (line.compare(0, 6, "VmHWM:") == 0)
+                return std::strtoll(line.c_str() + 6, nullptr, 10) * 1024;
+        return 0;
+#elif defined (__APPLE__)
+        rusage usage {};
+        return getrusage(RUSAGE_SELF, &usage) == 0 ? static_cast<std::int64_t>(usage.ru_maxrss) : 0;
+#else
+        return 0;
+#endif
+    }
+}
+
+#if defined (__linux__) && defined (__GLIBC__)
+
+// glibc's allocator entry points; the interposed versions count, then forward
+extern "C"
+{
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* pointer, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+
+    void* malloc(size_t size) noexcept
+    {
+        countAllocation(size);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) noexcept
+    {
+        countAllocation(count * size);
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size) noexcept
+    {
+        countAllocation(size);
+        return __libc_realloc(pointer, size);
+    }
+
+    void* memalign(size_t alignment, size_t size) noexcept
+    {
+        countAllocation(size);
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size) noexcept
+    {
+        countAllocation(size);
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** result, size_t alignment, size_t size) noexcept
+    {
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0 || alignment % sizeof(void*) != 0)
+            return EINVAL;
+
+        countAllocation(size);
+        void* pointer = __libc_memalign(alignment, size);
+        if (pointer == nullptr)
+            return ENOMEM;
+
+        *result = pointer;
+        return 0;
+    }
+}
+
+#else
+
+// The default array, nothrow and sized forms all route through these two
+void* operator new(std::size_t size)
+{
+    countAllocation(size);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+#endif
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+// Process memory figures for the import and state benchmarks.
+//
+// Allocation counts come from ResourceUsage.cpp: on Linux / glibc it interposes
+// the malloc family, which also covers operator new and juce::HeapBlock; elsewhere
+// it replaces the global operator new / delete, so raw malloc calls (HeapBlock,
+// AudioBuffer storage) are not counted there.
+namespace ResourceUsage
+{
+    struct Allocations
+    {
+        std::int64_t count = 0;
+        std::int64_t bytes = 0;
+    };
+
+    // Allocations made by the whole process so far
+    Allocations getAllocations() noexcept;
+
+    // Restart peak resident set tracking from the current size. Only Linux supports
+    // this; elsewhere the peak covers the whole process lifetime and this returns false.
+    bool resetPeakResidentBytes();
+
+    // Peak resident set size in bytes, or 0 where it can't be read
+    std::int64_t getPeakResidentBytes();
+}
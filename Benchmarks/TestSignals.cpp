@@ -0,0 +1,157 @@
+#include "TestSignals.h"
+
+#include <cmath>
+
+namespace
+{
+    struct TemporaryDirectory
+    {
+        TemporaryDirectory()
+            : directory(juce::File::getSpecialLocation(juce::File::tempDirectory)
+                            .getNonexistentChildFile("EskilatorBenchmarks", {}, false))
+        {
+            directory.createDirectory();
+        }
+
+        ~TemporaryDirectory()
+        {
+            directory.deleteRecursively();
+        }
+
+        juce::File directory;
+    };
+
+    std::unique_ptr<juce::AudioFormat> createFormat(TestSignals::FileFormat format)
+    {
+        switch (format)
+        {
+            case TestSignals::FileFormat::Aiff24:
+                return std::make_unique<juce::AiffAudioFormat>();
+#if JUCE_USE_FLAC
+            case TestSignals::FileFormat::Flac24:
+                return std::make_unique<juce::FlacAudioFormat>();
+#endif
+#if JUCE_USE_OGGVORBIS
+            case TestSignals::FileFormat::OggVorbis:
+                return std::make_unique<juce::OggVorbisAudioFormat>();
+#endif
+            case TestSignals::FileFormat::Wav16:
+            case TestSignals::FileFormat::Wav24:
+            case TestSignals::FileFormat::WavFloat:
+                return std::make_unique<juce::WavAudioFormat>();
+            default:
+                return nullptr;
+        }
+    }
+}
+
+namespace TestSignals
+{
+    const char* getFormatName(FileFormat format)
+    {
+        switch (format)
+        {
+            case FileFormat::Wav16:     return "WAV 16-bit";
+            case FileFormat::Wav24:     return "WAV 24-bit";
+            case FileFormat::WavFloat:  return "WAV float";
+            case FileFormat::Aiff24:    return "AIFF 24-bit";
+            case FileFormat::Flac24:    return "FLAC 24-bit";
+            case FileFormat::OggVorbis: return "OGG Vorbis";
+            default:                    return "Unknown";
+        }
+    }
+
+    int getBitsPerSample(FileFormat format)
+    {
+        switch (format)
+        {
+            case FileFormat::Wav16:
+            case FileFormat::OggVorbis:
+                return 16;
+            case FileFormat::WavFloat:
+                return 32;
+            default:
+                return 24;
+        }
+    }
+
+    juce::File getDirectory()
+    {
+        static TemporaryDirectory temporaryDirectory;
+        return temporaryDirectory.directory;
+    }
+
+    void fillTone(juce::AudioBuffer<float>& buffer, juce::int64 startFrame, double sampleRate, int variant)
+    {
+        constexpr double twoPi = juce::MathConstants<double>::twoPi;
+        const double fundamental = 220.0 * std::pow(2.0, variant / 48.0);
+        juce::Random random(startFrame * 131 + variant);
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            auto* data = buffer.getWritePointer(channel);
+            const double detune = 1.0 + 0.002 * channel;
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                const double time = static_cast<double>(startFrame + i) / sampleRate;
+                const double phase = twoPi * fundamental * detune * time;
+                const double wobble = 0.75 + 0.25 * std::sin(twoPi * 0.5 * time);
+                const double tone = 0.5 * std::sin(phase) + 0.25 * std::sin(2.0 * phase) + 0.125 * std::sin(3.0 * phase);
+                data[i] = static_cast<float>(wobble * tone) + 0.01f * (random.nextFloat() - 0.5f);
+            }
+        }
+    }
+
+    juce::File getToneFile(double sampleRate, int numChannels, double seconds, FileFormat format, int variant)
+    {
+        auto audioFormat = createFormat(format);
+        if (audioFormat == nullptr)
+            return {};
+
+        const auto file = getDirectory().getChildFile("tone_" + juce::String(juce::roundToInt(sampleRate)) + "_"
+                                                      + juce::String(numChannels) + "ch_"
+                                                      + juce::String(seconds, 3) + "s_"
+                                                      + juce::String(static_cast<int>(format)) + "_"
+                                                      + juce::String(variant)
+                                                      + audioFormat->getFileExtensions()[0]);
+        if (file.existsAsFile())
+            return file;
+
+        // Vorbis takes a quality option instead of a bit depth
+        const auto qualityOptions = audioFormat->getQualityOptions();
+        const int qualityIndex = qualityOptions.isEmpty() ? 0 : qualityOptions.size() / 2;
+
+        // The writer owns the stream once created; on failure the stream is still ours
+        auto stream = std::make_unique<juce::FileOutputStream>(file);
+        std::unique_ptr<juce::AudioFormatWriter> writer(
+            audioFormat->createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(numChannels),
+                                         getBitsPerSample(format), {}, qualityIndex));
+        if (writer == nullptr)
+        {
+            stream.reset();
+            file.deleteFile();
+            return {};
+        }
+        stream.release();
+
+        const auto totalFrames = static_cast<juce::int64>(seconds * sampleRate);
+        juce::AudioBuffer<float> chunk(numChannels, CHUNK_FRAMES);
+
+        for (juce::int64 frame = 0; frame < totalFrames; frame += CHUNK_FRAMES)
+        {
+            const int numFrames = static_cast<int>(juce::jmin<juce::int64>(CHUNK_FRAMES, totalFrames - frame));
+            chunk.setSize(numChannels, numFrames, false, false, true);
+            fillTone(chunk, frame, sampleRate, variant);
+
+            if (!writer->writeFromAudioSampleBuffer(chunk, 0, numFrames))
+            {
+                writer.reset();
+                file.deleteFile();
+                return {};
+            }
+        }
+
+        return file;
+    }
+}
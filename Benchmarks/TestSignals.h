@@ -0,0 +1,40 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Deterministic test material for the benchmarks. Files are generated on first use
+// in a per-run temporary directory, reused for the rest of the run and deleted at
+// exit, so nothing is read from or committed to the repository.
+namespace TestSignals
+{
+    // Frames generated per write, so long files never need a full-length buffer
+    static constexpr int CHUNK_FRAMES = 1 << 16;
+
+    enum class FileFormat
+    {
+        Wav16 = 0,
+        Wav24,
+        WavFloat,
+        Aiff24,
+        Flac24,
+        OggVorbis
+    };
+
+    static constexpr int NUM_FILE_FORMATS = 6;
+
+    const char* getFormatName(FileFormat format);
+
+    // Bits per sample written for the format (OGG files decode from 16-bit input)
+    int getBitsPerSample(FileFormat format);
+
+    juce::File getDirectory();
+
+    // Harmonic tone with a slow amplitude wobble and low-level seeded noise;
+    // startFrame keeps consecutive chunks continuous, variant changes the pitch and noise
+    void fillTone(juce::AudioBuffer<float>& buffer, juce::int64 startFrame, double sampleRate, int variant = 0);
+
+    // File of the tone at the given rate, channel count and length; returns an
+    // invalid File if the format isn't compiled into JUCE or writing fails
+    juce::File getToneFile(double sampleRate, int numChannels, double seconds,
+                           FileFormat format = FileFormat::Wav24, int variant = 0);
+}
@@ -0,0 +1,58 @@
+#include "CpuGovernor.h"
+
+#include <cmath>
+
+void CpuGovernor::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    smoothedLoad = 0.0;
+    secondsSinceTierChange = 0.0;
+    secondsWithHeadroom = 0.0;
+    tier.store(0, std::memory_order_relaxed);
+    load.store(0.0f, std::memory_order_relaxed);
+}
+
+void CpuGovernor::addBlock(double elapsedSeconds, int numSamples)
+{
+    if (numSamples <= 0 || sampleRate <= 0.0)
+        return;
+
+    const double blockSeconds = static_cast<double>(numSamples) / sampleRate;
+    const double blockLoad = elapsedSeconds / blockSeconds;
+
+    // Exponential moving average over audio time, so the response does not depend on the block size
+    smoothedLoad += (1.0 - std::exp(-blockSeconds / SMOOTHING_SECONDS)) * (blockLoad - smoothedLoad);
+    load.store(static_cast<float>(smoothedLoad), std::memory_order_relaxed);
+
+    secondsSinceTierChange += blockSeconds;
+    secondsWithHeadroom = smoothedLoad < RECOVER_LOAD ? secondsWithHeadroom + blockSeconds : 0.0;
+
+    // A single block past its deadline is an xrun already, so it counts as overloaded on its own
+    const int currentTier = tier.load(std::memory_order_relaxed);
+    const bool overloaded = smoothedLoad > DEGRADE_LOAD || blockLoad >= 1.0;
+
+    if (overloaded && currentTier < NUM_TIERS - 1 && secondsSinceTierChange >= DEGRADE_HOLD_SECONDS)
+        setTier(currentTier + 1);
+    else if (!overloaded && currentTier > 0 && secondsWithHeadroom >= RECOVER_HOLD_SECONDS)
+        setTier(currentTier - 1);
+}
+
+void CpuGovernor::setTier(int newTier)
+{
+    tier.store(newTier, std::memory_order_relaxed);
+    secondsSinceTierChange = 0.0;
+    secondsWithHeadroom = 0.0;
+}
+
+const char* CpuGovernor::getTierName(QualityTier qualityTier)
+{
+    switch (qualityTier)
+    {
+        case QualityTier::Full:                 return "Full";
+        case QualityTier::LinearInterpolation:  return "Linear";
+        case QualityTier::ShortCrossfades:      return "Short Fades";
+        case QualityTier::ReducedOversampling:  return "2x Max";
+        case QualityTier::NoOversampling:       return "No OS";
+        default:                                return "Unknown";
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+
+// CPU budget governor. processBlock reports how long each block took against its
+// real-time deadline (block length / sample rate); the governor smooths that load
+// and steps the engine quality down when it nears the deadline, and back up once
+// there is headroom again. Tiers are cumulative - each keeps the reductions of
+// the tiers before it.
+//
+// addBlock() runs on the audio thread and never allocates or locks. getTier() and
+// getLoad() may be read from any thread (editor, telemetry).
+class CpuGovernor
+{
+public:
+    enum class QualityTier
+    {
+        Full = 0,
+        LinearInterpolation,    // Sinc interpolation falls back to linear
+        ShortCrossfades,        // Shorter note restart crossfades
+        ReducedOversampling,    // At most 2x
+        NoOversampling          // Render at the host rate
+    };
+    static constexpr int NUM_TIERS = 5;
+
+    static constexpr double DEGRADE_LOAD = 0.7;            // Smoothed load that steps quality down
+    static constexpr double RECOVER_LOAD = 0.35;           // Smoothed load that allows stepping back up
+    static constexpr double SMOOTHING_SECONDS = 0.1;       // Moving-average time constant (audio time)
+    static constexpr double DEGRADE_HOLD_SECONDS = 0.25;   // Let a step take effect before the next one
+    static constexpr double RECOVER_HOLD_SECONDS = 2.0;    // Headroom must last this long before stepping up
+
+    // Reset to full quality - prepareToPlay only
+    void prepare(double newSampleRate);
+
+    // Account one block (audio thread)
+    void addBlock(double elapsedSeconds, int numSamples);
+
+    QualityTier getTier() const { return static_cast<QualityTier>(tier.load(std::memory_order_relaxed)); }
+
+    // Smoothed block time as a fraction of the deadline (1.0 = the whole block period)
+    float getLoad() const { return load.load(std::memory_order_relaxed); }
+
+    static const char* getTierName(QualityTier qualityTier);
+
+private:
+    void setTier(int newTier);
+
+    double sampleRate = 44100.0;
+    double smoothedLoad = 0.0;
+    double secondsSinceTierChange = 0.0;
+    double secondsWithHeadroom = 0.0;
+
+    std::atomic<int> tier { 0 };
+    std::atomic<float> load { 0.0f };
+};
@@ -0,0 +1,90 @@
+#include "EngineConfig.h"
+
+#include <algorithm>
+#include <cmath>
+
+EngineConfig EngineConfig::live()
+{
+    return {};
+}
+
+EngineConfig EngineConfig::offline()
+{
+    EngineConfig config;
+    config.interpolation = Interpolation::Sinc;
+    config.useInterpolationParameter = false;
+    config.oversamplingIndex = ParameterRanges::OVERSAMPLING_MAX_INDEX;
+    config.restartCrossfadeMs = OFFLINE_CROSSFADE_MS;
+    config.limitVoices = false;
+    return config;
+}
+
+EngineConfig EngineConfig::forQualityTier(EngineConfig config, CpuGovernor::QualityTier tier)
+{
+    using Tier = CpuGovernor::QualityTier;
+
+    if (tier >= Tier::LinearInterpolation)
+    {
+        config.interpolation = Interpolation::Linear;
+        config.useInterpolationParameter = false;
+    }
+
+    if (tier >= Tier::ShortCrossfades)
+        config.restartCrossfadeMs = std::min(config.restartCrossfadeMs, SHORT_CROSSFADE_MS);
+
+    if (tier >= Tier::ReducedOversampling)
+        config.maxOversamplingIndex = std::min(config.maxOversamplingIndex, 1);
+
+    if (tier >= Tier::NoOversampling)
+        config.maxOversamplingIndex = 0;
+
+    return config;
+}
+
+void EngineConfig::prepare(FadeTables& fadeTables, double sampleRate)
+{
+    for (int index = 0; index <= ParameterRanges::OVERSAMPLING_MAX_INDEX; ++index)
+    {
+        restartCrossfades[static_cast<size_t>(index)]
+            = fadeTables.prepare(sampleRate * (1 << index), restartCrossfadeMs);
+    }
+}
+
+std::vector<float> makeSincTable()
+{
+    using namespace RenderKernels;
+
+    // Cutoff just below Nyquist; the offline engine also renders at 4x, which keeps
+    // pitched-up playback clear of the transition band
+    constexpr double cutoff = 0.9;
+    constexpr double radius = SINC_TAPS / 2;
+    constexpr double pi = 3.14159265358979323846;
+    constexpr int firstOffset = 1 - SINC_TAPS / 2;
+
+    std::vector<float> coefficients(static_cast<size_t>((SINC_PHASES + 1) * SINC_TAPS));
+    for (int row = 0; row <= SINC_PHASES; ++row)
+    {
+        const double fraction = static_cast<double>(row) / SINC_PHASES;
+        double taps[SINC_TAPS];
+        double sum = 0.0;
+
+        for (int tap = 0; tap < SINC_TAPS; ++tap)
+        {
+            const double x = (tap + firstOffset) - fraction;
+            const double sinc = x == 0.0 ? 1.0 : std::sin(pi * cutoff * x) / (pi * cutoff * x);
+
+            // Blackman-Harris window over [-radius, radius]
+            const double t = std::clamp((x + radius) / (2.0 * radius), 0.0, 1.0);
+            const double window = 0.35875 - 0.48829 * std::cos(2.0 * pi * t)
+                                + 0.14128 * std::cos(4.0 * pi * t) - 0.01168 * std::cos(6.0 * pi * t);
+
+            taps[tap] = sinc * window;
+            sum += taps[tap];
+        }
+
+        for (int tap = 0; tap < SINC_TAPS; ++tap)
+            coefficients[static_cast<size_t>(row * SINC_TAPS + tap)] = static_cast<float>(taps[tap] / sum);
+    }
+
+    return coefficients;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include "ParameterRanges.h"
+#include "CpuGovernor.h"
+#include "FadeTables.h"
+#include "RenderKernels.h"
+
+// Render engine quality settings. The processor prepares a live configuration
+// per CPU governor tier and an offline configuration in
+// prepareToPlay and switches between them by pointer (non-realtime rendering,
+// tier changes), so the switch never allocates on the audio thread. A sounding
+// voice keeps the restart crossfade of the configuration its note started with.
+struct EngineConfig
+{
+    using Interpolation = ParameterRanges::Interpolation;
+
+    static constexpr double LIVE_CROSSFADE_MS = 5.8;      // 256 samples at 44.1kHz
+    static constexpr double OFFLINE_CROSSFADE_MS = 20.0;
+    static constexpr double SHORT_CROSSFADE_MS = 1.5;     // CPU governor, ShortCrossfades tier and below
+
+    Interpolation interpolation = Interpolation::Linear;
+    bool useInterpolationParameter = true;                // false forces 'interpolation'
+    int oversamplingIndex = -1;                           // Fixed factor (2^index), -1 follows the parameter
+    int maxOversamplingIndex = ParameterRanges::OVERSAMPLING_MAX_INDEX;  // Caps the parameter
+    double restartCrossfadeMs = LIVE_CROSSFADE_MS;        // Note restart crossfade length
+    bool limitVoices = true;                              // false ignores the voice-count parameter
+
+    // Restart crossfade for each render rate (indexed by oversampling index), filled by prepare()
+    std::array<RenderKernels::CrossfadeTable, ParameterRanges::OVERSAMPLING_MAX_INDEX + 1> restartCrossfades {};
+
+    static EngineConfig live();
+    static EngineConfig offline();
+
+    // A configuration with the reductions of a CPU governor tier (and every tier before it) applied
+    static EngineConfig forQualityTier(EngineConfig config, CpuGovernor::QualityTier tier);
+
+    // Build the tables for every render rate - prepareToPlay only (allocates)
+    void prepare(FadeTables& fadeTables, double sampleRate);
+};
+
+// Polyphase windowed-sinc coefficients for RenderKernels::readSinc,
+// (SINC_PHASES + 1) rows of SINC_TAPS, each row normalised to unity DC gain
+std::vector<float> makeSincTable();
@@ -0,0 +1,27 @@
+#include "FadeTables.h"
+
+#include <cmath>
+
+RenderKernels::CrossfadeTable FadeTables::prepare(double sampleRate, double milliseconds)
+{
+    auto& gains = tables[Key { sampleRate, milliseconds }];
+    const int length = getLengthInSamples(sampleRate, milliseconds);
+
+    if (gains.empty())
+    {
+        gains.resize(static_cast<size_t>(length) + 1);
+        for (int i = 0; i <= length; ++i)
+        {
+            const double position = static_cast<double>(i) / static_cast<double>(length);
+            gains[static_cast<size_t>(i)] = static_cast<float>(std::sin(position * 1.5707963267948966));
+        }
+    }
+
+    return { gains.data(), length };
+}
+
+int FadeTables::getLengthInSamples(double sampleRate, double milliseconds)
+{
+    const long length = std::lround(milliseconds * 0.001 * sampleRate);
+    return length > 1 ? static_cast<int>(length) : 1;
+}
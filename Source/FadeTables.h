@@ -0,0 +1,30 @@
+#pragma once
+
+#include <map>
+#include <utility>
+#include <vector>
+#include "RenderKernels.h"
+
+// Cache of precomputed equal-power (sin / cos) fade curves keyed by sample rate and
+// fade length in milliseconds, so every fade lasts (and sounds) the same at any host
+// rate. Each table holds length + 1 gains rising from 0 to 1: a fade-in reads
+// gains[n] and the matching fade-out reads gains[length - n].
+//
+// prepare() allocates and must only be called while audio is stopped
+// (prepareToPlay). Tables are kept when the host switches sample rates, and the
+// returned pointers stay valid until clear() or destruction.
+class FadeTables
+{
+public:
+    // Build the table if needed and return it
+    RenderKernels::CrossfadeTable prepare(double sampleRate, double milliseconds);
+
+    // Fade length in samples for a sample rate (at least one sample)
+    static int getLengthInSamples(double sampleRate, double milliseconds);
+
+    void clear() { tables.clear(); }
+
+private:
+    using Key = std::pair<double, double>;
+    std::map<Key, std::vector<float>> tables;
+};
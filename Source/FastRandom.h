@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+// Small seedable generator (xorshift64*, seeded through SplitMix64) for sample
+// selection on the audio thread. One multiply and three shifts per number, no
+// allocation, and the same seed always gives the same sequence, so offline renders
+// with randomised sample selection are reproducible.
+class FastRandom
+{
+public:
+    static constexpr std::uint64_t DEFAULT_SEED = 0x45534b494c41544fULL; // "ESKILATO"
+
+    explicit FastRandom(std::uint64_t seed = DEFAULT_SEED) { setSeed(seed); }
+
+    void setSeed(std::uint64_t seed)
+    {
+        // SplitMix64 spreads similar seeds apart and never leaves the state at zero
+        std::uint64_t z = seed + 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        state = (z ^ (z >> 31)) | 1;
+    }
+
+    std::uint32_t nextUint32()
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return static_cast<std::uint32_t>((state * 0x2545f4914f6cdd1dULL) >> 32);
+    }
+
+    // Uniform in [0, 1)
+    float nextFloat() { return static_cast<float>(nextUint32() >> 8) * (1.0f / 16777216.0f); }
+
+    // Uniform in [0, maxExclusive), for maxExclusive > 0
+    int nextInt(int maxExclusive)
+    {
+        return static_cast<int>((static_cast<std::uint64_t>(nextUint32()) * static_cast<std::uint32_t>(maxExclusive)) >> 32);
+    }
+
+private:
+    std::uint64_t state = 1;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+
+// Kernel translation units built for a specific instruction set (see KernelDispatch.h)
+// define ESKILATOR_KERNEL_ISA before including this header, which gives the inline
+// functions below distinct symbols per instruction set
+#ifndef ESKILATOR_KERNEL_ISA
+ #define ESKILATOR_KERNEL_ISA Baseline
+#endif
+
+// 32.32 fixed-point playback position for sample voices.
+// The upper 32 bits hold the integer sample index and the lower 32 bits the
+// fractional position between samples, so positions stay exact for samples of
+// up to 2^32 frames and the hot loop splits them with a shift and a mask.
+namespace FixedPointPhase
+{
+    using Phase = std::uint64_t;
+
+    static constexpr int FRACTION_BITS = 32;
+    static constexpr Phase ONE = Phase(1) << FRACTION_BITS;
+    static constexpr Phase FRACTION_MASK = ONE - 1;
+    static constexpr double SCALE = 4294967296.0;           // 2^32
+    static constexpr float FRACTION_SCALE = 1.0f / 4294967296.0f;
+
+inline namespace ESKILATOR_KERNEL_ISA
+{
+
+    // Convert a (non-negative) sample position or playback ratio to fixed point
+    inline Phase fromDouble(double position)
+    {
+        return position > 0.0 ? static_cast<Phase>(position * SCALE + 0.5) : 0;
+    }
+
+    inline double toDouble(Phase phase)
+    {
+        return static_cast<double>(phase) * (1.0 / SCALE);
+    }
+
+    // Integer sample index
+    inline std::uint32_t getIndex(Phase phase)
+    {
+        return static_cast<std::uint32_t>(phase >> FRACTION_BITS);
+    }
+
+    // Interpolation weight in [0, 1)
+    inline float getFraction(Phase phase)
+    {
+        return static_cast<float>(static_cast<std::uint32_t>(phase & FRACTION_MASK)) * FRACTION_SCALE;
+    }
+
+    // Loop wrap: a position at or past limit moves back by whole multiples of length
+    inline Phase wrap(Phase phase, std::uint32_t limit, std::uint32_t length)
+    {
+        const Phase limitPhase = static_cast<Phase>(limit) << FRACTION_BITS;
+        if (phase < limitPhase || length == 0)
+            return phase;
+
+        const Phase lengthPhase = static_cast<Phase>(length) << FRACTION_BITS;
+        return limitPhase - lengthPhase + (phase - limitPhase) % lengthPhase;
+    }
+} // inline namespace ESKILATOR_KERNEL_ISA
+}
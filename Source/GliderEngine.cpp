@@ -0,0 +1,1403 @@
+#include "GliderEngine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+GliderEngine::GliderEngine()
+{
+    // The double-precision path renders the voice at unity gain
+    kernelUnityGains.fill(1.0f);
+}
+
+void GliderEngine::prepare(double sampleRate, int samplesPerBlock, int numChannels, bool doublePrecision)
+{
+    // Store sample rate for calculations
+    currentSampleRate = sampleRate;
+    maxBlockSize = samplesPerBlock;
+    
+    // Reset all voices and initialize ADSR
+    for (auto& voice : sampleVoices)
+    {
+        voice.isActive = false;
+        voice.isGliding = false;
+        voice.samplePosition = 0;
+        voice.phase = 0;
+        voice.glideCurrentStep = 0;
+        voice.glideTotalSteps = 0;
+        voice.glideSamplesPerStep = 0;
+        voice.glideSampleCounter = 0;
+
+        // Initialize ADSR envelope
+        voice.adsr.setSampleRate(sampleRate);
+        voice.adsr.setParameters(getAdsrParameters());
+    }
+
+    // Live (per governor tier) and offline configurations: crossfade tables for every render
+    // rate (the restart crossfade lasts the same time at any rate) and the shared sinc table
+    for (int tier = 0; tier < CpuGovernor::NUM_TIERS; ++tier)
+    {
+        auto& config = liveConfigs[static_cast<size_t>(tier)];
+        config = EngineConfig::forQualityTier(EngineConfig::live(), static_cast<CpuGovernor::QualityTier>(tier));
+        config.prepare(fadeTables, sampleRate);
+    }
+    offlineConfig.prepare(fadeTables, sampleRate);
+    cpuGovernor.prepare(sampleRate);
+    if (sincCoefficients.empty())
+        sincCoefficients = makeSincTable();
+
+    // Oversamplers for every factor and filter type, at the precision the host will process in
+    numOversampledChannels = juce::jmin(numChannels, RenderKernels::MAX_CHANNELS);
+    for (int filter = 0; filter < NUM_OVERSAMPLING_FILTERS; ++filter)
+    {
+        for (int index = 1; index <= ParameterRanges::OVERSAMPLING_MAX_INDEX; ++index)
+        {
+            const bool isFir = static_cast<ParameterRanges::OversamplingFilter>(filter) == ParameterRanges::OversamplingFilter::FIR;
+            auto& floatOversampler = floatOversamplers[static_cast<size_t>(filter)][static_cast<size_t>(index)];
+            auto& doubleOversampler = doubleOversamplers[static_cast<size_t>(filter)][static_cast<size_t>(index)];
+            floatOversampler.reset();
+            doubleOversampler.reset();
+
+            if (doublePrecision)
+            {
+                doubleOversampler = std::make_unique<juce::dsp::Oversampling<double>>(
+                    static_cast<size_t>(numOversampledChannels), static_cast<size_t>(index),
+                    isFir ? juce::dsp::Oversampling<double>::filterHalfBandFIREquiripple
+                          : juce::dsp::Oversampling<double>::filterHalfBandPolyphaseIIR,
+                    true);
+                doubleOversampler->initProcessing(static_cast<size_t>(samplesPerBlock));
+            }
+            else
+            {
+                floatOversampler = std::make_unique<juce::dsp::Oversampling<float>>(
+                    static_cast<size_t>(numOversampledChannels), static_cast<size_t>(index),
+                    isFir ? juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple
+                          : juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR,
+                    true);
+                floatOversampler->initProcessing(static_cast<size_t>(samplesPerBlock));
+            }
+        }
+    }
+
+    // Output delay that pads lower factors to the highest factor's filter latency (both
+    // precisions, so the pad can be set whichever one is processing)
+    const juce::dsp::ProcessSpec padSpec { sampleRate, static_cast<juce::uint32>(samplesPerBlock),
+                                           static_cast<juce::uint32>(juce::jmax(1, numOversampledChannels)) };
+    int maxPadSamples = 0;
+    for (int filter = 0; filter < NUM_OVERSAMPLING_FILTERS; ++filter)
+        maxPadSamples = juce::jmax(maxPadSamples, static_cast<int>(std::ceil(getOversamplerLatency(filter, ParameterRanges::OVERSAMPLING_MAX_INDEX))));
+    floatLatencyPad.prepare(padSpec);
+    floatLatencyPad.setMaximumDelayInSamples(maxPadSamples);
+    doubleLatencyPad.prepare(padSpec);
+    doubleLatencyPad.setMaximumDelayInSamples(maxPadSamples);
+    latencyPadSamples = 0;
+
+    // Apply the current configuration and factor (render rate, voice timing, reported latency)
+    engineConfig = &liveConfigs[0];
+    oversamplingIndex = -1;
+    updateEngineConfig();
+
+    numHeldNotes = 0;
+
+    // Pick the render/import kernels for this CPU
+    kernels = &KernelDispatch::selectKernels(instructionSetOverride);
+    sampleManager.setKernels(*kernels);
+
+    // Every prepare starts the same selection sequence
+    sampleManager.setRandomSeed(randomSeed);
+
+    // Room for the events queued between render() calls
+    pendingMidi.ensureSize(MIDI_QUEUE_BYTES);
+    chunkMidi.ensureSize(MIDI_QUEUE_BYTES);
+}
+
+void GliderEngine::setParameters(const Parameters& newParameters)
+{
+    const bool envelopeChanged = newParameters.attack != parameters.attack || newParameters.decay != parameters.decay
+                                 || newParameters.sustain != parameters.sustain || newParameters.release != parameters.release;
+    parameters = newParameters;
+    sampleManager.setChainPosition(parameters.sampleChain);
+    smoothedChainPosition.setTargetValue(parameters.sampleChain);
+
+    // Update ADSR for voice 0 (monophonic)
+    if (envelopeChanged)
+        sampleVoices[0].adsr.setParameters(getAdsrParameters());
+}
+
+juce::ADSR::Parameters GliderEngine::getAdsrParameters() const
+{
+    juce::ADSR::Parameters adsrParams;
+    adsrParams.attack = parameters.attack;
+    adsrParams.decay = parameters.decay;
+    adsrParams.sustain = parameters.sustain;
+    adsrParams.release = parameters.release;
+    return adsrParams;
+}
+
+void GliderEngine::addMidiEvent(const juce::MidiMessage& message, int frameOffset)
+{
+    pendingMidi.addEvent(message, juce::jmax(0, frameOffset));
+}
+
+void GliderEngine::render(float* const* outputs, int numChannels, int numFrames)
+{
+    renderQueued(outputs, numChannels, numFrames);
+}
+
+void GliderEngine::render(double* const* outputs, int numChannels, int numFrames)
+{
+    renderQueued(outputs, numChannels, numFrames);
+}
+
+void GliderEngine::process(juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midi)
+{
+    processBlockInternal(buffer, midi);
+}
+
+void GliderEngine::process(juce::AudioBuffer<double>& buffer, const juce::MidiBuffer& midi)
+{
+    processBlockInternal(buffer, midi);
+}
+
+// Split a render() call into blocks of at most maxBlockSize, each with its slice of the queued events
+template <typename SampleType>
+void GliderEngine::renderQueued(SampleType* const* outputs, int numChannels, int numFrames)
+{
+    jassert(maxBlockSize > 0); // prepare() first
+
+    SampleType* channels[RenderKernels::MAX_CHANNELS] = { nullptr, nullptr };
+    const int numRenderedChannels = juce::jmin(numChannels, RenderKernels::MAX_CHANNELS);
+
+    for (int start = 0; start < numFrames && maxBlockSize > 0; start += maxBlockSize)
+    {
+        const int length = juce::jmin(maxBlockSize, numFrames - start);
+        chunkMidi.clear();
+        chunkMidi.addEvents(pendingMidi, start, length, -start);
+
+        for (int channel = 0; channel < numRenderedChannels; ++channel)
+            channels[channel] = outputs[channel] + start;
+
+        // Refers to the caller's memory, no allocation
+        juce::AudioBuffer<SampleType> block(channels, numRenderedChannels, length);
+        block.clear();
+        processBlockInternal(block, chunkMidi);
+
+        for (int channel = numRenderedChannels; channel < numChannels; ++channel)
+            std::fill(outputs[channel] + start, outputs[channel] + start + length, SampleType(0));
+    }
+
+    pendingMidi.clear();
+}
+
+void GliderEngine::updateEngineConfig()
+{
+    // Bounces get the offline configuration (sinc, highest factor, longer crossfades, no voice limit),
+    // live playback the configuration for the governor's current tier (Full when pinned)
+    const auto tier = fullQualityPinned ? CpuGovernor::QualityTier::Full : cpuGovernor.getTier();
+    const EngineConfig* requestedConfig = isNonRealtime() ? &offlineConfig
+                                                          : &liveConfigs[static_cast<size_t>(tier)];
+    const int requestedIndex = juce::jmin(requestedConfig->oversamplingIndex >= 0 ? requestedConfig->oversamplingIndex
+                                                                                  : parameters.oversamplingIndex,
+                                          requestedConfig->maxOversamplingIndex);
+    const int requestedFilter = static_cast<int>(parameters.oversamplingFilter);
+
+    const auto interpolation = requestedConfig->useInterpolationParameter ? parameters.interpolation
+                                                                          : requestedConfig->interpolation;
+    useSincInterpolation = interpolation == EngineConfig::Interpolation::Sinc && !sincCoefficients.empty();
+
+    // Notes already sounding keep their restart crossfade; the new one applies from the next trigger
+    engineConfig = requestedConfig;
+
+    // Factor changes (parameter, bounce, governor step) carry the sounding voice to the new rate
+    if (requestedIndex == oversamplingIndex && requestedFilter == oversamplingFilterIndex)
+        return;
+
+    oversamplingFilterIndex = requestedFilter;
+    setRenderRate(requestedIndex);
+}
+
+RenderKernels::CrossfadeTable GliderEngine::getRestartCrossfade(const SampleVoice& voice) const
+{
+    const auto* config = voice.restartConfig != nullptr ? voice.restartConfig : engineConfig;
+    return config->restartCrossfades[static_cast<size_t>(juce::jmax(0, oversamplingIndex))];
+}
+
+int GliderEngine::getEffectiveVoiceCount() const
+{
+    return engineConfig->limitVoices ? parameters.voiceCount : MAX_VOICES;
+}
+
+void GliderEngine::setRenderRate(int newOversamplingIndex)
+{
+    const int previousIndex = oversamplingIndex;
+    oversamplingIndex = newOversamplingIndex;
+    renderSampleRate = currentSampleRate * (1 << oversamplingIndex);
+
+    // Voice timing is counted in render-rate samples. prepare() starts from silence; after
+    // that a sounding voice keeps playing, its increments and counters rescaled to the new rate.
+    // (juce::ADSR only recalculates its rates in setParameters.)
+    const double rateRatio = previousIndex >= 0 ? static_cast<double>(1 << oversamplingIndex) / static_cast<double>(1 << previousIndex) : 1.0;
+    for (auto& voice : sampleVoices)
+    {
+        voice.adsr.setSampleRate(renderSampleRate);
+        voice.adsr.setParameters(getAdsrParameters());
+
+        if (previousIndex < 0)
+        {
+            voice.isActive = false;
+            voice.isGliding = false;
+            voice.isInGlideCrossfade = false;
+            voice.fadeOutBank = nullptr;
+            voice.sampleBank = nullptr;
+            voice.cachedPitchRatio = 0.0f;
+            voice.ratioScale = 1.0 / static_cast<double>(1 << oversamplingIndex);
+            voice.adsr.reset();
+        }
+        else if (voice.isActive && rateRatio != 1.0)
+        {
+            rescaleVoiceTiming(voice, rateRatio);
+        }
+    }
+
+    // Report the highest factor's latency for the selected filter and delay this factor's
+    // output up to it. A pad starting from nothing must not replay stale output.
+    latencySamples = juce::roundToInt(getOversamplerLatency(oversamplingFilterIndex, ParameterRanges::OVERSAMPLING_MAX_INDEX));
+    const int padSamples = juce::jmax(0, latencySamples - juce::roundToInt(getOversamplerLatency(oversamplingFilterIndex, oversamplingIndex)));
+    if (padSamples != latencyPadSamples)
+    {
+        if (latencyPadSamples == 0)
+        {
+            floatLatencyPad.reset();
+            doubleLatencyPad.reset();
+        }
+
+        floatLatencyPad.setDelay(static_cast<float>(padSamples));
+        doubleLatencyPad.setDelay(static_cast<double>(padSamples));
+        latencyPadSamples = padSamples;
+    }
+
+    if (auto* oversampler = getActiveOversampler<float>())
+        oversampler->reset();
+    else if (auto* doubleOversampler = getActiveOversampler<double>())
+        doubleOversampler->reset();
+
+    // The chain position ramps in render-rate frames (this lands it on its target)
+    smoothedChainPosition.reset(renderSampleRate, CHAIN_SMOOTHING_SECONDS);
+}
+
+float GliderEngine::getOversamplerLatency(int filterIndex, int factorIndex) const
+{
+    if (factorIndex <= 0)
+        return 0.0f;
+
+    const auto filter = static_cast<size_t>(juce::jlimit(0, NUM_OVERSAMPLING_FILTERS - 1, filterIndex));
+    if (const auto& oversampler = floatOversamplers[filter][static_cast<size_t>(factorIndex)])
+        return oversampler->getLatencyInSamples();
+    if (const auto& doubleOversampler = doubleOversamplers[filter][static_cast<size_t>(factorIndex)])
+        return static_cast<float>(doubleOversampler->getLatencyInSamples());
+    return 0.0f;
+}
+
+template <typename SampleType>
+void GliderEngine::applyLatencyPad(juce::AudioBuffer<SampleType>& buffer, int numChannels)
+{
+    auto delay = [&buffer, numChannels](auto& delayLine)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* samples = buffer.getWritePointer(channel);
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                delayLine.pushSample(channel, samples[i]);
+                samples[i] = delayLine.popSample(channel);
+            }
+        }
+    };
+
+    if constexpr (std::is_same_v<SampleType, float>)
+        delay(floatLatencyPad);
+    else
+        delay(doubleLatencyPad);
+}
+
+template <typename SampleType>
+juce::dsp::Oversampling<SampleType>* GliderEngine::getActiveOversampler()
+{
+    if (oversamplingIndex <= 0)
+        return nullptr;
+
+    const auto filter = static_cast<size_t>(juce::jlimit(0, NUM_OVERSAMPLING_FILTERS - 1, oversamplingFilterIndex));
+    if constexpr (std::is_same_v<SampleType, float>)
+        return floatOversamplers[filter][static_cast<size_t>(oversamplingIndex)].get();
+    else
+        return doubleOversamplers[filter][static_cast<size_t>(oversamplingIndex)].get();
+}
+
+// Shared float / double engine - samples stay float, the output and gain chain follow SampleType
+template <typename SampleType>
+void GliderEngine::processBlockInternal(juce::AudioBuffer<SampleType>& buffer, const juce::MidiBuffer& midiMessages)
+{
+    juce::ScopedNoDenormals noDenormals;
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    ESKILATOR_TRACE_THREAD_NAME("Audio");
+    ESKILATOR_TRACE_SCOPE("processBlock", "audio");
+    ESKILATOR_REALTIME_SCOPE();
+
+    updateEngineConfig();
+
+    auto* oversampler = getActiveOversampler<SampleType>();
+    const int numChannels = juce::jmin(buffer.getNumChannels(), numOversampledChannels);
+    if (oversampler == nullptr || numChannels == 0)
+    {
+        renderBlock(buffer, midiMessages, 1);
+    }
+    else
+    {
+        // Render the voice into the oversampler's upsampled buffer, then filter back down.
+        // The plugin has no input, so the upsampling pass only provides the working buffer.
+        buffer.clear();
+        juce::dsp::AudioBlock<SampleType> block(buffer.getArrayOfWritePointers(), static_cast<size_t>(numChannels),
+                                                static_cast<size_t>(buffer.getNumSamples()));
+        auto oversampledBlock = oversampler->processSamplesUp(block);
+
+        SampleType* oversampledChannels[RenderKernels::MAX_CHANNELS] = { nullptr, nullptr };
+        for (int channel = 0; channel < numChannels; ++channel)
+            oversampledChannels[channel] = oversampledBlock.getChannelPointer(static_cast<size_t>(channel));
+
+        // Refers to the oversampler's memory, no allocation
+        juce::AudioBuffer<SampleType> oversampledBuffer(oversampledChannels, numChannels,
+                                                        static_cast<int>(oversampledBlock.getNumSamples()));
+        renderBlock(oversampledBuffer, midiMessages, 1 << oversamplingIndex);
+
+        oversampler->processSamplesDown(block);
+    }
+
+    if (latencyPadSamples > 0 && numChannels > 0)
+        applyLatencyPad(buffer, numChannels);
+
+    // Offline renders have no deadline, only live blocks feed the governor (applied next block)
+    // and count towards load and overruns
+    const bool isRealtime = !isNonRealtime();
+    const double elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    const double deadlineSeconds = isRealtime && currentSampleRate > 0.0 ? buffer.getNumSamples() / currentSampleRate : 0.0;
+    instrumentation.addBlock(elapsedSeconds, deadlineSeconds, midiMessages.getNumEvents(), countActiveVoices());
+
+    if (isRealtime && !fullQualityPinned)
+        cpuGovernor.addBlock(elapsedSeconds, buffer.getNumSamples());
+    instrumentation.setQualityTier(cpuGovernor.getTier());
+}
+
+int GliderEngine::countActiveVoices() const
+{
+    int numActive = 0;
+    for (const auto& voice : sampleVoices)
+        numActive += voice.isActive ? 1 : 0;
+    return numActive;
+}
+
+// Split a (possibly oversampled) block at each MIDI event and render the segments
+template <typename SampleType>
+void GliderEngine::renderBlock(juce::AudioBuffer<SampleType>& buffer, const juce::MidiBuffer& midiMessages, int oversamplingFactor)
+{
+    // Every segment is timed for the instrumentation
+    auto renderTimedSegment = [this, &buffer](int segmentStart, int segmentEnd)
+    {
+        const auto segmentStartTicks = juce::Time::getHighResolutionTicks();
+        ESKILATOR_TRACE_SCOPE("renderAudioSegment", "audio");
+        renderAudioSegment(buffer, segmentStart, segmentEnd);
+        instrumentation.addSegment(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - segmentStartTicks));
+    };
+
+    // Sample-accurate MIDI handling: split buffer at each MIDI event
+    int startSample = 0;
+
+    for (auto it = midiMessages.begin(); it != midiMessages.end(); ++it)
+    {
+        auto message = (*it).getMessage();
+        int sampleOffset = (*it).samplePosition * oversamplingFactor;
+
+        // Render audio up to this MIDI event
+        if (sampleOffset > startSample)
+        {
+            renderTimedSegment(startSample, sampleOffset);
+        }
+                    
+        if (message.isNoteOn())
+        {
+            handleNoteOn(message);
+        }
+        else if (message.isNoteOff())
+        {
+            handleNoteOff(message);
+        }
+
+        // Update start position for next segment
+        startSample = sampleOffset;
+    }
+
+    // Render any remaining audio after last MIDI event
+    if (startSample < buffer.getNumSamples())
+    {
+        renderTimedSegment(startSample, buffer.getNumSamples());
+    }
+}
+
+float GliderEngine::getPitchForNote(int noteNumber) const
+{
+    // Convert MIDI note number to pitch offset (C4 = 60 = 0 semitones)
+    int baseNoteNumber = 60; // Middle C
+    float pitchOffset = static_cast<float>(noteNumber - baseNoteNumber);
+    // Apply global transpose and fine tune (cents converted to semitones)
+    pitchOffset += parameters.transpose;
+    pitchOffset += parameters.fineTune / 100.0f; // Convert cents to semitones
+    // No pitch limit - allow full MIDI range
+    return pitchOffset;
+}
+
+double GliderEngine::getRatioScale(int rootNote) const
+{
+    // Pitches are relative to C4; a sample rooted elsewhere plays at its recorded pitch on its root key
+    return std::pow(2.0, (60 - rootNote) / 12.0) / static_cast<double>(1 << juce::jmax(0, oversamplingIndex));
+}
+
+void GliderEngine::handleNoteOn(const juce::MidiMessage& message)
+{
+    ESKILATOR_LOG(logger, "MIDI Note ON: Note=" + juce::String(message.getNoteNumber()) + 
+              ", Velocity=" + juce::String(message.getVelocity()));
+
+    // Legato applies when another key is still held and the voice is sounding
+    bool isLegatoNote = parameters.legato && numHeldNotes > 0 && sampleVoices[0].isActive;
+    pushHeldNote(message.getNoteNumber());
+
+    // Trigger sample playback
+    const auto sampleBank = sampleManager.getBank();
+    if (sampleBank->isEmpty())
+        return;
+
+    float pitchOffset = getPitchForNote(message.getNoteNumber());
+
+    // MONOPHONIC DESIGN: Always use voice 0
+    auto& voice = sampleVoices[0];
+
+    if (isLegatoNote)
+    {
+        // LEGATO: keep sample, phase, envelope and velocity - only the pitch moves
+        changeVoicePitch(voice, pitchOffset);
+        ESKILATOR_LOG(logger, "Legato note - voice 0 moving to pitch " + juce::String(pitchOffset));
+        return;
+    }
+
+    // Keys and velocities no sample covers don't retrigger
+    bool followsChain = false;
+    const int sampleIndex = sampleManager.selectSampleIndex(*sampleBank, message.getNoteNumber(), message.getVelocity(), &followsChain);
+    if (sampleIndex < 0)
+        return;
+
+    // Check if we should apply glide (different pitch)
+    float glideTime = parameters.glideTimeMs;
+    bool shouldGlide = (glideTime > 0.0f) && hasLastPitch && (lastMonophonicPitch != pitchOffset);
+
+    ESKILATOR_LOG(logger, "Note trigger - HasLastPitch=" + juce::String(hasLastPitch ? "true" : "false") +
+              ", LastPitch=" + juce::String(lastMonophonicPitch) +
+              ", NewPitch=" + juce::String(pitchOffset) +
+              ", ShouldGlide=" + juce::String(shouldGlide ? "true" : "false"));
+
+    // Save old state for crossfade before resetting. The fade-out reads the outgoing sample,
+    // kept alive with its bank snapshot; round-robin and the chain can pick a different one.
+    voice.glideOldPhase = voice.phase;
+    voice.glideOldPhaseIncrement = FixedPointPhase::fromDouble(voice.cachedPitchRatio > 0.0f ? voice.cachedPitchRatio
+                                                                                              : voice.getPitchRatio(voice.pitch));
+    const bool canFadeOut = voice.isActive && voice.sampleBank != nullptr && voice.sampleBank->isValidIndex(voice.sampleIndex)
+                            && (*voice.sampleBank)[voice.sampleIndex].buffer->getNumSamples() > 1
+                            && (*voice.sampleBank)[voice.sampleIndex].buffer->getNumChannels() > 0;
+    voice.fadeOutBank = canFadeOut ? voice.sampleBank : nullptr;
+    voice.fadeOutSampleIndex = canFadeOut ? voice.sampleIndex : -1;
+
+    // The new sample plays relative to its own root key
+    voice.sampleIndex = sampleIndex;
+    voice.sampleBank = sampleBank;
+    voice.sampleRemoved = false;
+    voice.triggerNote = message.getNoteNumber();
+    voice.triggerVelocity = message.getVelocity();
+    voice.followsChain = followsChain;
+    voice.ratioScale = getRatioScale((*sampleBank)[sampleIndex].mapping.rootNote);
+
+    if (shouldGlide)
+    {
+        // Different pitch - apply glide
+        startGlide(voice, lastMonophonicPitch, pitchOffset);
+
+        ESKILATOR_LOG(logger, "Applied glide to voice 0");
+    }
+    else
+    {
+        // Same pitch or first note - no glide, just set pitch directly
+        voice.isGliding = false;
+        voice.pitch = pitchOffset;
+        voice.cachedPitchRatio = 0.0f; // Force recalculation
+
+        ESKILATOR_LOG(logger, "No glide - set voice 0 to pitch " + juce::String(pitchOffset));
+    }
+
+    // Restart at the sample's start point; only crossfade when there is a sounding voice to fade from.
+    // The new note's crossfade comes from the configuration active now, for as long as it sounds.
+    voice.isInGlideCrossfade = canFadeOut;
+    voice.restartConfig = engineConfig;
+    const auto* loopRegion = (*sampleBank)[sampleIndex].loopRegion.get();
+    voice.phase = loopRegion != nullptr ? static_cast<FixedPointPhase::Phase>(loopRegion->getStart()) << FixedPointPhase::FRACTION_BITS : 0;
+    voice.samplePosition = 0;
+    voice.glideCrossfadeSampleCount = 0;
+
+    // Update velocity and activate voice
+    voice.velocity = message.getVelocity() / 127.0f;
+    voice.isActive = true;
+
+    // ADSR ENVELOPE: Always restart envelope on every non-legato note
+    voice.adsr.noteOn();
+    ESKILATOR_LOG(logger, "ADSR noteOn() triggered - envelope restarted");
+
+    // Update monophonic pitch tracking
+    lastMonophonicPitch = pitchOffset;
+    hasLastPitch = true;
+}
+
+void GliderEngine::handleNoteOff(const juce::MidiMessage& message)
+{
+    removeHeldNote(message.getNoteNumber());
+
+    auto& voice = sampleVoices[0];
+    if (!voice.isActive)
+        return;
+
+    // LEGATO: releasing the newest key returns to the previous held key without retriggering
+    if (parameters.legato && numHeldNotes > 0)
+    {
+        float pitchOffset = getPitchForNote(heldNotes[static_cast<size_t>(numHeldNotes - 1)]);
+        if (pitchOffset != lastMonophonicPitch)
+        {
+            changeVoicePitch(voice, pitchOffset);
+        }
+        return;
+    }
+
+    // Trigger release phase of ADSR envelope for monophonic voice
+    voice.adsr.noteOff();
+    ESKILATOR_LOG(logger, "ADSR noteOff() triggered - starting release phase");
+}
+
+void GliderEngine::changeVoicePitch(SampleVoice& voice, float pitchOffset)
+{
+    if (parameters.glideTimeMs > 0.0f && pitchOffset != lastMonophonicPitch)
+    {
+        // Glide from wherever the pitch currently is (may be mid-glide)
+        float currentPitch = voice.cachedPitchRatio > 0.0f ? 12.0f * static_cast<float>(std::log2(voice.cachedPitchRatio / voice.ratioScale)) : voice.pitch;
+        startGlide(voice, currentPitch, pitchOffset);
+    }
+    else
+    {
+        voice.isGliding = false;
+        voice.pitch = pitchOffset;
+        voice.cachedPitchRatio = 0.0f; // Force recalculation
+    }
+
+    lastMonophonicPitch = pitchOffset;
+    hasLastPitch = true;
+}
+
+void GliderEngine::pushHeldNote(int noteNumber)
+{
+    removeHeldNote(noteNumber);
+    if (numHeldNotes < static_cast<int>(heldNotes.size()))
+    {
+        heldNotes[static_cast<size_t>(numHeldNotes++)] = noteNumber;
+    }
+}
+
+void GliderEngine::removeHeldNote(int noteNumber)
+{
+    for (int i = 0; i < numHeldNotes; ++i)
+    {
+        if (heldNotes[static_cast<size_t>(i)] == noteNumber)
+        {
+            // Keep press order so legato can fall back to the previous key
+            std::copy(heldNotes.begin() + i + 1, heldNotes.begin() + numHeldNotes, heldNotes.begin() + i);
+            --numHeldNotes;
+            return;
+        }
+    }
+}
+
+namespace
+{
+    // Exponential glide curvature: the glide covers 1 - e^-k of the interval
+    // before the progress curve is rescaled to land exactly on the target
+    constexpr double EXPONENTIAL_GLIDE_CURVATURE = 4.6; // ~99% of the way at e^-4.6
+}
+
+// Render audio for a segment of the buffer
+template <typename SampleType>
+void GliderEngine::renderAudioSegment(juce::AudioBuffer<SampleType>& buffer, int startSample, int endSample)
+{
+    // Hold the bank snapshot for the whole segment; a sample removed meanwhile stays
+    // alive until it is released. A sounding voice plays from its own snapshot, moved to
+    // this one when its sample is still in it (see followBankChange).
+    const auto currentBank = sampleManager.getBank();
+    if (sampleVoices[0].isActive)
+        followBankChange(sampleVoices[0], currentBank);
+    else if (sampleVoices[0].sampleBank != nullptr)
+        sampleVoices[0].sampleBank = nullptr;   // The manager still holds it, so this never frees it
+
+    const auto& sampleBank = sampleVoices[0].sampleBank != nullptr ? sampleVoices[0].sampleBank : currentBank;
+    int currentSampleIndex = sampleBank->isEmpty() ? -1 : juce::jlimit(0, sampleBank->size() - 1, sampleVoices[0].sampleIndex);
+
+    // A voice the chain position picked follows it: the samples either side of the
+    // position, the second one blended in at the same phase while it sits between them.
+    // The position is smoothed; the blend ramps from its value at the start of the segment
+    // to the one at the end, staying with the pair the segment starts on.
+    const float chainStart = smoothedChainPosition.getCurrentValue();
+    const float chainEnd = smoothedChainPosition.skip(endSample - startSample);
+    int morphSampleIndex = -1;
+    float morphStartAmount = 0.0f;
+    float morphEndAmount = 0.0f;
+    if (sampleVoices[0].isActive && sampleVoices[0].followsChain)
+    {
+        const int note = sampleVoices[0].triggerNote;
+        const int velocity = sampleVoices[0].triggerVelocity;
+        auto blend = sampleManager.getChainBlend(*sampleBank, note, velocity, chainStart);
+        const auto endBlend = sampleManager.getChainBlend(*sampleBank, note, velocity, chainEnd);
+
+        // Leaving a choice: morph towards the neighbour from the start of the segment
+        if (blend.morphIndex < 0 && endBlend.morphIndex >= 0
+            && (endBlend.sampleIndex == blend.sampleIndex || endBlend.morphIndex == blend.sampleIndex))
+        {
+            const bool fromLower = endBlend.sampleIndex == blend.sampleIndex;
+            blend = endBlend;
+            blend.morphAmount = fromLower ? 0.0f : 1.0f;
+        }
+
+        if (blend.sampleIndex >= 0)
+        {
+            currentSampleIndex = blend.sampleIndex;
+            sampleVoices[0].sampleIndex = blend.sampleIndex;
+
+            // The sample plays relative to its own root key
+            setVoiceRatioScale(sampleVoices[0], getRatioScale((*sampleBank)[blend.sampleIndex].mapping.rootNote));
+
+            // Looping samples don't morph: their wrap regions differ
+            if (blend.morphIndex >= 0 && !(*sampleBank)[blend.sampleIndex].isLooping()
+                && !(*sampleBank)[blend.morphIndex].isLooping())
+            {
+                const auto& neighbour = *(*sampleBank)[blend.morphIndex].buffer;
+                if (neighbour.getNumSamples() > 1 && neighbour.getNumChannels() > 0)
+                {
+                    morphSampleIndex = blend.morphIndex;
+                    morphStartAmount = blend.morphAmount;
+
+                    // A position past either sample of the pair stops at that sample
+                    const bool samePair = endBlend.sampleIndex == blend.sampleIndex && endBlend.morphIndex == blend.morphIndex;
+                    morphEndAmount = samePair ? endBlend.morphAmount : (chainEnd > chainStart ? 1.0f : 0.0f);
+                }
+            }
+        }
+    }
+    
+    // Safety check: if no valid sample is loaded, output silence
+    if (currentSampleIndex < 0 || (*sampleBank)[currentSampleIndex].buffer->getNumSamples() <= 1) {
+        buffer.clear();
+        return;
+    }
+
+    const auto& currentSample = (*sampleBank)[currentSampleIndex];
+    const juce::AudioBuffer<float>& currentBuffer = *currentSample.buffer;
+    
+    // PERFORMANCE: Cache expensive gain calculations outside the sample loop
+    SampleType masterGainLinear = juce::Decibels::decibelsToGain(static_cast<SampleType>(parameters.masterGainDb));
+    SampleType perSampleGainLinear = juce::Decibels::decibelsToGain(static_cast<SampleType>(currentSample.gain));
+    SampleType morphGainLinear = perSampleGainLinear;
+    
+    // ROBUST BUFFER VALIDATION: Use comprehensive validation like vst-test2
+    bool bufferValid = (currentBuffer.getNumSamples() > 0 && currentBuffer.getNumChannels() > 0);
+    int maxSamples = bufferValid ? currentBuffer.getNumSamples() : 0;
+    int maxChannels = bufferValid ? currentBuffer.getNumChannels() : 0;
+
+    // Playback points; a looping voice wraps instead of ending (see LoopRegion)
+    const LoopRegion* loopRegion = currentSample.loopRegion.get();
+    const bool isLooping = currentSample.isLooping();
+    if (loopRegion != nullptr && !isLooping)
+        maxSamples = juce::jmin(maxSamples, static_cast<int>(loopRegion->getEnd()));
+
+    // Morphing: per-sample gains blend too, and the voice ends with the shorter sample
+    const juce::AudioBuffer<float>* morphBuffer = nullptr;
+    if (morphSampleIndex >= 0 && bufferValid)
+    {
+        const auto& morphSample = (*sampleBank)[morphSampleIndex];
+        morphBuffer = morphSample.buffer.get();
+        morphGainLinear = juce::Decibels::decibelsToGain(static_cast<SampleType>(morphSample.gain));
+        maxSamples = juce::jmin(maxSamples, morphBuffer->getNumSamples());
+    }
+    const auto sampleEnd = static_cast<std::uint32_t>(maxSamples);
+    
+    // THREAD-SAFE PERFORMANCE OPTIMIZATION: Cache expensive operations outside the sample loop (like vst-test2)
+    int currentVoiceCount = getEffectiveVoiceCount();
+    
+    // PERFORMANCE: Early exit if no valid audio to process
+    if (!bufferValid || currentVoiceCount == 0 || maxSamples == 0 || maxChannels == 0) {
+        buffer.clear();
+        return;
+    }
+
+    // MONOPHONIC: Only process voice 0
+    auto& voice = sampleVoices[0];
+    const int numOutputChannels = juce::jmin(buffer.getNumChannels(), RenderKernels::MAX_CHANNELS);
+    auto getBaseGain = [&](float morphAmount)
+    {
+        const SampleType sampleGain = perSampleGainLinear + (morphGainLinear - perSampleGainLinear) * static_cast<SampleType>(morphAmount);
+        return masterGainLinear * sampleGain * static_cast<SampleType>(voice.velocity);
+    };
+    SampleType baseGain = getBaseGain(morphStartAmount);
+
+    // The float engine renders straight into the host buffer. The double engine renders
+    // the interpolated voice at unity gain into float scratch and applies the envelope
+    // and gains in double while writing the host buffer.
+    constexpr bool rendersInPlace = std::is_same_v<SampleType, float>;
+
+    RenderKernels::Source source;
+    source.numChannels = juce::jmin(maxChannels, RenderKernels::MAX_CHANNELS);
+    source.numFrames = sampleEnd;
+    for (int channel = 0; channel < RenderKernels::MAX_CHANNELS; ++channel)
+        source.channels[channel] = currentBuffer.getReadPointer(juce::jmin(channel, maxChannels - 1));
+
+    const bool isMorphing = morphBuffer != nullptr;
+    if (isMorphing)
+    {
+        // Either sample being stereo makes the voice stereo; a mono one feeds both sides
+        const int morphChannels = morphBuffer->getNumChannels();
+        source.numChannels = juce::jmin(juce::jmax(maxChannels, morphChannels), RenderKernels::MAX_CHANNELS);
+        for (int channel = 0; channel < RenderKernels::MAX_CHANNELS; ++channel)
+            source.morphChannels[channel] = morphBuffer->getReadPointer(juce::jmin(channel, morphChannels - 1));
+        source.morphAmount = morphStartAmount;
+    }
+    const bool isMorphRamping = isMorphing && morphEndAmount != morphStartAmount;
+
+    // The restart crossfade fades out of the previous note's sample: reads stay below its end,
+    // or wrap inside its loop. Its snapshot is let go once the fade is over.
+    const LoopRegion* fadeOutLoop = nullptr;
+    if (voice.isInGlideCrossfade)
+    {
+        const auto& fadeOutSample = (*voice.fadeOutBank)[voice.fadeOutSampleIndex];
+        const auto& fadeOutBuffer = *fadeOutSample.buffer;
+        const int fadeOutChannels = fadeOutBuffer.getNumChannels();
+        auto fadeOutEnd = static_cast<std::uint32_t>(fadeOutBuffer.getNumSamples());
+        if (fadeOutSample.isLooping())
+        {
+            fadeOutLoop = fadeOutSample.loopRegion.get();
+            fadeOutEnd = fadeOutLoop->getLoopEnd();
+        }
+        else if (fadeOutSample.loopRegion != nullptr)
+        {
+            fadeOutEnd = juce::jmin(fadeOutEnd, fadeOutSample.loopRegion->getEnd());
+        }
+
+        // A stereo sample on either side makes the voice stereo while they overlap
+        source.numChannels = juce::jmin(juce::jmax(source.numChannels, fadeOutChannels), RenderKernels::MAX_CHANNELS);
+        for (int channel = 0; channel < RenderKernels::MAX_CHANNELS; ++channel)
+            source.fadeOutChannels[channel] = fadeOutBuffer.getReadPointer(juce::jmin(channel, fadeOutChannels - 1));
+        source.fadeOutNumFrames = fadeOutEnd;
+    }
+    else if (voice.fadeOutBank != nullptr)
+    {
+        // The manager still holds this snapshot (current or retired), so this never frees it
+        voice.fadeOutBank = nullptr;
+    }
+
+    // Past the switch point a looping voice reads the pre-rendered region
+    RenderKernels::Source regionSource;
+    if (isLooping)
+    {
+        const auto& region = loopRegion->getRegion();
+        regionSource.numChannels = source.numChannels;
+        regionSource.numFrames = static_cast<std::uint32_t>(region.getNumSamples());
+        for (int channel = 0; channel < RenderKernels::MAX_CHANNELS; ++channel)
+            regionSource.channels[channel] = region.getReadPointer(juce::jmin(channel, region.getNumChannels() - 1));
+    }
+
+    const RenderKernels::CrossfadeTable crossfadeTable = getRestartCrossfade(voice);
+    const RenderKernels::SincTable sincTable { sincCoefficients.data() };
+    const bool useSinc = useSincInterpolation;
+
+    // Continuous glides are renormalised from the exact pitch curve once per segment,
+    // the kernels below only multiply the ratio by a constant increment
+    if (voice.isActive && voice.isGliding)
+    {
+        renormaliseGlide(voice, endSample - startSample);
+    }
+
+    // Split the segment into sub-blocks with constant voice state. Each sub-block runs a
+    // kernel specialised for the channel layout / crossfade / glide state; glide step
+    // events, the last frames of the sample and its end go through the generic path.
+    int sample = startSample;
+    while (sample < endSample)
+    {
+        SampleType* hostOutputs[RenderKernels::MAX_CHANNELS] = { nullptr, nullptr };
+        float* outputs[RenderKernels::MAX_CHANNELS] = { nullptr, nullptr };
+        for (int channel = 0; channel < numOutputChannels; ++channel)
+        {
+            hostOutputs[channel] = buffer.getWritePointer(channel, sample);
+            if constexpr (rendersInPlace)
+                outputs[channel] = hostOutputs[channel];
+            else
+                outputs[channel] = kernelOutputScratch[static_cast<size_t>(channel)].data();
+        }
+
+        if (!voice.isActive)
+        {
+            for (int channel = 0; channel < numOutputChannels; ++channel)
+                juce::FloatVectorOperations::clear(hostOutputs[channel], endSample - sample);
+            break;
+        }
+
+        if (isLooping)
+        {
+            // Looping voices end with their envelope, and wrap back into the loop
+            if (!voice.adsr.isActive())
+            {
+                voice.isActive = false;
+                voice.isGliding = false;
+                continue;
+            }
+
+            voice.phase = FixedPointPhase::wrap(voice.phase, loopRegion->getWrapPoint(), loopRegion->getWrapLength());
+        }
+        // Check if sample has ended (don't deactivate on envelope completion - allows sequential notes)
+        else if (FixedPointPhase::getIndex(voice.phase) >= sampleEnd)
+        {
+            // Deactivate voice only when sample ends
+            voice.isActive = false;
+            voice.isGliding = false;
+            continue;
+        }
+
+        // A fading-out restart position in a looping sample reads its buffer and wraps inside its loop
+        if (voice.isInGlideCrossfade && fadeOutLoop != nullptr)
+            voice.glideOldPhase = FixedPointPhase::wrap(voice.glideOldPhase, fadeOutLoop->getLoopEnd(), fadeOutLoop->getLoopLength());
+
+        // Calculate pitch ratio (std::pow only when the pitch actually changed)
+        if (voice.cachedPitchRatio == 0.0f)
+        {
+            voice.setPlaybackRatio(voice.getPitchRatio(voice.pitch));
+        }
+
+        // Loops read the buffer below the switch point and the region (offset) from there.
+        // The restart crossfade only reads the buffer, so it ends early in the region.
+        const bool inLoopRegion = isLooping && FixedPointPhase::getIndex(voice.phase) >= loopRegion->getSwitchPoint();
+        const RenderKernels::Source& activeSource = inLoopRegion ? regionSource : source;
+        const FixedPointPhase::Phase phaseOffset = inLoopRegion ? static_cast<FixedPointPhase::Phase>(loopRegion->getRegionStart()) << FixedPointPhase::FRACTION_BITS : 0;
+        if (inLoopRegion)
+            voice.isInGlideCrossfade = false;
+
+        // Reads stay below the end, the switch point or the wrap point (region frames)
+        std::uint32_t readEnd = sampleEnd;
+        if (isLooping)
+            readEnd = inLoopRegion ? loopRegion->getWrapPoint() - loopRegion->getRegionStart() + 1 : loopRegion->getSwitchPoint() + 1;
+
+        bool isCrossfading = voice.isInGlideCrossfade && voice.glideCrossfadeSampleCount < crossfadeTable.length;
+        bool isRamping = voice.isGliding && isGlideRampActive(voice);
+
+        int numFrames = juce::jmin(endSample - sample, isMorphRamping ? MORPH_RAMP_FRAMES : KERNEL_BLOCK_SIZE);
+        if (isMorphRamping)
+        {
+            // Each short sub-block blends at the ramp's value halfway through it
+            const float progress = (static_cast<float>(sample - startSample) + 0.5f * static_cast<float>(numFrames))
+                                 / static_cast<float>(endSample - startSample);
+            source.morphAmount = morphStartAmount + (morphEndAmount - morphStartAmount) * progress;
+            baseGain = getBaseGain(source.morphAmount);
+        }
+        if (voice.isGliding)
+            numFrames = juce::jmin(numFrames, getFramesUntilGlideEvent(voice));
+        if (isCrossfading)
+            numFrames = juce::jmin(numFrames, crossfadeTable.length - voice.glideCrossfadeSampleCount);
+
+        if (numFrames > 0)
+        {
+            // Bound the sub-block so every interpolated read stays inside the sample
+            auto maxIncrement = voice.phaseIncrement;
+            if (isRamping)
+            {
+                float rampTargetPitch = voice.glideMode == ParameterRanges::GlideMode::SteppedSlew ? voice.pitch : voice.glideTargetPitch;
+                maxIncrement = juce::jmax(maxIncrement, FixedPointPhase::fromDouble(voice.getPitchRatio(rampTargetPitch)));
+            }
+
+            numFrames = RenderKernels::framesBeforeEnd(voice.phase - phaseOffset, maxIncrement, readEnd, numFrames);
+            if (isCrossfading)
+                numFrames = RenderKernels::framesBeforeEndFromCurrent(voice.glideOldPhase, voice.glideOldPhaseIncrement, source.fadeOutNumFrames, numFrames);
+        }
+
+        if (numFrames > 0)
+        {
+            // Envelope and gains for the sub-block
+            float* frameGains = kernelGainScratch.data();
+            for (int i = 0; i < numFrames; ++i)
+                frameGains[i] = voice.adsr.getNextSample();
+
+            const float* kernelGains = kernelUnityGains.data();
+            if constexpr (rendersInPlace)
+            {
+                kernels->applyEnvelopeGain(frameGains, frameGains, baseGain, numFrames);
+                kernelGains = frameGains;
+            }
+
+            auto kernelState = getKernelState(voice);
+            kernelState.phase -= phaseOffset;
+            if (useSinc)
+                kernels->renderVoiceSinc(activeSource, outputs, numOutputChannels, numFrames, kernelGains, kernelState,
+                                         isCrossfading, isRamping, crossfadeTable, sincTable);
+            else if (auto kernel = kernels->getVoiceKernel(activeSource.numChannels, numOutputChannels, isCrossfading, isRamping, isMorphing))
+                kernel(activeSource, outputs, numFrames, kernelGains, kernelState, crossfadeTable);
+            else
+                kernels->renderVoiceGeneric(activeSource, outputs, numOutputChannels, numFrames, kernelGains, kernelState,
+                                            isCrossfading, isRamping, crossfadeTable);
+            kernelState.phase += phaseOffset;
+            applyKernelState(voice, kernelState, isRamping);
+
+            if constexpr (! rendersInPlace)
+            {
+                for (int channel = 0; channel < numOutputChannels; ++channel)
+                    for (int i = 0; i < numFrames; ++i)
+                        hostOutputs[channel][i] = static_cast<SampleType>(outputs[channel][i])
+                                                * static_cast<SampleType>(frameGains[i]) * baseGain;
+            }
+
+            if (voice.isGliding)
+                skipGlideFrames(voice, numFrames);
+
+            if (isCrossfading && voice.glideCrossfadeSampleCount >= crossfadeTable.length)
+                voice.isInGlideCrossfade = false;
+
+            sample += numFrames;
+            continue;
+        }
+
+        voice.phase -= phaseOffset;
+        if constexpr (rendersInPlace)
+        {
+            renderGenericFrame(voice, activeSource, outputs, numOutputChannels, baseGain, crossfadeTable, isLooping);
+            voice.phase += phaseOffset;
+        }
+        else
+        {
+            const float envelope = renderGenericFrame(voice, activeSource, outputs, numOutputChannels, 1.0f, crossfadeTable, isLooping);
+            voice.phase += phaseOffset;
+            for (int channel = 0; channel < numOutputChannels; ++channel)
+                hostOutputs[channel][0] = static_cast<SampleType>(outputs[channel][0]) * static_cast<SampleType>(envelope) * baseGain;
+        }
+        ++sample;
+    }
+
+    // Clear any remaining channels
+    for (int channel = numOutputChannels; channel < buffer.getNumChannels(); ++channel)
+    {
+        buffer.clear(channel, startSample, endSample - startSample);
+    }
+}
+
+float GliderEngine::renderGenericFrame(SampleVoice& voice, const RenderKernels::Source& source, float* const* outputs,
+                                              int numOutputChannels, float baseGain, const RenderKernels::CrossfadeTable& crossfadeTable,
+                                              bool isLooping)
+{
+    // Process glide for portamento (stepped Triton-style or continuous)
+    if (voice.isGliding)
+    {
+        advanceGlide(voice);
+    }
+
+    // Calculate pitch ratio (std::pow only when the pitch actually changed)
+    if (voice.cachedPitchRatio == 0.0f)
+    {
+        voice.setPlaybackRatio(voice.getPitchRatio(voice.pitch));
+    }
+
+    // GLIDE CROSSFADE: Read from both old and new positions during crossfade
+    bool isCrossfading = voice.isInGlideCrossfade && voice.glideCrossfadeSampleCount < crossfadeTable.length;
+
+    // ENVELOPE DISABLED - one-shot sample has ended, deactivate voice (loops wrap instead)
+    if (!isLooping && !isCrossfading && FixedPointPhase::getIndex(voice.phase + voice.phaseIncrement) >= source.numFrames)
+    {
+        voice.phase += voice.phaseIncrement;
+        voice.isActive = false;
+        voice.isGliding = false;
+        for (int channel = 0; channel < numOutputChannels; ++channel)
+            outputs[channel][0] = 0.0f;
+        return 0.0f;
+    }
+
+    // Apply cached gain values and the ADSR envelope once per frame
+    const float envelope = voice.adsr.getNextSample();
+    float frameGain = baseGain * envelope;
+
+    auto kernelState = getKernelState(voice);
+    if (useSincInterpolation)
+        kernels->renderVoiceSinc(source, outputs, numOutputChannels, 1, &frameGain, kernelState,
+                                 isCrossfading, false, crossfadeTable, { sincCoefficients.data() });
+    else
+        kernels->renderVoiceGeneric(source, outputs, numOutputChannels, 1, &frameGain, kernelState,
+                                    isCrossfading, false, crossfadeTable);
+    applyKernelState(voice, kernelState, false);
+
+    // Check if crossfade is complete
+    if (isCrossfading && voice.glideCrossfadeSampleCount >= crossfadeTable.length)
+    {
+        voice.isInGlideCrossfade = false;
+    }
+
+    return envelope;
+}
+
+RenderKernels::VoiceState GliderEngine::getKernelState(const SampleVoice& voice)
+{
+    RenderKernels::VoiceState state;
+    state.phase = voice.phase;
+    state.phaseIncrement = voice.phaseIncrement;
+    state.oldPhase = voice.glideOldPhase;
+    state.oldPhaseIncrement = voice.glideOldPhaseIncrement;
+    state.crossfadeCount = voice.glideCrossfadeSampleCount;
+    state.ratio = voice.glideRatio;
+    state.ratioIncrement = voice.glideRatioIncrement;
+    return state;
+}
+
+void GliderEngine::applyKernelState(SampleVoice& voice, const RenderKernels::VoiceState& state, bool wasRamping)
+{
+    voice.phase = state.phase;
+    voice.glideOldPhase = state.oldPhase;
+    voice.glideCrossfadeSampleCount = state.crossfadeCount;
+
+    if (wasRamping)
+    {
+        voice.glideRatio = state.ratio;
+        voice.setPlaybackRatio(state.ratio);
+    }
+}
+
+void GliderEngine::startGlide(SampleVoice& voice, float fromPitch, float toPitch)
+{
+    float glideTime = parameters.glideTimeMs;
+    int glideSteps = parameters.glideSteps;
+
+    voice.isGliding = true;
+    voice.glideMode = parameters.glideMode;
+    voice.glideStartPitch = fromPitch;
+    voice.glideTargetPitch = toPitch;
+    voice.glideCurrentStep = 0;
+    voice.glideTotalSteps = glideSteps;
+    voice.glideTotalSamples = juce::jmax(1, static_cast<int>(glideTime * 0.001f * renderSampleRate));
+    voice.glideSamplesPerStep = voice.glideTotalSamples / glideSteps;
+    voice.glideSampleCounter = 0;
+    voice.glideElapsedSamples = 0;
+    voice.glideSlewSamples = voice.glideMode == ParameterRanges::GlideMode::SteppedSlew
+                                 ? static_cast<int>(voice.glideSamplesPerStep * parameters.glideSlew * 0.01f)
+                                 : 0;
+    voice.glideSlewCounter = voice.glideSlewSamples; // No slew in progress until the first step
+    voice.glideSlewFromPitch = fromPitch;
+    voice.glideRatio = voice.getPitchRatio(fromPitch);
+    voice.glideRatioIncrement = 1.0;
+    voice.cachedPitchRatio = 0.0f; // Force recalculation
+    voice.pitch = fromPitch;       // Start with beginning pitch
+}
+
+float GliderEngine::getGlidePitchAt(const SampleVoice& voice, int elapsedSamples)
+{
+    double progress = juce::jlimit(0.0, 1.0, static_cast<double>(elapsedSamples) / static_cast<double>(voice.glideTotalSamples));
+
+    if (voice.glideMode == ParameterRanges::GlideMode::Exponential)
+    {
+        // Rescaled so the curve starts at 0 and lands exactly on 1
+        progress = (1.0 - std::exp(-EXPONENTIAL_GLIDE_CURVATURE * progress))
+                 / (1.0 - std::exp(-EXPONENTIAL_GLIDE_CURVATURE));
+    }
+
+    return voice.glideStartPitch + static_cast<float>((voice.glideTargetPitch - voice.glideStartPitch) * progress);
+}
+
+void GliderEngine::renormaliseGlide(SampleVoice& voice, int numSamples)
+{
+    switch (voice.glideMode)
+    {
+        case ParameterRanges::GlideMode::Linear:
+        case ParameterRanges::GlideMode::Exponential:
+        {
+            // Exact ratio at the segment start, then a constant increment that lands
+            // on the exact ratio at the segment end (piecewise-exact for Exponential)
+            int segmentEnd = juce::jmin(voice.glideElapsedSamples + numSamples, voice.glideTotalSamples);
+            int segmentLength = segmentEnd - voice.glideElapsedSamples;
+            float startPitch = getGlidePitchAt(voice, voice.glideElapsedSamples);
+            float endPitch = getGlidePitchAt(voice, segmentEnd);
+
+            voice.glideRatio = voice.getPitchRatio(startPitch);
+            voice.glideRatioIncrement = segmentLength > 0 ? std::pow(2.0, (endPitch - startPitch) / (12.0 * segmentLength)) : 1.0;
+            voice.setPlaybackRatio(voice.glideRatio);
+            break;
+        }
+
+        case ParameterRanges::GlideMode::SteppedSlew:
+        {
+            // Re-anchor the slew ratio to the exact curve to stop rounding drift
+            if (voice.glideSlewCounter < voice.glideSlewSamples)
+            {
+                float slewProgress = static_cast<float>(voice.glideSlewCounter) / static_cast<float>(voice.glideSlewSamples);
+                float slewPitch = voice.glideSlewFromPitch + (voice.pitch - voice.glideSlewFromPitch) * slewProgress;
+                voice.glideRatio = voice.getPitchRatio(slewPitch);
+                voice.setPlaybackRatio(voice.glideRatio);
+            }
+            break;
+        }
+
+        case ParameterRanges::GlideMode::Stepped:
+        default:
+            break;
+    }
+}
+
+void GliderEngine::advanceGlide(SampleVoice& voice)
+{
+    if (voice.glideMode == ParameterRanges::GlideMode::Linear
+        || voice.glideMode == ParameterRanges::GlideMode::Exponential)
+    {
+        // Recursive exponential: one multiply per sample instead of std::pow
+        voice.glideRatio *= voice.glideRatioIncrement;
+
+        if (++voice.glideElapsedSamples >= voice.glideTotalSamples)
+        {
+            // Glide complete - snap to the exact target pitch
+            voice.pitch = voice.glideTargetPitch;
+            voice.cachedPitchRatio = 0.0f; // Force recalculation on next sample
+            voice.isGliding = false;
+        }
+        else
+        {
+            voice.setPlaybackRatio(voice.glideRatio);
+        }
+        return;
+    }
+
+    // Stepped modes: move to the next step when the current one has elapsed
+    bool glideStepsComplete = voice.glideCurrentStep >= voice.glideTotalSteps;
+    if (!glideStepsComplete && ++voice.glideSampleCounter >= voice.glideSamplesPerStep)
+    {
+        voice.glideCurrentStep++;
+        voice.glideSampleCounter = 0;
+
+        // Calculate the stepped pitch (discrete steps, not smooth)
+        float newPitch = voice.glideTargetPitch;
+        if (voice.glideCurrentStep < voice.glideTotalSteps)
+        {
+            // Calculate stepped pitch - this creates the "cheap" Triton sound
+            float stepProgress = static_cast<float>(voice.glideCurrentStep) / static_cast<float>(voice.glideTotalSteps);
+            newPitch = voice.glideStartPitch + (voice.glideTargetPitch - voice.glideStartPitch) * stepProgress;
+        }
+
+        if (voice.glideMode == ParameterRanges::GlideMode::SteppedSlew && voice.glideSlewSamples > 0)
+        {
+            // Slew from the previous step into the new one with a constant ratio increment
+            voice.glideSlewFromPitch = voice.pitch;
+            voice.glideSlewCounter = 0;
+            voice.glideRatio = voice.getPitchRatio(voice.glideSlewFromPitch);
+            voice.glideRatioIncrement = std::pow(2.0, (newPitch - voice.glideSlewFromPitch) / (12.0 * voice.glideSlewSamples));
+            voice.pitch = newPitch;
+        }
+        else
+        {
+            // Update pitch directly (NO PHASE COMPENSATION)
+            // The discrete pitch jump is intentional for Triton-style stepped glide
+            voice.pitch = newPitch;
+            voice.cachedPitchRatio = 0.0f; // Force recalculation on next sample
+        }
+
+        glideStepsComplete = voice.glideCurrentStep >= voice.glideTotalSteps;
+    }
+
+    if (voice.glideSlewCounter < voice.glideSlewSamples)
+    {
+        voice.glideRatio *= voice.glideRatioIncrement;
+
+        if (++voice.glideSlewCounter >= voice.glideSlewSamples)
+            voice.cachedPitchRatio = 0.0f; // Slew finished - settle on the exact step pitch
+        else
+            voice.setPlaybackRatio(voice.glideRatio);
+        return;
+    }
+
+    if (glideStepsComplete)
+    {
+        // Glide complete - final pitch already set
+        voice.isGliding = false;
+    }
+}
+
+int GliderEngine::allocateVoice()
+{
+    int currentVoiceCount = getEffectiveVoiceCount();
+    
+    ESKILATOR_LOG(logger, "allocateVoice() called - VoiceCount=" + juce::String(currentVoiceCount) + 
+              ", Voice0 active=" + juce::String(sampleVoices[0].isActive ? "true" : "false"));
+    
+    // First, try to find an inactive voice (works for both mono and poly)
+    for (int i = 0; i < currentVoiceCount && i < MAX_VOICES; ++i)
+    {
+        if (!sampleVoices[i].isActive)
+        {
+            ESKILATOR_LOG(logger, "Found inactive voice " + juce::String(i) + " for allocation");
+            return i;
+        }
+    }
+    
+    // If no inactive voices, steal the oldest one within the allowed voice count
+    int oldestVoice = 0;
+    juce::uint64 oldestTime = sampleVoices[0].voiceStartTime;
+    
+    for (int i = 1; i < currentVoiceCount && i < MAX_VOICES; ++i)
+    {
+        if (sampleVoices[i].voiceStartTime < oldestTime)
+        {
+            oldestTime = sampleVoices[i].voiceStartTime;
+            oldestVoice = i;
+        }
+    }
+    
+    // CROSSFADE DISABLED - immediately deactivate stolen voice
+    auto& stolenVoice = sampleVoices[oldestVoice];
+    if (stolenVoice.isActive)
+    {
+        ESKILATOR_LOG(logger, "Voice " + juce::String(oldestVoice) + " stolen and deactivated");
+        stolenVoice.isActive = false;
+        stolenVoice.isGliding = false;
+    }
+
+    return oldestVoice;
+}
+
+bool GliderEngine::isGlideRampActive(const SampleVoice& voice)
+{
+    switch (voice.glideMode)
+    {
+        case ParameterRanges::GlideMode::Linear:
+        case ParameterRanges::GlideMode::Exponential:
+            return true;
+
+        case ParameterRanges::GlideMode::SteppedSlew:
+            return voice.glideSlewCounter < voice.glideSlewSamples;
+
+        case ParameterRanges::GlideMode::Stepped:
+        default:
+            return false;
+    }
+}
+
+int GliderEngine::getFramesUntilGlideEvent(const SampleVoice& voice)
+{
+    // Frames that advanceGlide() would process without changing pitch, finishing a
+    // slew or ending the glide - the next frame after these is the event frame
+    if (voice.glideMode == ParameterRanges::GlideMode::Linear
+        || voice.glideMode == ParameterRanges::GlideMode::Exponential)
+    {
+        return juce::jmax(0, voice.glideTotalSamples - voice.glideElapsedSamples - 1);
+    }
+
+    bool glideStepsComplete = voice.glideCurrentStep >= voice.glideTotalSteps;
+    bool isSlewing = voice.glideSlewCounter < voice.glideSlewSamples;
+
+    if (glideStepsComplete && !isSlewing)
+        return 0;
+
+    int frames = std::numeric_limits<int>::max();
+    if (!glideStepsComplete)
+        frames = juce::jmin(frames, voice.glideSamplesPerStep - voice.glideSampleCounter - 1);
+    if (isSlewing)
+        frames = juce::jmin(frames, voice.glideSlewSamples - voice.glideSlewCounter - 1);
+
+    return juce::jmax(0, frames);
+}
+
+void GliderEngine::skipGlideFrames(SampleVoice& voice, int numFrames)
+{
+    // Bulk equivalent of numFrames advanceGlide() calls that contain no glide event
+    if (voice.glideMode == ParameterRanges::GlideMode::Linear
+        || voice.glideMode == ParameterRanges::GlideMode::Exponential)
+    {
+        voice.glideElapsedSamples += numFrames;
+        return;
+    }
+
+    if (voice.glideCurrentStep < voice.glideTotalSteps)
+        voice.glideSampleCounter += numFrames;
+    if (voice.glideSlewCounter < voice.glideSlewSamples)
+        voice.glideSlewCounter += numFrames;
+}
+
+void GliderEngine::rescaleVoiceTiming(SampleVoice& voice, double rateRatio)
+{
+    auto rescale = [rateRatio](int samples) { return juce::roundToInt(samples * rateRatio); };
+
+    // The same pitch at the new rate: every playback ratio scales by old rate / new rate
+    voice.ratioScale /= rateRatio;
+    voice.glideOldPhaseIncrement = FixedPointPhase::fromDouble(FixedPointPhase::toDouble(voice.glideOldPhaseIncrement) / rateRatio);
+    voice.glideCrossfadeSampleCount = rescale(voice.glideCrossfadeSampleCount);
+
+    // Glide progress, step and slew lengths keep their duration
+    voice.glideTotalSamples = juce::jmax(1, rescale(voice.glideTotalSamples));
+    voice.glideElapsedSamples = juce::jmin(rescale(voice.glideElapsedSamples), voice.glideTotalSamples);
+    voice.glideSamplesPerStep = rescale(voice.glideSamplesPerStep);
+    voice.glideSampleCounter = rescale(voice.glideSampleCounter);
+    voice.glideSlewSamples = rescale(voice.glideSlewSamples);
+    voice.glideSlewCounter = juce::jmin(rescale(voice.glideSlewCounter), voice.glideSlewSamples);
+    voice.glideRatio /= rateRatio;
+    voice.glideRatioIncrement = std::pow(voice.glideRatioIncrement, 1.0 / rateRatio);
+
+    // A ramp continues from its rescaled ratio, a fixed pitch is recalculated
+    if (voice.isGliding && isGlideRampActive(voice))
+        voice.setPlaybackRatio(voice.glideRatio);
+    else
+        voice.cachedPitchRatio = 0.0f;
+}
+
+void GliderEngine::setVoiceRatioScale(SampleVoice& voice, double ratioScale)
+{
+    if (ratioScale == voice.ratioScale)
+        return;
+
+    // A ramp continues at the same pitch, a fixed pitch is recalculated
+    voice.glideRatio *= ratioScale / voice.ratioScale;
+    voice.ratioScale = ratioScale;
+
+    if (voice.isGliding && isGlideRampActive(voice))
+        voice.setPlaybackRatio(voice.glideRatio);
+    else
+        voice.cachedPitchRatio = 0.0f;
+}
+
+void GliderEngine::followBankChange(SampleVoice& voice, const SampleBank::Ptr& bank)
+{
+    if (voice.sampleBank == nullptr || voice.sampleBank == bank || voice.sampleRemoved)
+        return;
+
+    // Restores and removals can move or drop samples. Buffers are shared by every snapshot
+    // holding a sample, so the playing one is found by its buffer.
+    const auto* playing = voice.sampleBank->isValidIndex(voice.sampleIndex) ? (*voice.sampleBank)[voice.sampleIndex].buffer.get() : nullptr;
+    const auto& samples = bank->getSamples();
+    const auto found = std::find_if(samples.begin(), samples.end(),
+                                    [playing](const SampleInfo& sample) { return sample.buffer.get() == playing; });
+
+    if (playing != nullptr && found != samples.end())
+    {
+        // The previous snapshot is still held by the manager, so letting it go never frees it
+        voice.sampleIndex = static_cast<int>(found - samples.begin());
+        voice.sampleBank = bank;
+        return;
+    }
+
+    // Gone from the bank: keep reading the old snapshot and release. The chain position
+    // only applies to samples in the bank.
+    voice.sampleRemoved = true;
+    voice.followsChain = false;
+    voice.adsr.noteOff();
+}
@@ -0,0 +1,351 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <memory>
+#include <vector>
+#include "PluginLogger.h"
+#include "SampleManager.h"
+#include "ParameterRanges.h"
+#include "FixedPointPhase.h"
+#include "RenderKernels.h"
+#include "KernelDispatch.h"
+#include "FadeTables.h"
+#include "EngineConfig.h"
+#include "CpuGovernor.h"
+#include "Instrumentation.h"
+#include "Trace.h"
+#include "RealtimeCheck.h"
+
+// The headless voice engine: sample bank, monophonic voice with glide and legato,
+// envelope, oversampling and the CPU governor, rendering into caller-owned buffers.
+// GliderAudioProcessor is a thin adapter over it (APVTS parameters, host MIDI, state,
+// latency reporting); tools and services can embed it without the plugin.
+//
+// Threading: prepare() and the setters marked as such run while no render is in
+// progress. render() / process() and setParameters() run on one audio thread. The
+// sample bank (getSampleManager()) can be edited from any thread at any time.
+class GliderEngine
+{
+public:
+    // Parameter values in plain units, applied at the next block boundary
+    struct Parameters
+    {
+        float attack = ParameterRanges::ADSR_ATTACK_DEFAULT;
+        float decay = ParameterRanges::ADSR_DECAY_DEFAULT;
+        float sustain = ParameterRanges::ADSR_SUSTAIN_DEFAULT;
+        float release = ParameterRanges::ADSR_RELEASE_DEFAULT;
+        float masterGainDb = ParameterRanges::SAMPLE_GAIN_DEFAULT;
+        int voiceCount = static_cast<int>(ParameterRanges::VOICE_COUNT_DEFAULT);
+        float glideTimeMs = ParameterRanges::GLIDE_TIME_DEFAULT;
+        int glideSteps = static_cast<int>(ParameterRanges::GLIDE_STEPS_DEFAULT);
+        ParameterRanges::GlideMode glideMode = static_cast<ParameterRanges::GlideMode>(ParameterRanges::GLIDE_MODE_DEFAULT);
+        float glideSlew = ParameterRanges::GLIDE_SLEW_DEFAULT;                 // Percent of each step
+        bool legato = ParameterRanges::LEGATO_DEFAULT;
+        int oversamplingIndex = ParameterRanges::OVERSAMPLING_DEFAULT;         // Factor 2^index
+        ParameterRanges::OversamplingFilter oversamplingFilter = static_cast<ParameterRanges::OversamplingFilter>(ParameterRanges::OVERSAMPLING_FILTER_DEFAULT);
+        ParameterRanges::Interpolation interpolation = static_cast<ParameterRanges::Interpolation>(ParameterRanges::INTERPOLATION_DEFAULT);
+        float transpose = ParameterRanges::TRANSPOSE_DEFAULT;                  // Semitones
+        float fineTune = ParameterRanges::FINETUNE_DEFAULT;                    // Cents
+        float sampleChain = ParameterRanges::SAMPLE_CHAIN_DEFAULT;             // 0-1 across the samples covering a key
+    };
+
+    GliderEngine();
+    ~GliderEngine() = default;
+
+    // Allocates: oversamplers for the precision, tables for the rate, MIDI queue space.
+    // Blocks passed to render() / process() are at most maxBlockSize frames.
+    void prepare(double sampleRate, int maxBlockSize, int numChannels, bool doublePrecision);
+
+    // Audio thread, between blocks
+    void setParameters(const Parameters& newParameters);
+    const Parameters& getParameters() const { return parameters; }
+
+    // Offline (non-realtime) rendering uses the offline engine configuration and has no deadline
+    void setNonRealtime(bool shouldBeNonRealtime) { nonRealtime = shouldBeNonRealtime; }
+    bool isNonRealtime() const { return nonRealtime; }
+
+    // Queue a MIDI event for the next render() call, frameOffset frames into it.
+    // Real-time safe for up to MIDI_QUEUE_BYTES of events per call.
+    void addMidiEvent(const juce::MidiMessage& message, int frameOffset);
+
+    // Render numFrames (any length) into caller-owned channel buffers, consuming the
+    // queued MIDI events. Channels beyond the second are cleared.
+    void render(float* const* outputs, int numChannels, int numFrames);
+    void render(double* const* outputs, int numChannels, int numFrames);
+
+    // Render one block of at most maxBlockSize frames with the events in midi (the plugin path)
+    void process(juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midi);
+    void process(juce::AudioBuffer<double>& buffer, const juce::MidiBuffer& midi);
+
+    // Sample bank, safe to edit from any thread (see SampleManager)
+    SampleManager& getSampleManager() { return sampleManager; }
+    const SampleManager& getSampleManager() const { return sampleManager; }
+
+    double getSampleRate() const { return currentSampleRate; }
+
+    // Filter latency of the highest oversampling factor with the selected filter, in host-rate
+    // samples. Lower factors are padded to it, so factor changes (parameter, bounce, governor
+    // step) never change what the host compensates for.
+    int getLatencySamples() const { return latencySamples; }
+
+    // Seed for randomised sample selection and the round-robin start, applied by prepare(),
+    // so renders from the same seed pick the same samples
+    void setRandomSeed(std::uint64_t seed) { randomSeed = seed; }
+
+    // Kernel instruction set - the override (for testing) takes effect on the next prepare()
+    void setInstructionSetOverride(KernelDispatch::InstructionSet instructionSet) { instructionSetOverride = instructionSet; }
+    KernelDispatch::InstructionSet getActiveInstructionSet() const { return kernels->instructionSet; }
+
+    // Keep live rendering on the Full tier whatever the block timing (regression renders,
+    // which must not depend on how fast the machine is). Set before prepare().
+    void setFullQualityPinned(bool shouldPin) { fullQualityPinned = shouldPin; }
+    bool isFullQualityPinned() const { return fullQualityPinned; }
+
+    // CPU governor state (safe to read from any thread)
+    CpuGovernor::QualityTier getQualityTier() const { return cpuGovernor.getTier(); }
+    float getCpuLoad() const { return cpuGovernor.getLoad(); }
+
+    // Per-block / per-segment statistics, read by an InstrumentationReader
+    Instrumentation& getInstrumentation() { return instrumentation; }
+
+    PluginLogger& getLogger() { return logger; }
+
+    // Voice management
+    int allocateVoice(); // Returns voice index, with proper voice stealing
+
+    static constexpr int MAX_VOICES = 64; // Allow up to 64 overlapping samples (like vst-test2)
+
+    // MIDI queued through addMidiEvent between two render() calls
+    static constexpr int MIDI_QUEUE_BYTES = 4096;
+
+private:
+    // Sample-accurate audio rendering
+    template <typename SampleType>
+    void processBlockInternal(juce::AudioBuffer<SampleType>& buffer, const juce::MidiBuffer& midiMessages);
+    template <typename SampleType>
+    void renderQueued(SampleType* const* outputs, int numChannels, int numFrames);
+    template <typename SampleType>
+    void renderAudioSegment(juce::AudioBuffer<SampleType>& buffer, int startSample, int endSample);
+
+    // Generic single-frame path (glide events, last frames of the sample), returns the envelope value
+    struct SampleVoice;
+    float renderGenericFrame(SampleVoice& voice, const RenderKernels::Source& source, float* const* outputs,
+                            int numOutputChannels, float baseGain, const RenderKernels::CrossfadeTable& crossfadeTable,
+                            bool isLooping);
+    static RenderKernels::VoiceState getKernelState(const SampleVoice& voice);
+    static void applyKernelState(SampleVoice& voice, const RenderKernels::VoiceState& state, bool wasRamping);
+
+    // Kernel sub-block length and per-frame gain scratch (envelope x gains)
+    static constexpr int KERNEL_BLOCK_SIZE = 512;
+    std::array<float, KERNEL_BLOCK_SIZE> kernelGainScratch {};
+
+    // Chain position smoothing; while the morph amount ramps, sub-blocks step it every
+    // MORPH_RAMP_FRAMES frames
+    static constexpr double CHAIN_SMOOTHING_SECONDS = 0.02;
+    static constexpr int MORPH_RAMP_FRAMES = 32;
+    juce::SmoothedValue<float> smoothedChainPosition;
+
+    // Double-precision path: kernels render at unity gain into float scratch
+    std::array<float, KERNEL_BLOCK_SIZE> kernelUnityGains {};
+    std::array<std::array<float, KERNEL_BLOCK_SIZE>, RenderKernels::MAX_CHANNELS> kernelOutputScratch {};
+
+    // Kernel set for the running CPU, selected in prepare
+    KernelDispatch::InstructionSet instructionSetOverride = KernelDispatch::InstructionSet::Auto;
+    const KernelDispatch::KernelTable* kernels = &KernelDispatch::selectKernels();
+
+    // MIDI note handling
+    void handleNoteOn(const juce::MidiMessage& message);
+    void handleNoteOff(const juce::MidiMessage& message);
+    float getPitchForNote(int noteNumber) const;
+    double getRatioScale(int rootNote) const;
+
+    // Glide helpers (per-voice portamento state)
+    void changeVoicePitch(SampleVoice& voice, float pitchOffset);
+    void startGlide(SampleVoice& voice, float fromPitch, float toPitch);
+    static void renormaliseGlide(SampleVoice& voice, int numSamples);
+    static void advanceGlide(SampleVoice& voice);
+    static float getGlidePitchAt(const SampleVoice& voice, int elapsedSamples);
+    static bool isGlideRampActive(const SampleVoice& voice);
+    static int getFramesUntilGlideEvent(const SampleVoice& voice);
+    static void skipGlideFrames(SampleVoice& voice, int numFrames);
+
+    // Carry a sounding voice across a render rate change: increments, glide and crossfade
+    // counters are rescaled by newRate / oldRate
+    static void rescaleVoiceTiming(SampleVoice& voice, double rateRatio);
+
+    // Move a sounding voice to a new bank snapshot, finding its sample there by identity
+    static void followBankChange(SampleVoice& voice, const SampleBank::Ptr& bank);
+
+    // Switch a sounding voice to another root key's ratio scale at the same pitch
+    static void setVoiceRatioScale(SampleVoice& voice, double ratioScale);
+
+    // Logger instance
+    PluginLogger logger;
+
+    Parameters parameters;
+    bool nonRealtime = false;
+    bool fullQualityPinned = false;
+    std::uint64_t randomSeed = FastRandom::DEFAULT_SEED;
+
+    double currentSampleRate = 44100.0;
+    int maxBlockSize = 0;
+    int latencySamples = 0;
+
+    // ADSR envelope state (legacy enum kept for compatibility)
+    enum class EnvelopeState { Idle, Attack, Decay, Sustain, Release };
+
+    SampleManager sampleManager;
+
+    // Events queued by addMidiEvent, and the slice of them for one maxBlockSize chunk
+    juce::MidiBuffer pendingMidi;
+    juce::MidiBuffer chunkMidi;
+
+    // Multiple sample voices for overlapping playback
+    struct SampleVoice
+    {
+        int samplePosition = 0;
+        int noteOffCountdown = 0;
+        EnvelopeState currentEnvelopeState = EnvelopeState::Idle;
+        float currentEnvelopeValue = 0.0f;
+        int envelopeSampleCounter = 0;
+        bool isActive = false;
+        int sampleIndex = -1;       // Index in sampleBank, the snapshot the voice plays from
+        SampleBank::Ptr sampleBank;
+        bool sampleRemoved = false; // A bank change dropped the sample; the voice releases from its snapshot
+
+        // Key and velocity that triggered the sample; while followsChain (the chain position,
+        // not randomization, made the pick) the voice morphs with the chain position
+        int triggerNote = -1;
+        int triggerVelocity = 0;
+        bool followsChain = false;
+        juce::uint64 voiceStartTime = 0; // For voice stealing - track when voice started
+        float velocity = 1.0f; // Velocity value for this voice (0.0 to 1.0)
+        float pitch = 0.0f; // Pitch value for this voice (-12.0 to +12.0 semitones)
+        float cachedPitchRatio = 0.0f; // Cache pitch ratio to avoid repeated std::pow() calls
+        float releaseMultiplier = 0.0f; // Cached release multiplier for smooth fadeouts
+
+        // Glide state for stepped portamento
+        bool isGliding = false;           // Whether this voice is currently gliding
+        float glideStartPitch = 0.0f;     // Starting pitch for glide
+        float glideTargetPitch = 0.0f;    // Target pitch for glide
+        int glideCurrentStep = 0;         // Current step in the glide process
+        int glideTotalSteps = 0;          // Total number of steps for the glide
+        int glideSamplesPerStep = 0;      // Samples per step
+        int glideSampleCounter = 0;       // Counter for current step duration
+        ParameterRanges::GlideMode glideMode = ParameterRanges::GlideMode::Stepped;
+
+        // Continuous glide state (Linear / Exponential / SteppedSlew)
+        // The ratio is advanced by a constant multiplicative increment per sample
+        // and renormalised from the exact pitch curve once per rendered segment
+        int glideTotalSamples = 0;        // Total glide duration in samples
+        int glideElapsedSamples = 0;      // Samples elapsed since the glide started
+        double glideRatio = 1.0;          // Current playback ratio while gliding
+        double glideRatioIncrement = 1.0; // Per-sample multiplicative ratio step
+        float glideSlewFromPitch = 0.0f;  // Pitch the current step slews from
+        int glideSlewSamples = 0;         // Slew length per step in samples
+        int glideSlewCounter = 0;         // Progress through the current slew
+
+        // Phase continuity for stepped portamento (prevents clicks)
+        FixedPointPhase::Phase phase = 0;          // 32.32 playback position for sample reading
+        FixedPointPhase::Phase phaseIncrement = 0; // 32.32 per-sample advance (pitch ratio)
+
+        // Glide crossfade state (prevents clicks when restarting sample)
+        bool isInGlideCrossfade = false;       // Whether voice is crossfading at glide start
+        int glideCrossfadeSampleCount = 0;     // Counter for crossfade progress
+        FixedPointPhase::Phase glideOldPhase = 0;          // Old phase position to crossfade from
+        FixedPointPhase::Phase glideOldPhaseIncrement = 0; // Old pitch ratio for old position playback
+        const EngineConfig* restartConfig = nullptr;       // Configuration the note started with (crossfade length)
+        SampleBank::Ptr fadeOutBank;                       // Snapshot holding the sample the crossfade fades out of
+        int fadeOutSampleIndex = -1;                       // ...and its index there
+
+        // ADSR envelope using JUCE's built-in class
+        juce::ADSR adsr;  // Exponential envelope with proper legato support
+
+        // Root key offset x host rate / render rate (1 / oversampling factor), scales every playback ratio
+        double ratioScale = 1.0;
+
+        // Playback ratio for a pitch at the render rate
+        double getPitchRatio(float semitones) const { return std::pow(2.0, semitones / 12.0) * ratioScale; }
+
+        // Set the playback ratio (keeps the float cache and fixed-point increment in step)
+        void setPlaybackRatio(double ratio)
+        {
+            cachedPitchRatio = static_cast<float>(ratio);
+            phaseIncrement = FixedPointPhase::fromDouble(ratio);
+        }
+    };
+
+    // Envelope settings from the current parameters
+    juce::ADSR::Parameters getAdsrParameters() const;
+
+    // Fade curves for the current sample rate, built in prepare()
+    FadeTables fadeTables;
+
+    // Live (one per CPU governor tier) and offline (non-realtime) engine configurations,
+    // all prepared in prepare
+    std::array<EngineConfig, CpuGovernor::NUM_TIERS> liveConfigs {};
+    EngineConfig offlineConfig = EngineConfig::offline();
+    const EngineConfig* engineConfig = &liveConfigs[0];
+    std::vector<float> sincCoefficients;                 // Shared windowed-sinc table
+    bool useSincInterpolation = false;                   // Resolved from the config and parameter per block
+    int getEffectiveVoiceCount() const;
+
+    // Equal-power restart crossfade of the voice's configuration at the current render rate
+    RenderKernels::CrossfadeTable getRestartCrossfade(const SampleVoice& voice) const;
+
+    // Times each live block against its deadline and picks the live configuration
+    CpuGovernor cpuGovernor;
+
+    // Per-block / per-segment statistics (written by the audio thread only)
+    Instrumentation instrumentation;
+    int countActiveVoices() const;
+
+    // Oversampled rendering: the voice runs at renderSampleRate and the oversampler filters
+    // back down to the host rate. One oversampler per factor and filter type is built in
+    // prepare for the processing precision, so switching is allocation-free.
+    static constexpr int NUM_OVERSAMPLING_FILTERS = 2;
+    template <typename SampleType>
+    using OversamplerSet = std::array<std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>,
+                                                 ParameterRanges::OVERSAMPLING_MAX_INDEX + 1>, NUM_OVERSAMPLING_FILTERS>;
+    OversamplerSet<float> floatOversamplers;
+    OversamplerSet<double> doubleOversamplers;
+    int oversamplingIndex = 0;                           // Active factor is 2^oversamplingIndex
+    int oversamplingFilterIndex = 0;
+    int numOversampledChannels = 0;
+    double renderSampleRate = 44100.0;
+
+    // Delays the output of factors with less filter latency than the reported latency
+    // (host rate, sized in prepare for the processing precision)
+    using LatencyPad = juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None>;
+    using DoubleLatencyPad = juce::dsp::DelayLine<double, juce::dsp::DelayLineInterpolationTypes::None>;
+    LatencyPad floatLatencyPad;
+    DoubleLatencyPad doubleLatencyPad;
+    int latencyPadSamples = 0;
+    float getOversamplerLatency(int filterIndex, int factorIndex) const;
+    template <typename SampleType>
+    void applyLatencyPad(juce::AudioBuffer<SampleType>& buffer, int numChannels);
+
+    // Apply live / offline / governor config, factor and filter changes at a block boundary
+    void updateEngineConfig();
+    void setRenderRate(int newOversamplingIndex);
+    template <typename SampleType>
+    juce::dsp::Oversampling<SampleType>* getActiveOversampler();
+    template <typename SampleType>
+    void renderBlock(juce::AudioBuffer<SampleType>& buffer, const juce::MidiBuffer& midiMessages, int oversamplingFactor);
+
+    std::array<SampleVoice, MAX_VOICES> sampleVoices;
+    juce::uint64 voiceAllocationCounter = 0; // For tracking voice allocation order
+
+    // Glide state for monophonic mode
+    float lastMonophonicPitch = 0.0f;     // Last pitch used in monophonic mode
+    bool hasLastPitch = false;            // Whether we have a previous pitch to glide from
+
+    // Held keys in press order (legato falls back to the previous key on release)
+    std::array<int, 128> heldNotes {};
+    int numHeldNotes = 0;
+    void pushHeldNote(int noteNumber);
+    void removeHeldNote(int noteNumber);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GliderEngine)
+};
@@ -0,0 +1,155 @@
+#include "Instrumentation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace
+{
+    template <size_t NumBuckets>
+    void subtractCounts(std::array<std::uint64_t, NumBuckets>& counts, const std::array<std::uint64_t, NumBuckets>& earlier)
+    {
+        for (size_t i = 0; i < NumBuckets; ++i)
+            counts[i] = counts[i] >= earlier[i] ? counts[i] - earlier[i] : 0;
+    }
+
+    template <size_t NumBuckets>
+    void writeCounts(std::ostringstream& stream, const char* name, const std::array<std::uint64_t, NumBuckets>& counts)
+    {
+        stream << "  \"" << name << "\": [";
+        for (size_t i = 0; i < NumBuckets; ++i)
+            stream << (i > 0 ? ", " : "") << counts[i];
+        stream << "]";
+    }
+
+    int clampBucket(long bucket, int numBuckets)
+    {
+        return static_cast<int>(std::clamp(bucket, 0L, static_cast<long>(numBuckets - 1)));
+    }
+}
+
+void Instrumentation::addSegment(double seconds)
+{
+    increment(segments);
+    increment(segmentTime[static_cast<size_t>(getTimeBucket(seconds))]);
+}
+
+void Instrumentation::addBlock(double seconds, double deadlineSeconds, int numEvents, int numActiveVoices)
+{
+    increment(blocks);
+    increment(events, static_cast<std::uint64_t>(std::max(numEvents, 0)));
+    increment(blockTime[static_cast<size_t>(getTimeBucket(seconds))]);
+    increment(eventsPerBlock[static_cast<size_t>(clampBucket(numEvents, NUM_EVENT_BUCKETS))]);
+    increment(activeVoices[static_cast<size_t>(clampBucket(numActiveVoices, NUM_VOICE_BUCKETS))]);
+
+    if (deadlineSeconds <= 0.0)
+        return;
+
+    const double load = seconds / deadlineSeconds;
+    increment(realtimeBlocks);
+    increment(blockLoad[static_cast<size_t>(clampBucket(static_cast<long>(load * 100.0) / LOAD_BUCKET_PERCENT, NUM_LOAD_BUCKETS))]);
+    lastLoad.store(static_cast<float>(load), std::memory_order_relaxed);
+
+    if (seconds > deadlineSeconds)
+        increment(overruns);
+}
+
+void Instrumentation::setQualityTier(CpuGovernor::QualityTier tier)
+{
+    const int tierIndex = static_cast<int>(tier);
+    if (tierIndex == qualityTier.load(std::memory_order_relaxed))
+        return;
+
+    qualityTier.store(tierIndex, std::memory_order_relaxed);
+    increment(tierChanges);
+}
+
+Instrumentation::Snapshot Instrumentation::getSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.blocks = blocks.load(std::memory_order_relaxed);
+    snapshot.realtimeBlocks = realtimeBlocks.load(std::memory_order_relaxed);
+    snapshot.overruns = overruns.load(std::memory_order_relaxed);
+    snapshot.segments = segments.load(std::memory_order_relaxed);
+    snapshot.events = events.load(std::memory_order_relaxed);
+    snapshot.lastLoad = lastLoad.load(std::memory_order_relaxed);
+    snapshot.qualityTier = static_cast<CpuGovernor::QualityTier>(qualityTier.load(std::memory_order_relaxed));
+    snapshot.tierChanges = tierChanges.load(std::memory_order_relaxed);
+
+    copyCounts(blockTime, snapshot.blockTime);
+    copyCounts(segmentTime, snapshot.segmentTime);
+    copyCounts(blockLoad, snapshot.blockLoad);
+    copyCounts(eventsPerBlock, snapshot.eventsPerBlock);
+    copyCounts(activeVoices, snapshot.activeVoices);
+    return snapshot;
+}
+
+int Instrumentation::getTimeBucket(double seconds)
+{
+    const double microseconds = seconds * 1.0e6;
+    if (!(microseconds >= 1.0))
+        return 0;
+
+    return clampBucket(std::ilogb(microseconds) + 1L, NUM_TIME_BUCKETS);
+}
+
+double Instrumentation::getTimeBucketLowerBoundMicroseconds(int bucket)
+{
+    return bucket <= 0 ? 0.0 : std::ldexp(1.0, bucket - 1);
+}
+
+Instrumentation::Snapshot Instrumentation::Snapshot::since(const Snapshot& earlier) const
+{
+    Snapshot window = *this;
+    window.blocks -= std::min(blocks, earlier.blocks);
+    window.realtimeBlocks -= std::min(realtimeBlocks, earlier.realtimeBlocks);
+    window.overruns -= std::min(overruns, earlier.overruns);
+    window.segments -= std::min(segments, earlier.segments);
+    window.events -= std::min(events, earlier.events);
+    window.tierChanges -= std::min(tierChanges, earlier.tierChanges);
+
+    subtractCounts(window.blockTime, earlier.blockTime);
+    subtractCounts(window.segmentTime, earlier.segmentTime);
+    subtractCounts(window.blockLoad, earlier.blockLoad);
+    subtractCounts(window.eventsPerBlock, earlier.eventsPerBlock);
+    subtractCounts(window.activeVoices, earlier.activeVoices);
+    return window;
+}
+
+float Instrumentation::Snapshot::getPeakLoad() const
+{
+    for (int bucket = NUM_LOAD_BUCKETS - 1; bucket >= 0; --bucket)
+        if (blockLoad[static_cast<size_t>(bucket)] > 0)
+            return static_cast<float>((bucket + 1) * LOAD_BUCKET_PERCENT) / 100.0f;
+
+    return 0.0f;
+}
+
+std::string Instrumentation::Snapshot::toJson() const
+{
+    std::ostringstream stream;
+    stream << "{\n"
+           << "  \"blocks\": " << blocks << ",\n"
+           << "  \"realtimeBlocks\": " << realtimeBlocks << ",\n"
+           << "  \"overruns\": " << overruns << ",\n"
+           << "  \"segments\": " << segments << ",\n"
+           << "  \"events\": " << events << ",\n"
+           << "  \"lastLoad\": " << lastLoad << ",\n"
+           << "  \"qualityTier\": \"" << CpuGovernor::getTierName(qualityTier) << "\",\n"
+           << "  \"qualityTierIndex\": " << static_cast<int>(qualityTier) << ",\n"
+           << "  \"tierChanges\": " << tierChanges << ",\n"
+           << "  \"timeBucketsMicroseconds\": \"log2, bucket 0 < 1 us, bucket n >= 2^(n-1) us\",\n"
+           << "  \"loadBucketPercent\": " << LOAD_BUCKET_PERCENT << ",\n";
+
+    writeCounts(stream, "blockTime", blockTime);
+    stream << ",\n";
+    writeCounts(stream, "segmentTime", segmentTime);
+    stream << ",\n";
+    writeCounts(stream, "blockLoad", blockLoad);
+    stream << ",\n";
+    writeCounts(stream, "eventsPerBlock", eventsPerBlock);
+    stream << ",\n";
+    writeCounts(stream, "activeVoices", activeVoices);
+    stream << "\n}\n";
+    return stream.str();
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include "CpuGovernor.h"
+
+// Lock-free hot-path statistics: per-block wall time and load, time per MIDI-split
+// segment, events per block, active voices and deadline overruns, counted into
+// fixed-bucket histograms, plus the CPU governor's quality tier and its changes.
+//
+// The audio thread is the only writer and never allocates, locks or uses
+// read-modify-write atomics (a plain relaxed load + store per counter). Any thread
+// may take a Snapshot; counters only grow, so the difference of two snapshots
+// (Snapshot::since) gives the statistics for the interval between them. A
+// snapshot taken while a block is being recorded may be off by that block.
+class Instrumentation
+{
+public:
+    static constexpr int NUM_TIME_BUCKETS = 24;     // log2 microseconds: [0, 1), [1, 2), [2, 4) ... 2^22 and up
+    static constexpr int NUM_LOAD_BUCKETS = 32;     // 5% of the deadline each, the last holds 155% and up
+    static constexpr int LOAD_BUCKET_PERCENT = 5;
+    static constexpr int NUM_EVENT_BUCKETS = 33;    // 0 - 31 MIDI events, the last holds 32 and up
+    static constexpr int NUM_VOICE_BUCKETS = 65;    // 0 - 64 active voices
+
+    template <size_t NumBuckets>
+    using Counts = std::array<std::uint64_t, NumBuckets>;
+
+    struct Snapshot
+    {
+        std::uint64_t blocks = 0;
+        std::uint64_t realtimeBlocks = 0;           // Blocks with a deadline (live playback)
+        std::uint64_t overruns = 0;                 // Realtime blocks that took longer than their deadline
+        std::uint64_t segments = 0;
+        std::uint64_t events = 0;
+        float lastLoad = 0.0f;                      // Most recent realtime block, fraction of the deadline
+        CpuGovernor::QualityTier qualityTier = CpuGovernor::QualityTier::Full;  // Tier after the most recent block
+        std::uint64_t tierChanges = 0;              // CPU governor steps, down or up
+
+        Counts<NUM_TIME_BUCKETS> blockTime {};
+        Counts<NUM_TIME_BUCKETS> segmentTime {};
+        Counts<NUM_LOAD_BUCKETS> blockLoad {};
+        Counts<NUM_EVENT_BUCKETS> eventsPerBlock {};
+        Counts<NUM_VOICE_BUCKETS> activeVoices {};
+
+        // Statistics accumulated since an earlier snapshot
+        Snapshot since(const Snapshot& earlier) const;
+
+        // Upper bound of the highest non-empty load bucket (fraction of the deadline), 0 when empty
+        float getPeakLoad() const;
+
+        // JSON document with all counters and histograms
+        std::string toJson() const;
+    };
+
+    // Audio thread - one call per rendered segment
+    void addSegment(double seconds);
+
+    // Audio thread - one call per block. deadlineSeconds <= 0 (offline render) records
+    // the time, events and voices but no load or overrun.
+    void addBlock(double seconds, double deadlineSeconds, int numEvents, int numActiveVoices);
+
+    // Audio thread - the governor's tier after each block; a different tier counts as a change
+    void setQualityTier(CpuGovernor::QualityTier tier);
+
+    // Any thread
+    Snapshot getSnapshot() const;
+
+    static int getTimeBucket(double seconds);
+    static double getTimeBucketLowerBoundMicroseconds(int bucket);
+
+private:
+    template <size_t NumBuckets>
+    using AtomicCounts = std::array<std::atomic<std::uint64_t>, NumBuckets>;
+
+    // Single writer: no read-modify-write needed
+    static void increment(std::atomic<std::uint64_t>& counter, std::uint64_t amount = 1)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    template <size_t NumBuckets>
+    static void copyCounts(const AtomicCounts<NumBuckets>& source, Counts<NumBuckets>& destination)
+    {
+        for (size_t i = 0; i < source.size(); ++i)
+            destination[i] = source[i].load(std::memory_order_relaxed);
+    }
+
+    std::atomic<std::uint64_t> blocks { 0 };
+    std::atomic<std::uint64_t> realtimeBlocks { 0 };
+    std::atomic<std::uint64_t> overruns { 0 };
+    std::atomic<std::uint64_t> segments { 0 };
+    std::atomic<std::uint64_t> events { 0 };
+    std::atomic<float> lastLoad { 0.0f };
+    std::atomic<int> qualityTier { 0 };
+    std::atomic<std::uint64_t> tierChanges { 0 };
+
+    AtomicCounts<NUM_TIME_BUCKETS> blockTime {};
+    AtomicCounts<NUM_TIME_BUCKETS> segmentTime {};
+    AtomicCounts<NUM_LOAD_BUCKETS> blockLoad {};
+    AtomicCounts<NUM_EVENT_BUCKETS> eventsPerBlock {};
+    AtomicCounts<NUM_VOICE_BUCKETS> activeVoices {};
+};
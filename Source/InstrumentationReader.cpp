@@ -0,0 +1,76 @@
+#include "InstrumentationReader.h"
+
+InstrumentationReader::InstrumentationReader(const Instrumentation& source)
+    : juce::Thread("Eskilator Instrumentation"),
+      instrumentation(source)
+{
+}
+
+InstrumentationReader::~InstrumentationReader()
+{
+    stop();
+}
+
+void InstrumentationReader::start()
+{
+    if (isThreadRunning())
+        return;
+
+    {
+        const juce::ScopedLock scopedLock(lock);
+        baseline = instrumentation.getSnapshot();
+        previous = baseline;
+        latestWindow = {};
+    }
+
+    startThread();
+}
+
+void InstrumentationReader::stop()
+{
+    stopThread(READ_INTERVAL_MS * 4);
+}
+
+Instrumentation::Snapshot InstrumentationReader::getLatestWindow() const
+{
+    const juce::ScopedLock scopedLock(lock);
+    return latestWindow;
+}
+
+Instrumentation::Snapshot InstrumentationReader::getTotals() const
+{
+    const auto current = instrumentation.getSnapshot();
+    const juce::ScopedLock scopedLock(lock);
+    return current.since(baseline);
+}
+
+bool InstrumentationReader::writeReport(const juce::File& file) const
+{
+    const auto totals = getTotals();
+    const auto window = getLatestWindow();
+
+    juce::String report;
+    report << "{\n\"intervalMs\": " << READ_INTERVAL_MS << ",\n"
+           << "\"totals\": " << juce::String(totals.toJson()) << ",\n"
+           << "\"latestInterval\": " << juce::String(window.toJson()) << "}\n";
+
+    return file.replaceWithText(report);
+}
+
+void InstrumentationReader::run()
+{
+    while (!threadShouldExit())
+    {
+        read();
+        wait(READ_INTERVAL_MS);
+    }
+}
+
+void InstrumentationReader::read()
+{
+    const auto current = instrumentation.getSnapshot();
+
+    const juce::ScopedLock scopedLock(lock);
+    latestWindow = current.since(previous);
+    previous = current;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "Instrumentation.h"
+
+// Background reader for the audio thread's Instrumentation. Takes a snapshot every
+// READ_INTERVAL_MS and keeps the statistics of the latest interval for the editor's
+// CPU meter; reports with the running totals can be written to a file at any time.
+// Never touches the audio thread beyond reading its atomics.
+class InstrumentationReader : private juce::Thread
+{
+public:
+    static constexpr int READ_INTERVAL_MS = 250;
+
+    explicit InstrumentationReader(const Instrumentation& source);
+    ~InstrumentationReader() override;
+
+    void start();
+    void stop();
+
+    // Statistics for the most recent read interval / since the reader started
+    Instrumentation::Snapshot getLatestWindow() const;
+    Instrumentation::Snapshot getTotals() const;
+
+    // JSON report with the totals and the latest interval
+    bool writeReport(const juce::File& file) const;
+
+private:
+    void run() override;
+    void read();
+
+    const Instrumentation& instrumentation;
+
+    // Guards the snapshots between the reader thread and the message thread (never the audio thread)
+    mutable juce::CriticalSection lock;
+    Instrumentation::Snapshot baseline;
+    Instrumentation::Snapshot previous;
+    Instrumentation::Snapshot latestWindow;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(InstrumentationReader)
+};
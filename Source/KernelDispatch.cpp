@@ -0,0 +1,177 @@
+#include "KernelDispatch.h"
+
+#include <cstdlib>
+#include <initializer_list>
+
+#if ESKILATOR_X86_KERNELS && defined (_MSC_VER)
+ #include <intrin.h>
+ #include <immintrin.h>
+#endif
+
+namespace
+{
+    struct CpuFeatures
+    {
+        bool avx2 = false;
+        bool avx512 = false;    // AVX-512 F + VL
+    };
+
+    CpuFeatures queryCpuFeatures()
+    {
+        CpuFeatures features;
+
+#if ESKILATOR_X86_KERNELS
+ #if defined (_MSC_VER)
+        int info[4] = {};
+        __cpuid(info, 0);
+        const int maxLeaf = info[0];
+
+        __cpuid(info, 1);
+        const bool osUsesXsave = (info[2] & (1 << 27)) != 0;
+        const bool hasAvx = (info[2] & (1 << 28)) != 0;
+        if (maxLeaf < 7 || !osUsesXsave || !hasAvx)
+            return features;
+
+        // The OS must save the YMM (and for AVX-512 the opmask/ZMM) state on context switches
+        const unsigned long long enabledState = _xgetbv(0);
+        const bool ymmEnabled = (enabledState & 0x6) == 0x6;
+        const bool zmmEnabled = (enabledState & 0xe6) == 0xe6;
+
+        __cpuidex(info, 7, 0);
+        features.avx2 = ymmEnabled && (info[1] & (1 << 5)) != 0;
+        features.avx512 = zmmEnabled && (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 31)) != 0;
+ #else
+        // Also checks that the OS has enabled the extended register state
+        __builtin_cpu_init();
+        features.avx2 = __builtin_cpu_supports("avx2") != 0;
+        features.avx512 = __builtin_cpu_supports("avx512f") != 0 && __builtin_cpu_supports("avx512vl") != 0;
+ #endif
+#endif
+
+        return features;
+    }
+
+    const CpuFeatures& getCpuFeatures()
+    {
+        static const CpuFeatures features = queryCpuFeatures();
+        return features;
+    }
+
+    constexpr KernelDispatch::InstructionSet getBaselineInstructionSet()
+    {
+#if defined (__x86_64__) || defined (_M_X64)
+        return KernelDispatch::InstructionSet::SSE2;
+#elif defined (__aarch64__) || defined (_M_ARM64)
+        return KernelDispatch::InstructionSet::NEON;
+#else
+        return KernelDispatch::InstructionSet::Generic;
+#endif
+    }
+
+    KernelDispatch::InstructionSet getEnvironmentOverride()
+    {
+        using KernelDispatch::InstructionSet;
+
+        const char* value = std::getenv("ESKILATOR_KERNEL_ISA");
+        if (value == nullptr)
+            return InstructionSet::Auto;
+
+        for (auto instructionSet : { InstructionSet::Generic, InstructionSet::SSE2, InstructionSet::AVX2,
+                                     InstructionSet::AVX512, InstructionSet::NEON })
+        {
+            // Names are matched case-insensitively ("avx2", "AVX2")
+            const char* name = KernelDispatch::getName(instructionSet);
+            size_t i = 0;
+            while (name[i] != '\0' && value[i] != '\0'
+                   && (name[i] == value[i] || (value[i] >= 'a' && value[i] <= 'z' && name[i] == value[i] - 'a' + 'A')))
+                ++i;
+
+            if (name[i] == '\0' && value[i] == '\0')
+                return instructionSet;
+        }
+
+        return InstructionSet::Auto;
+    }
+
+    const KernelDispatch::KernelTable& getKernelsFor(KernelDispatch::InstructionSet instructionSet)
+    {
+#if ESKILATOR_X86_KERNELS
+        if (instructionSet == KernelDispatch::InstructionSet::AVX512)
+            return KernelDispatch::getAVX512Kernels();
+        if (instructionSet == KernelDispatch::InstructionSet::AVX2)
+            return KernelDispatch::getAVX2Kernels();
+#endif
+        (void) instructionSet;
+        return KernelDispatch::getBaselineKernels();
+    }
+}
+
+namespace KernelDispatch
+{
+    RenderKernels::KernelFunction KernelTable::getVoiceKernel(int sourceChannels, int outputChannels,
+                                                              bool crossfade, bool gliding, bool morph) const
+    {
+        if (sourceChannels < 1 || outputChannels < 1 || outputChannels > RenderKernels::MAX_CHANNELS)
+            return nullptr;
+
+        return voiceKernels[sourceChannels >= 2 ? 1 : 0][outputChannels - 1][crossfade ? 1 : 0][gliding ? 1 : 0][morph ? 1 : 0];
+    }
+
+    bool isAvailable(InstructionSet instructionSet)
+    {
+        switch (instructionSet)
+        {
+            case InstructionSet::Auto:
+                return true;
+            case InstructionSet::AVX2:
+                return ESKILATOR_X86_KERNELS && getCpuFeatures().avx2;
+            case InstructionSet::AVX512:
+                return ESKILATOR_X86_KERNELS && getCpuFeatures().avx512;
+            case InstructionSet::Generic:
+            case InstructionSet::SSE2:
+            case InstructionSet::NEON:
+            default:
+                return instructionSet == getBaselineInstructionSet();
+        }
+    }
+
+    InstructionSet detectInstructionSet()
+    {
+        if (isAvailable(InstructionSet::AVX512))
+            return InstructionSet::AVX512;
+
+        if (isAvailable(InstructionSet::AVX2))
+            return InstructionSet::AVX2;
+
+        return getBaselineInstructionSet();
+    }
+
+    const KernelTable& selectKernels(InstructionSet requested)
+    {
+        if (requested == InstructionSet::Auto)
+            requested = getEnvironmentOverride();
+
+        // "generic" always means the baseline build, whatever the architecture calls it
+        if (requested == InstructionSet::Generic)
+            requested = getBaselineInstructionSet();
+
+        if (requested != InstructionSet::Auto && isAvailable(requested))
+            return getKernelsFor(requested);
+
+        return getKernelsFor(detectInstructionSet());
+    }
+
+    const char* getName(InstructionSet instructionSet)
+    {
+        switch (instructionSet)
+        {
+            case InstructionSet::Auto:      return "AUTO";
+            case InstructionSet::Generic:   return "GENERIC";
+            case InstructionSet::SSE2:      return "SSE2";
+            case InstructionSet::AVX2:      return "AVX2";
+            case InstructionSet::AVX512:    return "AVX512";
+            case InstructionSet::NEON:      return "NEON";
+            default:                        return "UNKNOWN";
+        }
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "RenderKernels.h"
+
+// The AVX2 / AVX-512 builds exist when CMake compiled them (ESKILATOR_ENABLE_X86_KERNELS)
+// and this slice of the binary targets x86-64 (universal macOS builds also have an arm64 slice)
+#if defined (ESKILATOR_ENABLE_X86_KERNELS) && (defined (__x86_64__) || defined (_M_X64))
+ #define ESKILATOR_X86_KERNELS 1
+#else
+ #define ESKILATOR_X86_KERNELS 0
+#endif
+
+// Runtime CPU-feature dispatch for the sample render and import kernels.
+// The kernels in KernelTableImpl.h are compiled once per instruction set
+// (KernelsBaseline.cpp, KernelsAVX2.cpp, KernelsAVX512.cpp, each with its own
+// compile flags - see CMakeLists.txt) and selectKernels() picks the best table
+// the running CPU supports. The baseline table is SSE2 on x86-64 and NEON on
+// arm64, both of which are part of the base architecture.
+//
+// Kernel translation units must stay free of standard library containers and
+// JUCE: anything inline they instantiate would otherwise be emitted with the
+// wider instruction set and could be picked by the linker for baseline callers.
+// The reverse holds too: other code calls the floating-point kernels only through
+// a table, so the one definition of each is the kernel build's (-ffp-contract=off).
+namespace KernelDispatch
+{
+    enum class InstructionSet
+    {
+        Auto = 0,   // Best available (override value only)
+        Generic,    // Portable baseline build on other architectures
+        SSE2,
+        AVX2,
+        AVX512,
+        NEON
+    };
+
+    using EnvelopeGainFunction = void (*)(float* destination, const float* envelope, float gain, int numSamples);
+    using ResampleFunction = void (*)(const float* source, int sourceLength, float* destination,
+                                      int destinationLength, double sourceStep);
+    using PeakFunction = float (*)(const float* source, int numSamples);
+    using DifferencePeakFunction = float (*)(const float* source, const float* other, int numSamples);
+    using SumsFunction = void (*)(const float* source, int numSamples, double* sum, double* sumOfSquares);
+    using OffsetFunction = void (*)(float* destination, float offset, int numSamples);
+    using GenericVoiceFunction = void (*)(const RenderKernels::Source& source, float* const* outputs, int numOutputChannels,
+                                          int numFrames, const float* frameGains, RenderKernels::VoiceState& state,
+                                          bool isCrossfading, bool isGliding, const RenderKernels::CrossfadeTable& crossfade);
+    using SincVoiceFunction = void (*)(const RenderKernels::Source& source, float* const* outputs, int numOutputChannels,
+                                       int numFrames, const float* frameGains, RenderKernels::VoiceState& state,
+                                       bool isCrossfading, bool isGliding, const RenderKernels::CrossfadeTable& crossfade,
+                                       const RenderKernels::SincTable& sinc);
+
+    // Kept trivial (no default member initialisers) so the per-ISA translation
+    // units never emit an inline constructor compiled with their flags
+    struct KernelTable
+    {
+        InstructionSet instructionSet;
+
+        // Sample voice kernels: [stereo source][stereo output][crossfade][gliding][morph]
+        RenderKernels::KernelFunction voiceKernels[2][2][2][2][2];
+
+        // RenderKernels::renderVoiceGeneric (layouts without a specialisation, single
+        // frames) and RenderKernels::renderVoiceSinc
+        GenericVoiceFunction renderVoiceGeneric;
+        SincVoiceFunction renderVoiceSinc;
+
+        // destination[i] = envelope[i] * gain (destination may be the envelope itself)
+        EnvelopeGainFunction applyEnvelopeGain;
+
+        // Linear-interpolation resampler used at import (silence past the source end)
+        ResampleFunction resampleLinear;
+
+        // Import analysis (SampleConditioning): largest |source[i]|, largest
+        // |source[i] - other[i]|, the sum and sum of squares, and destination[i] += offset
+        PeakFunction findPeak;
+        DifferencePeakFunction findDifferencePeak;
+        SumsFunction findSums;
+        OffsetFunction addOffset;
+
+        // Same contract as RenderKernels::getKernel - nullptr means use renderVoiceGeneric
+        RenderKernels::KernelFunction getVoiceKernel(int sourceChannels, int outputChannels,
+                                                     bool crossfade, bool gliding, bool morph = false) const;
+    };
+
+    // Whether the running CPU (and this build) can use an instruction set
+    bool isAvailable(InstructionSet instructionSet);
+
+    // Best instruction set supported by the running CPU
+    InstructionSet detectInstructionSet();
+
+    // Kernel table for the requested set, falling back to the best available one
+    // when the request is Auto or unsupported. Auto also honours the
+    // ESKILATOR_KERNEL_ISA environment variable (generic/sse2/avx2/avx512/neon),
+    // which is meant for testing and benchmarking on a single machine.
+    const KernelTable& selectKernels(InstructionSet requested = InstructionSet::Auto);
+
+    const char* getName(InstructionSet instructionSet);
+
+    // Per instruction-set tables (defined in the Kernels*.cpp translation units)
+    const KernelTable& getBaselineKernels();
+#if ESKILATOR_X86_KERNELS
+    const KernelTable& getAVX2Kernels();
+    const KernelTable& getAVX512Kernels();
+#endif
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+// Kernel bodies shared by the per instruction-set translation units.
+// Include exactly once from a Kernels*.cpp file, after defining ESKILATOR_KERNEL_ISA
+// so the inline kernels from RenderKernels.h get symbols of their own.
+#ifndef ESKILATOR_KERNEL_ISA
+ #error "Define ESKILATOR_KERNEL_ISA before including KernelTableImpl.h"
+#endif
+
+#include "KernelDispatch.h"
+
+namespace
+{
+    void applyEnvelopeGain(float* destination, const float* envelope, float gain, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            destination[i] = envelope[i] * gain;
+    }
+
+    void resampleLinear(const float* source, int sourceLength, float* destination, int destinationLength, double sourceStep)
+    {
+        // Frames whose two-point read stays inside the source are interpolated in a
+        // branch-free loop; the tail (last source sample, then silence) is handled after
+        int interpolated = 0;
+        if (sourceLength > 1 && sourceStep > 0.0)
+        {
+            const double framesInside = static_cast<double>(sourceLength - 1) / sourceStep;
+            interpolated = framesInside < static_cast<double>(destinationLength) ? static_cast<int>(framesInside) + 1 : destinationLength;
+
+            // Rounding can put the last candidate on (sourceLength - 1)
+            while (interpolated > 0 && static_cast<int>(static_cast<double>(interpolated - 1) * sourceStep) >= sourceLength - 1)
+                --interpolated;
+        }
+
+        for (int i = 0; i < interpolated; ++i)
+        {
+            const double position = static_cast<double>(i) * sourceStep;
+            const int index = static_cast<int>(position);
+            const float fraction = static_cast<float>(position - index);
+            const float sample1 = source[index];
+            destination[i] = sample1 + fraction * (source[index + 1] - sample1);
+        }
+
+        for (int i = interpolated; i < destinationLength; ++i)
+        {
+            const int index = static_cast<int>(static_cast<double>(i) * sourceStep);
+            destination[i] = index < sourceLength ? source[index] : 0.0f;
+        }
+    }
+
+    // Reductions keep this many independent partial results, one vector's worth or more,
+    // so the compiler can vectorise them without reassociating a single accumulator
+    constexpr int REDUCTION_LANES = 16;
+
+    inline float magnitude(float value)
+    {
+        return value < 0.0f ? -value : value;
+    }
+
+    float findPeak(const float* source, int numSamples)
+    {
+        float lanes[REDUCTION_LANES] = {};
+        int i = 0;
+        for (; i + REDUCTION_LANES <= numSamples; i += REDUCTION_LANES)
+            for (int lane = 0; lane < REDUCTION_LANES; ++lane)
+            {
+                const float value = magnitude(source[i + lane]);
+                lanes[lane] = value > lanes[lane] ? value : lanes[lane];
+            }
+
+        for (; i < numSamples; ++i)
+        {
+            const float value = magnitude(source[i]);
+            lanes[0] = value > lanes[0] ? value : lanes[0];
+        }
+
+        float peak = 0.0f;
+        for (float lane : lanes)
+            peak = lane > peak ? lane : peak;
+        return peak;
+    }
+
+    float findDifferencePeak(const float* source, const float* other, int numSamples)
+    {
+        float lanes[REDUCTION_LANES] = {};
+        int i = 0;
+        for (; i + REDUCTION_LANES <= numSamples; i += REDUCTION_LANES)
+            for (int lane = 0; lane < REDUCTION_LANES; ++lane)
+            {
+                const float value = magnitude(source[i + lane] - other[i + lane]);
+                lanes[lane] = value > lanes[lane] ? value : lanes[lane];
+            }
+
+        for (; i < numSamples; ++i)
+        {
+            const float value = magnitude(source[i] - other[i]);
+            lanes[0] = value > lanes[0] ? value : lanes[0];
+        }
+
+        float peak = 0.0f;
+        for (float lane : lanes)
+            peak = lane > peak ? lane : peak;
+        return peak;
+    }
+
+    void findSums(const float* source, int numSamples, double* sum, double* sumOfSquares)
+    {
+        // Float partial sums are flushed to double every block, which bounds their rounding error
+        constexpr int BLOCK_SIZE = 4096;
+        double total = 0.0;
+        double totalOfSquares = 0.0;
+
+        for (int blockStart = 0; blockStart < numSamples; blockStart += BLOCK_SIZE)
+        {
+            const int blockEnd = numSamples - blockStart < BLOCK_SIZE ? numSamples : blockStart + BLOCK_SIZE;
+            float lanes[REDUCTION_LANES] = {};
+            float squareLanes[REDUCTION_LANES] = {};
+
+            int i = blockStart;
+            for (; i + REDUCTION_LANES <= blockEnd; i += REDUCTION_LANES)
+                for (int lane = 0; lane < REDUCTION_LANES; ++lane)
+                {
+                    const float value = source[i + lane];
+                    lanes[lane] += value;
+                    squareLanes[lane] += value * value;
+                }
+
+            for (; i < blockEnd; ++i)
+            {
+                lanes[0] += source[i];
+                squareLanes[0] += source[i] * source[i];
+            }
+
+            for (int lane = 0; lane < REDUCTION_LANES; ++lane)
+            {
+                total += lanes[lane];
+                totalOfSquares += squareLanes[lane];
+            }
+        }
+
+        *sum = total;
+        *sumOfSquares = totalOfSquares;
+    }
+
+    void addOffset(float* destination, float offset, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            destination[i] += offset;
+    }
+
+    KernelDispatch::KernelTable makeKernelTable(KernelDispatch::InstructionSet instructionSet)
+    {
+        KernelDispatch::KernelTable table {};
+        table.instructionSet = instructionSet;
+
+        for (int stereoSource = 0; stereoSource < 2; ++stereoSource)
+            for (int stereoOutput = 0; stereoOutput < 2; ++stereoOutput)
+                for (int crossfade = 0; crossfade < 2; ++crossfade)
+                    for (int gliding = 0; gliding < 2; ++gliding)
+                        for (int morph = 0; morph < 2; ++morph)
+                            table.voiceKernels[stereoSource][stereoOutput][crossfade][gliding][morph]
+                                = RenderKernels::getKernel(stereoSource + 1, stereoOutput + 1, crossfade != 0, gliding != 0, morph != 0);
+
+        table.renderVoiceGeneric = &RenderKernels::renderVoiceGeneric;
+        table.renderVoiceSinc = &RenderKernels::renderVoiceSinc;
+        table.applyEnvelopeGain = &applyEnvelopeGain;
+        table.resampleLinear = &resampleLinear;
+        table.findPeak = &findPeak;
+        table.findDifferencePeak = &findDifferencePeak;
+        table.findSums = &findSums;
+        table.addOffset = &addOffset;
+        return table;
+    }
+}
@@ -0,0 +1,15 @@
+// AVX2 kernel build, compiled with -mavx2 (/arch:AVX2 on MSVC) - see CMakeLists.txt. No FMA:
+// like every kernel build it uses -ffp-contract=off, so all instruction sets render bit-identical output.
+// Only selected at runtime when KernelDispatch::isAvailable() reports CPU support.
+#define ESKILATOR_KERNEL_ISA AVX2
+#include "KernelDispatch.h"
+
+#if ESKILATOR_X86_KERNELS
+#include "KernelTableImpl.h"
+
+const KernelDispatch::KernelTable& KernelDispatch::getAVX2Kernels()
+{
+    static const KernelTable table = makeKernelTable(InstructionSet::AVX2);
+    return table;
+}
+#endif
@@ -0,0 +1,14 @@
+// AVX512 kernel build, compiled with -mavx512f -mavx512vl (/arch:AVX512 on MSVC) - see CMakeLists.txt.
+// Only selected at runtime when KernelDispatch::isAvailable() reports CPU support.
+#define ESKILATOR_KERNEL_ISA AVX512
+#include "KernelDispatch.h"
+
+#if ESKILATOR_X86_KERNELS
+#include "KernelTableImpl.h"
+
+const KernelDispatch::KernelTable& KernelDispatch::getAVX512Kernels()
+{
+    static const KernelTable table = makeKernelTable(InstructionSet::AVX512);
+    return table;
+}
+#endif
@@ -0,0 +1,15 @@
+// Baseline kernel build (no extra compile flags): SSE2 on x86-64, NEON on arm64
+#define ESKILATOR_KERNEL_ISA Baseline
+#include "KernelTableImpl.h"
+
+const KernelDispatch::KernelTable& KernelDispatch::getBaselineKernels()
+{
+#if defined (__x86_64__) || defined (_M_X64)
+    static const KernelTable table = makeKernelTable(InstructionSet::SSE2);
+#elif defined (__aarch64__) || defined (_M_ARM64)
+    static const KernelTable table = makeKernelTable(InstructionSet::NEON);
+#else
+    static const KernelTable table = makeKernelTable(InstructionSet::Generic);
+#endif
+    return table;
+}
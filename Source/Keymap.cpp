@@ -0,0 +1,101 @@
+#include "Keymap.h"
+
+#include <algorithm>
+#include <map>
+
+SampleMapping SampleMapping::getValidated() const
+{
+    auto clampMidi = [](int value) { return std::clamp(value, 0, 127); };
+
+    SampleMapping validated;
+    validated.rootNote = clampMidi(rootNote);
+    validated.lowNote = std::min(clampMidi(lowNote), clampMidi(highNote));
+    validated.highNote = std::max(clampMidi(lowNote), clampMidi(highNote));
+    validated.lowVelocity = std::min(clampMidi(lowVelocity), clampMidi(highVelocity));
+    validated.highVelocity = std::max(clampMidi(lowVelocity), clampMidi(highVelocity));
+    validated.roundRobinGroup = std::clamp(roundRobinGroup, 0, MAX_ROUND_ROBIN_GROUPS);
+    return validated;
+}
+
+bool SampleMapping::operator==(const SampleMapping& other) const
+{
+    return rootNote == other.rootNote && lowNote == other.lowNote && highNote == other.highNote
+           && lowVelocity == other.lowVelocity && highVelocity == other.highVelocity
+           && roundRobinGroup == other.roundRobinGroup;
+}
+
+Keymap::Keymap(const std::vector<SampleMapping>& mappings)
+{
+    // Cells covered by the same samples share one choice list
+    std::map<std::vector<int>, std::uint16_t> listsBySamples;
+    std::vector<int> covering;
+    covering.reserve(mappings.size());
+
+    for (int note = 0; note < NUM_NOTES; ++note)
+    {
+        for (int velocity = 0; velocity < NUM_VELOCITIES; ++velocity)
+        {
+            covering.clear();
+            for (int index = 0; index < static_cast<int>(mappings.size()); ++index)
+            {
+                const auto& mapping = mappings[static_cast<size_t>(index)];
+                if (note >= mapping.lowNote && note <= mapping.highNote
+                    && velocity >= mapping.lowVelocity && velocity <= mapping.highVelocity)
+                    covering.push_back(index);
+            }
+
+            if (covering.empty())
+                continue;
+
+            auto [position, isNew] = listsBySamples.try_emplace(covering, static_cast<std::uint16_t>(lists.size()));
+            cells[static_cast<size_t>(note * NUM_VELOCITIES + velocity)] = position->second;
+            if (!isNew)
+                continue;
+
+            // Samples in bank order; a round-robin group becomes one choice where its first member appears
+            ChoiceList list { static_cast<std::uint32_t>(choices.size()), 0 };
+            std::array<bool, SampleMapping::MAX_ROUND_ROBIN_GROUPS + 1> groupAdded {};
+
+            for (const int index : covering)
+            {
+                const int group = mappings[static_cast<size_t>(index)].roundRobinGroup;
+                if (group > 0 && groupAdded[static_cast<size_t>(group)])
+                    continue;
+
+                Choice choice;
+                choice.firstMember = static_cast<std::uint32_t>(members.size());
+                choice.roundRobinGroup = group;
+
+                if (group > 0)
+                {
+                    groupAdded[static_cast<size_t>(group)] = true;
+                    for (const int member : covering)
+                        if (mappings[static_cast<size_t>(member)].roundRobinGroup == group)
+                            members.push_back(member);
+                }
+                else
+                {
+                    members.push_back(index);
+                }
+
+                choice.numMembers = static_cast<std::uint16_t>(members.size() - choice.firstMember);
+                choices.push_back(choice);
+                ++list.numChoices;
+            }
+
+            lists.push_back(list);
+        }
+    }
+}
+
+Keymap::Choices Keymap::getChoices(int noteNumber, int velocity) const
+{
+    if (noteNumber < 0 || noteNumber >= NUM_NOTES || velocity < 0 || velocity >= NUM_VELOCITIES)
+        return {};
+
+    const auto& list = lists[cells[static_cast<size_t>(noteNumber * NUM_VELOCITIES + velocity)]];
+    if (list.numChoices == 0)
+        return {};
+
+    return { choices.data() + list.firstChoice, list.numChoices };
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Where a sample plays: the key it sounds at its recorded pitch, the keys and
+// velocities it answers, and the round-robin group it alternates in (0 = none)
+struct SampleMapping
+{
+    static constexpr int MAX_ROUND_ROBIN_GROUPS = 16;
+
+    int rootNote = 60;
+    int lowNote = 0;
+    int highNote = 127;
+    int lowVelocity = 0;
+    int highVelocity = 127;
+    int roundRobinGroup = 0;
+
+    // Clamp to MIDI ranges and put the bounds in order
+    SampleMapping getValidated() const;
+
+    bool operator==(const SampleMapping& other) const;
+    bool operator!=(const SampleMapping& other) const { return !(*this == other); }
+};
+
+// Sample mappings compiled into a flat 128 x 128 (note x velocity) table. Each cell
+// points at the choices for that note and velocity: every sample outside a round-robin
+// group is a choice of its own, and the samples of one group that cover the cell share
+// one choice. Built off the audio thread whenever the bank changes; lookups are two
+// array reads.
+class Keymap
+{
+public:
+    static constexpr int NUM_NOTES = 128;
+    static constexpr int NUM_VELOCITIES = 128;
+
+    struct Choice
+    {
+        std::uint32_t firstMember = 0;
+        std::uint16_t numMembers = 0;   // Round-robin group size (1 outside a group)
+        int roundRobinGroup = 0;
+    };
+
+    struct Choices
+    {
+        const Choice* first = nullptr;
+        int size = 0;
+
+        const Choice& operator[](int index) const { return first[index]; }
+    };
+
+    Keymap() = default;
+    explicit Keymap(const std::vector<SampleMapping>& mappings);
+
+    // Choices for a note and velocity (size 0 when no sample covers them)
+    Choices getChoices(int noteNumber, int velocity) const;
+
+    // Bank index of a member of a choice
+    int getSampleIndex(const Choice& choice, int member) const { return members[static_cast<size_t>(choice.firstMember + member)]; }
+
+private:
+    struct ChoiceList
+    {
+        std::uint32_t firstChoice = 0;
+        std::uint16_t numChoices = 0;
+    };
+
+    // Choice list per cell; list 0 is the empty one
+    std::array<std::uint16_t, NUM_NOTES * NUM_VELOCITIES> cells {};
+    std::vector<ChoiceList> lists { ChoiceList {} };
+    std::vector<Choice> choices;
+    std::vector<int> members;
+};
@@ -1,7 +1,24 @@
 #include "ParameterManager.h"
 
 ParameterManager::ParameterManager(juce::AudioProcessor& processor)
-    : apvts(processor, nullptr, "Parameters", createParameterLayout())
+    : apvts(processor, nullptr, "Parameters", createParameterLayout()),
+      attack(apvts.getParameter("attack")),
+      decay(apvts.getParameter("decay")),
+      sustain(apvts.getParameter("sustain")),
+      release(apvts.getParameter("release")),
+      sampleGain(apvts.getRawParameterValue("sampleGain")),
+      voiceCount(apvts.getRawParameterValue("voiceCount")),
+      glideTime(apvts.getRawParameterValue("glideTime")),
+      glideSteps(apvts.getRawParameterValue("glideSteps")),
+      glideMode(apvts.getRawParameterValue("glideMode")),
+      glideSlew(apvts.getRawParameterValue("glideSlew")),
+      legato(apvts.getRawParameterValue("legato")),
+      oversampling(apvts.getRawParameterValue("oversampling")),
+      oversamplingFilter(apvts.getRawParameterValue("oversamplingFilter")),
+      interpolation(apvts.getRawParameterValue("interpolation")),
+      transpose(apvts.getRawParameterValue("transpose")),
+      fineTune(apvts.getRawParameterValue("finetune")),
+      sampleChain(apvts.getRawParameterValue("sampleChain"))
 {
 }
 
@@ -56,6 +73,32 @@ juce::AudioProcessorValueTreeState::ParameterLayout ParameterManager::createPara
         GLIDE_STEPS_MIN,
         GLIDE_STEPS_MAX,
         GLIDE_STEPS_DEFAULT));
+    parameters.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "glideMode", "Glide Mode",
+        juce::StringArray { "Stepped", "Linear", "Exponential", "Stepped Slew" },
+        GLIDE_MODE_DEFAULT));
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "glideSlew", "Glide Slew",
+        GLIDE_SLEW_MIN,
+        GLIDE_SLEW_MAX,
+        GLIDE_SLEW_DEFAULT));
+    parameters.push_back(std::make_unique<juce::AudioParameterBool>(
+        "legato", "Legato",
+        LEGATO_DEFAULT));
+
+    // Oversampling (the reported latency is the 4x filter's at every factor)
+    parameters.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "oversampling", "Oversampling",
+        juce::StringArray { "Off", "2x", "4x" },
+        OVERSAMPLING_DEFAULT));
+    parameters.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "oversamplingFilter", "Oversampling Filter",
+        juce::StringArray { "Polyphase IIR", "FIR" },
+        OVERSAMPLING_FILTER_DEFAULT));
+    parameters.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "interpolation", "Interpolation",
+        juce::StringArray { "Linear", "Sinc" },
+        INTERPOLATION_DEFAULT));
 
     // Global transpose parameter using shared constants with discrete steps
     juce::NormalisableRange<float> transposeRange(TRANSPOSE_MIN, TRANSPOSE_MAX, TRANSPOSE_INCREMENT);
@@ -71,82 +114,134 @@ juce::AudioProcessorValueTreeState::ParameterLayout ParameterManager::createPara
         FINETUNE_MAX,
         FINETUNE_DEFAULT));
 
+    // Sample chain (automatable morph across the samples covering the played key)
+    parameters.push_back(std::make_unique<juce::AudioParameterFloat>(
+        "sampleChain", "Sample Chain",
+        SAMPLE_CHAIN_MIN,
+        SAMPLE_CHAIN_MAX,
+        SAMPLE_CHAIN_DEFAULT));
+
     return { parameters.begin(), parameters.end() };
 }
 
 float ParameterManager::getAttack() const
 {
-    if (auto* param = apvts.getParameter("attack")) 
-        return param->getValue(); 
-    return ADSR_ATTACK_DEFAULT; 
+    if (attack != nullptr)
+        return attack->getValue();
+    return ADSR_ATTACK_DEFAULT;
 }
 
 float ParameterManager::getDecay() const
 {
-    if (auto* param = apvts.getParameter("decay")) 
-        return param->getValue(); 
-    return ADSR_DECAY_DEFAULT; 
+    if (decay != nullptr)
+        return decay->getValue();
+    return ADSR_DECAY_DEFAULT;
 }
 
 float ParameterManager::getSustain() const
 {
-    if (auto* param = apvts.getParameter("sustain")) 
-        return param->getValue(); 
-    return ADSR_SUSTAIN_DEFAULT; 
+    if (sustain != nullptr)
+        return sustain->getValue();
+    return ADSR_SUSTAIN_DEFAULT;
 }
 
 float ParameterManager::getRelease() const
 {
-    if (auto* param = apvts.getParameter("release")) 
-        return param->getValue(); 
-    return ADSR_RELEASE_DEFAULT; 
+    if (release != nullptr)
+        return release->getValue();
+    return ADSR_RELEASE_DEFAULT;
 }
 
 float ParameterManager::getSampleGain() const
 {
-    if (auto* param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("sampleGain")))
-        return param->get();
-    return SAMPLE_GAIN_DEFAULT; 
+    if (sampleGain != nullptr)
+        return sampleGain->load();
+    return SAMPLE_GAIN_DEFAULT;
 }
 
 int ParameterManager::getVoiceCount() const
 {
-    if (auto* param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("voiceCount"))) {
-        // AudioParameterFloat already returns the actual value in the range, not normalized
-        float rawValue = param->get();
-        return static_cast<int>(rawValue);
-    }
-    return static_cast<int>(VOICE_COUNT_DEFAULT); 
+    // Raw values are in the parameter's range, not normalised
+    if (voiceCount != nullptr)
+        return static_cast<int>(voiceCount->load());
+    return static_cast<int>(VOICE_COUNT_DEFAULT);
 }
 
 float ParameterManager::getGlideTime() const
 {
-    if (auto* param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("glideTime"))) {
-        return param->get();
-    }
-    return GLIDE_TIME_DEFAULT; 
+    if (glideTime != nullptr)
+        return glideTime->load();
+    return GLIDE_TIME_DEFAULT;
 }
 
 int ParameterManager::getGlideSteps() const
 {
-    if (auto* param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("glideSteps"))) {
-        return static_cast<int>(param->get());
-    }
+    if (glideSteps != nullptr)
+        return static_cast<int>(glideSteps->load());
     return static_cast<int>(GLIDE_STEPS_DEFAULT);
 }
 
+// A choice parameter's raw value is its index, a bool's is 0 or 1
+
+ParameterManager::GlideMode ParameterManager::getGlideMode() const
+{
+    if (glideMode != nullptr)
+        return static_cast<GlideMode>(juce::roundToInt(glideMode->load()));
+    return static_cast<GlideMode>(GLIDE_MODE_DEFAULT);
+}
+
+float ParameterManager::getGlideSlew() const
+{
+    if (glideSlew != nullptr)
+        return glideSlew->load();
+    return GLIDE_SLEW_DEFAULT;
+}
+
+bool ParameterManager::isLegatoEnabled() const
+{
+    if (legato != nullptr)
+        return legato->load() >= 0.5f;
+    return LEGATO_DEFAULT;
+}
+
+int ParameterManager::getOversamplingIndex() const
+{
+    if (oversampling != nullptr)
+        return juce::jlimit(0, OVERSAMPLING_MAX_INDEX, juce::roundToInt(oversampling->load()));
+    return OVERSAMPLING_DEFAULT;
+}
+
+ParameterManager::OversamplingFilter ParameterManager::getOversamplingFilter() const
+{
+    if (oversamplingFilter != nullptr)
+        return static_cast<OversamplingFilter>(juce::roundToInt(oversamplingFilter->load()));
+    return static_cast<OversamplingFilter>(OVERSAMPLING_FILTER_DEFAULT);
+}
+
+ParameterManager::Interpolation ParameterManager::getInterpolation() const
+{
+    if (interpolation != nullptr)
+        return static_cast<Interpolation>(juce::roundToInt(interpolation->load()));
+    return static_cast<Interpolation>(INTERPOLATION_DEFAULT);
+}
+
 float ParameterManager::getTranspose() const
 {
-    if (auto* param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("transpose"))) {
-        return param->get();
-    }
+    if (transpose != nullptr)
+        return transpose->load();
     return TRANSPOSE_DEFAULT;
 }
 
 float ParameterManager::getFineTune() const
 {
-    if (auto* param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("finetune"))) {
-        return param->get();
-    }
+    if (fineTune != nullptr)
+        return fineTune->load();
     return FINETUNE_DEFAULT;
 }
+
+float ParameterManager::getSampleChain() const
+{
+    if (sampleChain != nullptr)
+        return sampleChain->load();
+    return SAMPLE_CHAIN_DEFAULT;
+}
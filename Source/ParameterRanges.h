@@ -0,0 +1,106 @@
+#pragma once
+
+// Parameter ranges, defaults and choice values, shared by the engine (which has no
+// plugin dependencies) and the plugin's parameter layout and UI
+struct ParameterRanges
+{
+    // ADSR Parameter Constants - Shared between host and UI
+    static constexpr float ADSR_ATTACK_MIN = 0.01f;      // 0.01 seconds (10ms minimum)
+    static constexpr float ADSR_ATTACK_MAX = 1.0f;       // 1.0 seconds (matching original)
+    static constexpr float ADSR_ATTACK_DEFAULT = 0.02f;  // 0.02 seconds (20ms default)
+    static constexpr float ADSR_ATTACK_INCREMENT = 0.001f;
+    
+    static constexpr float ADSR_DECAY_MIN = 0.001f;      // 0.001 seconds (1ms, matching original)
+    static constexpr float ADSR_DECAY_MAX = 1.0f;        // 1.0 seconds (matching original)
+    static constexpr float ADSR_DECAY_DEFAULT = 1.00f;   // 0.05 seconds (matching original)
+    static constexpr float ADSR_DECAY_INCREMENT = 0.001f;
+    
+    static constexpr float ADSR_SUSTAIN_MIN = 0.0f;      // 0.0 (0% volume)
+    static constexpr float ADSR_SUSTAIN_MAX = 1.0f;      // 1.0 (100% volume)
+    static constexpr float ADSR_SUSTAIN_DEFAULT = 1.0f;  // 0.7 (70% volume, matching original)
+    static constexpr float ADSR_SUSTAIN_INCREMENT = 0.001f;
+    
+    static constexpr float ADSR_RELEASE_MIN = 0.001f;    // 0.001 seconds (1ms)
+    static constexpr float ADSR_RELEASE_MAX = 10.0f;     // 10.0 seconds (increased for long samples)
+    static constexpr float ADSR_RELEASE_DEFAULT = 4.0f;  // 0.5 seconds (increased from 0.1s)
+    static constexpr float ADSR_RELEASE_INCREMENT = 0.001f;
+
+    // Master Gain Parameter Constants
+    static constexpr float SAMPLE_GAIN_MIN = -24.0f;
+    static constexpr float SAMPLE_GAIN_MAX = 24.0f;
+    static constexpr float SAMPLE_GAIN_DEFAULT = -6.0f;
+    static constexpr float SAMPLE_GAIN_INCREMENT = 0.1f;
+    
+    // Voice Count Parameter Constants
+    static constexpr float VOICE_COUNT_MIN = 1.0f;
+    static constexpr float VOICE_COUNT_MAX = 8.0f;
+    static constexpr float VOICE_COUNT_DEFAULT = 1.0f; // Monophonic by default
+    static constexpr float VOICE_COUNT_INCREMENT = 1.0f;
+    
+    // Glide Parameter Constants
+    static constexpr float GLIDE_TIME_MIN = 0.0f;        // 0ms = no glide
+    static constexpr float GLIDE_TIME_MAX = 1000.0f;     // 1000ms = 1 second maximum
+    static constexpr float GLIDE_TIME_DEFAULT = 100.0f;  // Start with 100ms glide
+    static constexpr float GLIDE_TIME_INCREMENT = 1.0f;  // 1ms increments
+    
+    static constexpr float GLIDE_STEPS_MIN = 2.0f;       // Minimum 2 steps for a transition
+    static constexpr float GLIDE_STEPS_MAX = 16.0f;      // Maximum 16 steps
+    static constexpr float GLIDE_STEPS_DEFAULT = 2.0f;   // Default 2 steps for quick glide
+    static constexpr float GLIDE_STEPS_INCREMENT = 1.0f; // 1 step increments
+
+    // Glide Mode - how the pitch travels between the start and target notes
+    enum class GlideMode
+    {
+        Stepped = 0,    // Triton-style discrete pitch steps
+        Linear,         // Smooth portamento, constant semitones per second
+        Exponential,    // Smooth portamento, fast start easing into the target
+        SteppedSlew     // Discrete steps with a short slew into each step
+    };
+    static constexpr int GLIDE_MODE_DEFAULT = 0;         // Stepped (original behaviour)
+
+    static constexpr float GLIDE_SLEW_MIN = 0.0f;        // 0% = hard steps
+    static constexpr float GLIDE_SLEW_MAX = 100.0f;      // 100% = slew across the whole step
+    static constexpr float GLIDE_SLEW_DEFAULT = 25.0f;   // Slew over the first quarter of each step
+    static constexpr float GLIDE_SLEW_INCREMENT = 1.0f;  // 1% increments
+
+    // Legato Parameter Constants
+    static constexpr bool LEGATO_DEFAULT = false;        // Retrigger on every note by default
+
+    // Oversampling Parameter Constants - the voice renders at 2^index times the host rate
+    static constexpr int OVERSAMPLING_DEFAULT = 0;       // Off
+    static constexpr int OVERSAMPLING_MAX_INDEX = 2;     // 4x, also used for offline renders
+
+    enum class OversamplingFilter
+    {
+        PolyphaseIIR = 0,   // Low latency, non-linear phase
+        FIR                 // Linear phase, higher latency
+    };
+    static constexpr int OVERSAMPLING_FILTER_DEFAULT = 0;
+
+    // Interpolation Parameter Constants (live playback - offline renders always use sinc)
+    enum class Interpolation
+    {
+        Linear = 0,     // Two-point, specialised per-ISA kernels
+        Sinc            // 16-tap windowed sinc (RenderKernels::renderVoiceSinc)
+    };
+    static constexpr int INTERPOLATION_DEFAULT = 0;
+
+    // Global Transpose Parameter Constants
+    static constexpr float TRANSPOSE_MIN = -24.0f;       // -2 octaves
+    static constexpr float TRANSPOSE_MAX = 24.0f;        // +2 octaves
+    static constexpr float TRANSPOSE_DEFAULT = 0.0f;     // No transpose
+    static constexpr float TRANSPOSE_INCREMENT = 1.0f;   // 1 semitone increments
+
+    // Fine Tune (Cents) Parameter Constants
+    static constexpr float FINETUNE_MIN = -100.0f;       // -100 cents
+    static constexpr float FINETUNE_MAX = 100.0f;        // +100 cents
+    static constexpr float FINETUNE_DEFAULT = 0.0f;      // No fine tune
+    static constexpr float FINETUNE_INCREMENT = 1.0f;    // 1 cent increments
+
+    // Sample Chain Parameter Constants - position across the samples covering a key,
+    // morphing between neighbours in between
+    static constexpr float SAMPLE_CHAIN_MIN = 0.0f;      // First sample
+    static constexpr float SAMPLE_CHAIN_MAX = 1.0f;      // Last sample
+    static constexpr float SAMPLE_CHAIN_DEFAULT = 0.0f;
+    static constexpr float SAMPLE_CHAIN_INCREMENT = 0.001f;
+};
@@ -167,6 +167,33 @@ PluginEditor::PluginEditor(GliderAudioProcessor& p)
     glideStepsLabel.setColour(juce::Label::textColourId, juce::Colours::white);
     addAndMakeVisible(glideStepsLabel);
 
+    // Configure glide mode selector (shares the title row)
+    glideModeBox.addItemList({ "Stepped", "Linear", "Exponential", "Stepped Slew" }, 1);
+    glideModeBox.setColour(juce::ComboBox::outlineColourId, uniformGreen);
+    glideModeBox.setColour(juce::ComboBox::backgroundColourId, juce::Colours::black);
+    glideModeBox.setColour(juce::ComboBox::textColourId, juce::Colours::white);
+    glideModeBox.setColour(juce::ComboBox::arrowColourId, uniformGreen);
+    addAndMakeVisible(glideModeBox);
+
+    // Configure oversampling selector (title row, next to the glide mode)
+    oversamplingBox.addItemList({ "Off", "2x", "4x" }, 1);
+    oversamplingBox.setColour(juce::ComboBox::outlineColourId, uniformGreen);
+    oversamplingBox.setColour(juce::ComboBox::backgroundColourId, juce::Colours::black);
+    oversamplingBox.setColour(juce::ComboBox::textColourId, juce::Colours::white);
+    oversamplingBox.setColour(juce::ComboBox::arrowColourId, uniformGreen);
+    addAndMakeVisible(oversamplingBox);
+
+    // Configure CPU meter (title row, updated by the timer); a click writes the timing
+    // histograms next to the debug log
+    cpuMeter.onClick = [this]()
+    {
+        auto reportFile = logger.getLogFile().getSiblingFile("eskilator_timing_"
+            + juce::Time::getCurrentTime().formatted("%Y%m%d_%H%M%S") + ".json");
+        if (audioProcessor.writeTimingReport(reportFile))
+            logger.log("Timing report written to " + reportFile.getFullPathName());
+    };
+    addAndMakeVisible(cpuMeter);
+
     // Configure transpose slider
     transposeSlider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
     transposeSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 80, 20);
@@ -213,14 +240,21 @@ PluginEditor::PluginEditor(GliderAudioProcessor& p)
     glideStepsAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "glideSteps", glideStepsSlider);
     transposeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "transpose", transposeSlider);
     fineTuneAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "finetune", fineTuneSlider);
+    glideModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "glideMode", glideModeBox);
+    oversamplingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(apvts, "oversampling", oversamplingBox);
 
     // Now that all components are created, manually trigger the layout
     logger.log("All components created, manually calling resized()");
     resized();
+
+    timerCallback();
+    startTimerHz(4);
 }
 
 PluginEditor::~PluginEditor()
 {
+    stopTimer();
+
     // Explicitly destroy parameter attachments before base class destructor
     // This prevents crashes when attachments try to access destroyed sliders
     attackAttachment.reset();
@@ -232,10 +266,72 @@ PluginEditor::~PluginEditor()
     glideStepsAttachment.reset();
     transposeAttachment.reset();
     fineTuneAttachment.reset();
+    glideModeAttachment.reset();
+    oversamplingAttachment.reset();
+}
+
+void PluginEditor::timerCallback()
+{
+    const auto tier = audioProcessor.getQualityTier();
+    const int loadPercent = juce::roundToInt(audioProcessor.getCpuLoad() * 100.0f);
+    const auto window = audioProcessor.getInstrumentationReader().getLatestWindow();
+    cpuMeter.setStatus(audioProcessor.getCpuLoad(), window.getPeakLoad(), window.overruns, CpuGovernor::getTierName(tier));
+
+    // Governor tier changes go to the log as well
+    if (tier != lastQualityTier)
+    {
+        logger.log("CPU governor: quality tier " + juce::String(CpuGovernor::getTierName(lastQualityTier))
+                   + " -> " + CpuGovernor::getTierName(tier) + " at " + juce::String(loadPercent) + "% load");
+        lastQualityTier = tier;
+    }
+}
+
+void CpuMeter::setStatus(float newLoad, float newPeakLoad, juce::uint64 newOverruns, const juce::String& newTierName)
+{
+    if (newLoad == load && newPeakLoad == peakLoad && newOverruns == overruns && newTierName == tierName)
+        return;
+
+    load = newLoad;
+    peakLoad = newPeakLoad;
+    overruns = newOverruns;
+    tierName = newTierName;
+    repaint();
+}
+
+void CpuMeter::paint(juce::Graphics& g)
+{
+    auto uniformGreen = juce::Colour(0xff5af542);
+    auto bounds = getLocalBounds().toFloat();
+
+    g.setColour(uniformGreen.withAlpha(0.2f));
+    g.fillRect(bounds.withWidth(bounds.getWidth() * juce::jlimit(0.0f, 1.0f, load)));
+
+    // Peak of the last read interval, red while blocks are missing their deadline
+    const auto alertColour = overruns > 0 ? juce::Colours::red : uniformGreen;
+    if (peakLoad > 0.0f)
+    {
+        g.setColour(alertColour);
+        g.fillRect(bounds.getX() + bounds.getWidth() * juce::jlimit(0.0f, 1.0f, peakLoad) - 1.0f, bounds.getY(), 1.0f, bounds.getHeight());
+    }
+
+    g.setColour(uniformGreen);
+    g.drawRect(bounds, 1.0f);
+
+    g.setColour(alertColour);
+    g.setFont(juce::Font(11.0f));
+    g.drawText("CPU " + juce::String(juce::roundToInt(load * 100.0f)) + "% " + tierName,
+               getLocalBounds().reduced(3, 0), juce::Justification::centred);
+}
+
+void CpuMeter::mouseUp(const juce::MouseEvent& event)
+{
+    if (onClick != nullptr && getLocalBounds().contains(event.getPosition()))
+        onClick();
 }
 
 void PluginEditor::paint(juce::Graphics& g)
 {
+    ESKILATOR_TRACE_SCOPE("PluginEditor::paint", "editor");
     g.fillAll(juce::Colours::black);
 }
 
@@ -258,7 +354,12 @@ void PluginEditor::resized()
 
     // Position title label in top left corner
     auto titleArea = bounds.removeFromTop(30);
-    titleLabel.setBounds(titleArea.removeFromLeft(200));
+    titleLabel.setBounds(titleArea.removeFromLeft(140));
+    glideModeBox.setBounds(titleArea.removeFromRight(140).reduced(0, 3));
+    titleArea.removeFromRight(6);
+    oversamplingBox.setBounds(titleArea.removeFromRight(70).reduced(0, 3));
+    titleArea.removeFromRight(6);
+    cpuMeter.setBounds(titleArea.reduced(0, 5));
     bounds.removeFromTop(10); // Small spacing after title
 
     // Sample viewer section at top (fixed height)
@@ -348,23 +449,20 @@ void PluginEditor::resized()
 // SampleBankComponent implementation
 SampleBankComponent::SampleBankComponent(GliderAudioProcessor& processor)
     : audioProcessor(processor),
-      isDragOver(false),
-      thumbnailCache(5),
-      thumbnail(512, formatManager, thumbnailCache)
+      isDragOver(false)
 {
     setOpaque(true);
-    formatManager.registerBasicFormats();
-    thumbnail.addChangeListener(this);
     updateSampleList();
 }
 
 SampleBankComponent::~SampleBankComponent()
 {
-    thumbnail.removeChangeListener(this);
 }
 
 void SampleBankComponent::paint(juce::Graphics& g)
 {
+    ESKILATOR_TRACE_SCOPE("SampleBankComponent::paint", "editor");
+
     // Match app background (black)
     g.fillAll(juce::Colours::black);
 
@@ -392,7 +490,7 @@ void SampleBankComponent::paint(juce::Graphics& g)
         g.drawText(durationText, durationArea, juce::Justification::centredLeft);
 
         // Draw waveform if available
-        if (thumbnail.getNumChannels() > 0)
+        if (waveform != nullptr && waveform->numPeaks > 0)
         {
             bounds.removeFromTop(5); // Small spacing
             auto thumbnailBounds = bounds.removeFromTop(bounds.getHeight() - 15); // Leave room for hint
@@ -403,7 +501,7 @@ void SampleBankComponent::paint(juce::Graphics& g)
 
             // Draw waveform as mono (just channel 0 for cleaner display)
             g.setColour(uniformGreen.withAlpha(0.8f));
-            thumbnail.drawChannel(g, thumbnailBounds, 0.0, thumbnail.getTotalLength(), 0, 1.0f);
+            drawWaveform(g, thumbnailBounds);
         }
 
         // Hint text at bottom
@@ -442,32 +540,37 @@ void SampleBankComponent::resized()
 
 void SampleBankComponent::updateSampleList()
 {
-    // Update waveform thumbnail when sample changes
-    if (audioProcessor.hasSample())
-    {
-        const auto* buffer = audioProcessor.getSampleBufferForDisplay(0);
-        if (buffer != nullptr)
-        {
-            double sampleRate = audioProcessor.getOriginalSampleRate();
-            thumbnail.reset(buffer->getNumChannels(), sampleRate);
-            thumbnail.addBlock(0, *buffer, 0, buffer->getNumSamples());
-        }
-    }
-    else
-    {
-        thumbnail.clear();
-    }
+    // The waveform peaks were computed (or read from the cache) when the sample loaded
+    waveform = audioProcessor.getSampleWaveform(0);
 
     // Repaint to show current sample name and waveform
     repaint();
 }
 
-void SampleBankComponent::changeListenerCallback(juce::ChangeBroadcaster* source)
+void SampleBankComponent::drawWaveform(juce::Graphics& g, juce::Rectangle<int> bounds) const
 {
-    if (source == &thumbnail)
+    // One vertical line per pixel column spanning the peaks under it (channel 0 only)
+    const float* minima = waveform->getMinima(0);
+    const float* maxima = waveform->getMaxima(0);
+    const float centre = bounds.getCentreY();
+    const float halfHeight = bounds.getHeight() * 0.5f;
+
+    for (int x = 0; x < bounds.getWidth(); ++x)
     {
-        // Thumbnail has finished loading, trigger repaint
-        repaint();
+        const int first = x * waveform->numPeaks / bounds.getWidth();
+        const int last = juce::jmax(first + 1, (x + 1) * waveform->numPeaks / bounds.getWidth());
+
+        float low = minima[first];
+        float high = maxima[first];
+        for (int peak = first + 1; peak < last; ++peak)
+        {
+            low = juce::jmin(low, minima[peak]);
+            high = juce::jmax(high, maxima[peak]);
+        }
+
+        const float top = centre - juce::jlimit(-1.0f, 1.0f, high) * halfHeight;
+        const float bottom = centre - juce::jlimit(-1.0f, 1.0f, low) * halfHeight;
+        g.drawVerticalLine(bounds.getX() + x, top, juce::jmax(top + 1.0f, bottom));
     }
 }
 
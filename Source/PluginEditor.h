@@ -24,8 +24,32 @@ public:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TestComponent)
 };
 
+// Small live CPU meter: smoothed load bar, peak marker for the last read interval,
+// governor tier and overruns. Clicking it calls onClick.
+class CpuMeter : public juce::Component
+{
+public:
+    CpuMeter() = default;
+    ~CpuMeter() override = default;
+
+    void setStatus(float newLoad, float newPeakLoad, juce::uint64 newOverruns, const juce::String& newTierName);
+
+    void paint(juce::Graphics& g) override;
+    void mouseUp(const juce::MouseEvent& event) override;
+
+    std::function<void()> onClick;
+
+private:
+    float load = 0.0f;
+    float peakLoad = 0.0f;
+    juce::uint64 overruns = 0;
+    juce::String tierName;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CpuMeter)
+};
+
 // Component for displaying and managing the sample bank
-class SampleBankComponent : public juce::Component, public juce::FileDragAndDropTarget, public juce::Slider::Listener, public juce::Button::Listener, public juce::ChangeListener
+class SampleBankComponent : public juce::Component, public juce::FileDragAndDropTarget, public juce::Slider::Listener, public juce::Button::Listener
 {
 public:
     SampleBankComponent(GliderAudioProcessor& processor);
@@ -52,19 +76,16 @@ public:
     // Slider and button listeners
     void sliderValueChanged(juce::Slider* slider) override;
     void buttonClicked(juce::Button* button) override;
-
-    // ChangeListener for thumbnail updates
-    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
     
 private:
     GliderAudioProcessor& audioProcessor;
     std::function<void(int)> onSampleRemoved;
     std::function<void()> onSampleCountChanged;
 
-    // Waveform display
-    juce::AudioFormatManager formatManager;
-    juce::AudioThumbnailCache thumbnailCache;
-    juce::AudioThumbnail thumbnail;
+    // Waveform display, drawn from the peaks computed (or cached) at load
+    std::shared_ptr<const WaveformPeaks> waveform;
+
+    void drawWaveform(juce::Graphics& g, juce::Rectangle<int> bounds) const;
     
     // Individual sample controls
     struct SampleControl : public juce::Component
@@ -97,7 +118,8 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleBankComponent)
 };
 
-class PluginEditor : public juce::AudioProcessorEditor
+class PluginEditor : public juce::AudioProcessorEditor,
+                     private juce::Timer
 {
 public:
     PluginEditor(GliderAudioProcessor&);
@@ -107,6 +129,9 @@ public:
     void resized() override;
 
 private:
+    // Polls the CPU governor and the instrumentation reader for the CPU meter
+    void timerCallback() override;
+
     GliderAudioProcessor& audioProcessor;
     PluginLogger& logger;
 
@@ -126,6 +151,8 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> glideStepsAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> transposeAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> fineTuneAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> glideModeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversamplingAttachment;
     
     // ADSR controls
     juce::Slider attackSlider;
@@ -146,6 +173,14 @@ private:
     juce::Label glideTimeLabel;
     juce::Slider glideStepsSlider;
     juce::Label glideStepsLabel;
+    juce::ComboBox glideModeBox;
+
+    // Oversampling control
+    juce::ComboBox oversamplingBox;
+
+    // CPU load and governor quality tier (click to write a timing report)
+    CpuMeter cpuMeter;
+    CpuGovernor::QualityTier lastQualityTier = CpuGovernor::QualityTier::Full;
 
     // Transpose control
     juce::Slider transposeSlider;
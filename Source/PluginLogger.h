@@ -47,3 +47,8 @@ private:
     // Write message to JUCE logger
     void writeToJUCE(const juce::String& message);
 };
+
+// Log through a PluginLogger, building the message only when logging is enabled.
+// Use this on the audio thread, where building a juce::String allocates.
+#define ESKILATOR_LOG(pluginLogger, message) \
+    do { if (PluginLogger::isLoggingEnabled()) (pluginLogger).log(message); } while (false)
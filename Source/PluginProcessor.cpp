@@ -1,8 +1,6 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
-#include <map>
-#include <cmath>
 
 juce::AudioProcessorValueTreeState::ParameterLayout GliderAudioProcessor::createParameterLayout()
 {
@@ -13,32 +11,38 @@ GliderAudioProcessor::GliderAudioProcessor()
     : AudioProcessor(getBusesLayout()),
       parameterManager(*this)
 {
-    // Register for parameter change notifications for ADSR parameters
-    parameterManager.getAPVTS().addParameterListener("attack", this);
-    parameterManager.getAPVTS().addParameterListener("decay", this);
-    parameterManager.getAPVTS().addParameterListener("sustain", this);
-    parameterManager.getAPVTS().addParameterListener("release", this);
-
     // Debug: Log plugin capabilities at construction
     PluginLogger::setLoggingEnabled(false);
 
+    // File loads go through the shared on-disk sample cache
+    sampleManager.setCache(SampleCache::getShared());
+
     // Load default click sample (optional - plugin can work without it)
-    loadDefaultSample(currentSampleRate);
+    loadDefaultSample(engine.getSampleRate());
 
-    // Initialize sample gain to -6dB for safer starting level
-    sampleGainDb = -6.0f;
+    instrumentationReader.start();
+
+#if ESKILATOR_ENABLE_TRACING
+    // Tracing builds record a timeline when ESKILATOR_TRACE_FILE names the output file;
+    // the first instance to start tracing writes it
+    const auto tracePath = juce::SystemStats::getEnvironmentVariable("ESKILATOR_TRACE_FILE", {});
+    if (tracePath.isNotEmpty() && Trace::start())
+        traceFilePath = tracePath;
+#endif
 }
 
 GliderAudioProcessor::~GliderAudioProcessor()
 {
-    // Unregister parameter listeners to avoid dangling pointer
-    parameterManager.getAPVTS().removeParameterListener("attack", this);
-    parameterManager.getAPVTS().removeParameterListener("decay", this);
-    parameterManager.getAPVTS().removeParameterListener("sustain", this);
-    parameterManager.getAPVTS().removeParameterListener("release", this);
-
     // Mark plugin as not ready to prevent new background operations
     isPluginReady = false;
+
+    instrumentationReader.stop();
+
+    if (traceFilePath.isNotEmpty())
+    {
+        Trace::stop();
+        Trace::writeChromeJson(traceFilePath.toStdString());
+    }
 }
 
 const juce::String GliderAudioProcessor::getName() const
@@ -98,30 +102,11 @@ void GliderAudioProcessor::changeProgramName(int index, const juce::String& newN
 
 void GliderAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    // Store sample rate for calculations
-    currentSampleRate = sampleRate;
-    
-    // Reset all voices and initialize ADSR
-    for (auto& voice : sampleVoices)
-    {
-        voice.isActive = false;
-        voice.isGliding = false;
-        voice.samplePosition = 0;
-        voice.phaseAccumulator = 0.0;
-        voice.glideCurrentStep = 0;
-        voice.glideTotalSteps = 0;
-        voice.glideSamplesPerStep = 0;
-        voice.glideSampleCounter = 0;
-
-        // Initialize ADSR envelope
-        voice.adsr.setSampleRate(sampleRate);
-        juce::ADSR::Parameters adsrParams;
-        adsrParams.attack = getAttack();
-        adsrParams.decay = getDecay();
-        adsrParams.sustain = getSustain();
-        adsrParams.release = getRelease();
-        voice.adsr.setParameters(adsrParams);
-    }
+    // The engine prepares with the current parameters and render mode
+    engine.setNonRealtime(isNonRealtime());
+    engine.setParameters(getEngineParameters());
+    engine.prepare(sampleRate, samplesPerBlock, getTotalNumOutputChannels(), isUsingDoublePrecision());
+    setLatencySamples(engine.getLatencySamples());
     
     // Mark plugin as ready
     isPluginReady = true;
@@ -145,411 +130,55 @@ bool GliderAudioProcessor::isBusesLayoutSupported(const BusesLayout& busesLayout
 
 void GliderAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
-    juce::ScopedNoDenormals noDenormals;
-
-    // Sample-accurate MIDI handling: split buffer at each MIDI event
-    int startSample = 0;
-
-    for (auto it = midiMessages.begin(); it != midiMessages.end(); ++it)
-    {
-        auto message = (*it).getMessage();
-        int sampleOffset = (*it).samplePosition;
-
-        // Render audio up to this MIDI event
-        if (sampleOffset > startSample)
-        {
-            renderAudioSegment(buffer, startSample, sampleOffset);
-        }
-                    
-        if (message.isNoteOn())
-        {
-            logger.log("MIDI Note ON: Note=" + juce::String(message.getNoteNumber()) + 
-                      ", Velocity=" + juce::String(message.getVelocity()));
-            
-            // Trigger sample playback
-            logger.log("hasSample() = " + juce::String(hasSample() ? "true" : "false"));
-            if (hasSample())
-            {
-                // Convert MIDI note number to pitch offset (C4 = 60 = 0 semitones)
-                int baseNoteNumber = 60; // Middle C
-                float pitchOffset = static_cast<float>(message.getNoteNumber() - baseNoteNumber);
-                // Apply global transpose and fine tune (cents converted to semitones)
-                pitchOffset += getTranspose();
-                pitchOffset += getFineTune() / 100.0f; // Convert cents to semitones
-                // No pitch limit - allow full MIDI range
-                
-                // MONOPHONIC DESIGN: Always use voice 0, apply crossfade on every note
-                auto& voice = sampleVoices[0];
-
-                // Check if we should apply glide (different pitch)
-                float glideTime = getGlideTime();
-                int glideSteps = getGlideSteps();
-                bool shouldGlide = (glideTime > 0.0f) && hasLastPitch && (lastMonophonicPitch != pitchOffset);
-
-                logger.log("Note trigger - HasLastPitch=" + juce::String(hasLastPitch ? "true" : "false") +
-                          ", LastPitch=" + juce::String(lastMonophonicPitch) +
-                          ", NewPitch=" + juce::String(pitchOffset) +
-                          ", ShouldGlide=" + juce::String(shouldGlide ? "true" : "false"));
-
-                // Save old state for crossfade before resetting
-                voice.glideOldPhaseAccumulator = voice.phaseAccumulator;
-                voice.glideOldPitchRatio = voice.cachedPitchRatio > 0.0f ? voice.cachedPitchRatio : std::pow(2.0f, voice.pitch / 12.0f);
-
-                if (shouldGlide)
-                {
-                    // Different pitch - apply glide
-                    voice.isGliding = true;
-                    voice.glideStartPitch = lastMonophonicPitch;
-                    voice.glideTargetPitch = pitchOffset;
-                    voice.glideCurrentStep = 0;
-                    voice.glideTotalSteps = glideSteps;
-                    voice.glideSamplesPerStep = static_cast<int>(glideTime * 0.001f * currentSampleRate) / glideSteps;
-                    voice.glideSampleCounter = 0;
-                    voice.cachedPitchRatio = 0.0f; // Force recalculation
-                    voice.pitch = voice.glideStartPitch; // Start with beginning pitch
-
-                    logger.log("Applied glide to voice 0");
-                }
-                else
-                {
-                    // Same pitch or first note - no glide, just set pitch directly
-                    voice.isGliding = false;
-                    voice.pitch = pitchOffset;
-                    voice.cachedPitchRatio = 0.0f; // Force recalculation
-
-                    logger.log("No glide - set voice 0 to pitch " + juce::String(pitchOffset));
-                }
-
-                // Always reset sample position and apply crossfade for clean restart
-                voice.phaseAccumulator = 0.0;
-                voice.samplePosition = 0;
-                voice.isInGlideCrossfade = true;
-                voice.glideCrossfadeSampleCount = 0;
-
-                // Update velocity and activate voice
-                voice.velocity = message.getVelocity() / 127.0f;
-                voice.isActive = true;
-
-                // ADSR ENVELOPE: Always restart envelope on every note
-                voice.adsr.noteOn();
-                logger.log("ADSR noteOn() triggered - envelope restarted");
-
-                // Update monophonic pitch tracking
-                lastMonophonicPitch = pitchOffset;
-                hasLastPitch = true;
-            }
-        }
-        else if (message.isNoteOff())
-        {
-            // Trigger release phase of ADSR envelope for monophonic voice
-            auto& voice = sampleVoices[0];
-            if (voice.isActive)
-            {
-                voice.adsr.noteOff();
-                logger.log("ADSR noteOff() triggered - starting release phase");
-            }
-        }
-
-        // Update start position for next segment
-        startSample = sampleOffset;
-    }
-
-    // Render any remaining audio after last MIDI event
-    if (startSample < buffer.getNumSamples())
-    {
-        renderAudioSegment(buffer, startSample, buffer.getNumSamples());
-    }
+    processBlockInternal(buffer, midiMessages);
 }
 
-// Render audio for a segment of the buffer
-void GliderAudioProcessor::renderAudioSegment(juce::AudioBuffer<float>& buffer, int startSample, int endSample)
+void GliderAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
 {
-    // Get current sample buffer
-    int currentSampleIndex = sampleManager.getCurrentSampleIndex();
-    const juce::AudioBuffer<float>& currentBuffer = sampleManager.getCurrentSampleBuffer();
-    
-    // Safety check: if no valid sample is loaded, output silence
-    if (currentSampleIndex < 0 || currentBuffer.getNumSamples() <= 1) {
-        buffer.clear();
-        return;
-    }
-    
-    // Cache parameter values to avoid repeated function calls
-    // Note: Per-sample gain is applied per-voice in the voice processing loop
-    float attackSamples = getAttack() * currentSampleRate;
-    float decaySamples = getDecay() * currentSampleRate;
-    float sustainValue = getSustain();
-    float releaseSamples = getRelease() * currentSampleRate;
-    
-    // PERFORMANCE: Cache expensive gain calculations outside the sample loop
-    float masterGainLinear = juce::Decibels::decibelsToGain(getSampleGain());
-    float perSampleGainLinear = juce::Decibels::decibelsToGain(getSampleGain(currentSampleIndex));
-    
-    // ROBUST BUFFER VALIDATION: Use comprehensive validation like vst-test2
-    bool bufferValid = (currentBuffer.getNumSamples() > 0 && currentBuffer.getNumChannels() > 0);
-    int maxSamples = bufferValid ? currentBuffer.getNumSamples() : 0;
-    int maxChannels = bufferValid ? currentBuffer.getNumChannels() : 0;
-    
-    // THREAD-SAFE PERFORMANCE OPTIMIZATION: Cache expensive operations outside the sample loop (like vst-test2)
-    int currentVoiceCount = getVoiceCount();
-    
-    // PERFORMANCE: Early exit if no valid audio to process
-    if (!bufferValid || currentVoiceCount == 0 || maxSamples == 0 || maxChannels == 0) {
-        buffer.clear();
-        return;
-    }
-    
-    // Process audio for each sample in the segment
-    for (int sample = startSample; sample < endSample; ++sample)
-    {
-        // Generate audio for each output channel
-        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
-        {
-            auto* channelData = buffer.getWritePointer(channel);
-            
-            // Process the single monophonic voice (voice 0)
-            float sampleValue = 0.0f;
-            bool hasActiveVoices = false;
+    processBlockInternal(buffer, midiMessages);
+}
 
-            int sourceChannel = juce::jmin(channel, maxChannels - 1);
+template <typename SampleType>
+void GliderAudioProcessor::processBlockInternal(juce::AudioBuffer<SampleType>& buffer, juce::MidiBuffer& midiMessages)
+{
+    // The whole callback, parameter reads included, must stay allocation- and lock-free
+    ESKILATOR_REALTIME_SCOPE();
 
-            // MONOPHONIC: Only process voice 0
-            auto& voice = sampleVoices[0];
+    // Parameters and the render mode apply at the block boundary
+    engine.setNonRealtime(isNonRealtime());
+    engine.setParameters(getEngineParameters());
+    engine.process(buffer, midiMessages);
 
-            if (voice.isActive)
-                {
-                    // MULTIPLE SAFETY CHECKS: Comprehensive bounds validation (like vst-test2)
-                    // Since we use phaseAccumulator (not samplePosition), validate based on current phase
-                    float currentSampleIndex = static_cast<float>(voice.phaseAccumulator);
-                    int currentSampleIndexInt = static_cast<int>(currentSampleIndex);
-
-                    // Check if sample has ended (don't deactivate on envelope completion - allows sequential notes)
-                    if (currentSampleIndexInt < 0 || currentSampleIndexInt >= maxSamples)
-                    {
-                        // Deactivate voice only when sample ends
-                        voice.isActive = false;
-                        voice.isGliding = false;
-                        continue;
-                    }
-                    
-                    // PARANOID VALIDATION: Double-check buffer state before access (like vst-test2)
-                    if (maxSamples == 0 || maxChannels == 0 || sourceChannel >= maxChannels)
-                    {
-                        continue; // Skip this voice entirely if buffer is invalid
-                    }
-                    
-                    hasActiveVoices = true;
-                    
-                    // For monophonic synth, we don't need noteOffCountdown - voices are managed by voice stealing
-                    // Process glide for stepped portamento (Triton-style) - RE-ENABLED
-                    if (voice.isGliding)
-                    {
-                        voice.glideSampleCounter++;
-                        
-                        // Check if it's time to move to the next step
-                        if (voice.glideSampleCounter >= voice.glideSamplesPerStep)
-                        {
-                            voice.glideCurrentStep++;
-                            voice.glideSampleCounter = 0;
-                            
-                            // Calculate the stepped pitch (discrete steps, not smooth)
-                            if (voice.glideCurrentStep >= voice.glideTotalSteps)
-                            {
-                                // Glide complete - set final pitch (NO PHASE COMPENSATION)
-                                voice.pitch = voice.glideTargetPitch;
-                                voice.cachedPitchRatio = 0.0f; // Force recalculation on next sample
-                                voice.isGliding = false;
-                            }
-                            else
-                            {
-                                // Calculate stepped pitch - this creates the "cheap" Triton sound
-                                float stepProgress = static_cast<float>(voice.glideCurrentStep) / static_cast<float>(voice.glideTotalSteps);
-                                float pitchDifference = voice.glideTargetPitch - voice.glideStartPitch;
-                                float newPitch = voice.glideStartPitch + (pitchDifference * stepProgress);
-
-                                // Update pitch directly (NO PHASE COMPENSATION)
-                                // The discrete pitch jump is intentional for Triton-style stepped glide
-                                voice.pitch = newPitch;
-                                voice.cachedPitchRatio = 0.0f; // Force recalculation on next sample
-                            }
-                        }
-                    }
-                    
-                    // Apply pitch modification
-                    float voiceSampleValue = 0.0f;
-                    
-                    // Calculate pitch ratio with smoothing for glide
-                    float pitchRatio = voice.cachedPitchRatio;
-                    if (pitchRatio == 0.0f)
-                    {
-                        pitchRatio = std::pow(2.0f, voice.pitch / 12.0f);
-                        voice.cachedPitchRatio = pitchRatio;
-                        
-                        
-                        // Debug logging for pitch calculation
-                        if (sample == 0 && channel == 0) { // Only log once per buffer
-                            logger.log("Voice 0 - Pitch: " + juce::String(voice.pitch) +
-                                      ", Pitch Ratio: " + juce::String(pitchRatio) +
-                                      ", Phase: " + juce::String(voice.phaseAccumulator));
-                        }
-                    }
-                    
-                    // Phase-continuous sample reading
-                    float oldPhase = voice.phaseAccumulator;
-                    voice.phaseAccumulator += pitchRatio;
-
-                    // Log suspicious phase jumps during glide
-                    if (voice.isGliding && sample == 0 && channel == 0) {
-                        float phaseJump = voice.phaseAccumulator - oldPhase;
-                        if (phaseJump > pitchRatio * 2.0f || phaseJump < pitchRatio * 0.5f) {
-                            logger.log("PHASE JUMP - Voice 0" +
-                                      juce::String(" - Expected: ") + juce::String(pitchRatio) +
-                                      " - Actual: " + juce::String(phaseJump) +
-                                      " - From: " + juce::String(oldPhase) +
-                                      " - To: " + juce::String(voice.phaseAccumulator));
-                        }
-                    }
-
-                    // GLIDE CROSSFADE: Read from both old and new positions during crossfade
-                    float pitchedSampleValue = 0.0f;
-
-                    if (voice.isInGlideCrossfade && voice.glideCrossfadeSampleCount < voice.GLIDE_CROSSFADE_LENGTH)
-                    {
-                        // Read from NEW position (restarted sample)
-                        float sampleIndex = static_cast<float>(voice.phaseAccumulator);
-                        int sampleIndexInt = static_cast<int>(sampleIndex);
-                        float sampleIndexFrac = sampleIndex - sampleIndexInt;
-
-                        float newSample = 0.0f;
-                        if (sampleIndexInt >= 0 && sampleIndexInt + 1 < maxSamples)
-                        {
-                            try {
-                                float sample1 = currentBuffer.getSample(sourceChannel, sampleIndexInt);
-                                float sample2 = currentBuffer.getSample(sourceChannel, sampleIndexInt + 1);
-                                newSample = sample1 + (sample2 - sample1) * sampleIndexFrac;
-                            } catch (...) {
-                                newSample = 0.0f;
-                            }
-                        }
-                        else if (sampleIndexInt >= 0 && sampleIndexInt < maxSamples)
-                        {
-                            try {
-                                newSample = currentBuffer.getSample(sourceChannel, sampleIndexInt);
-                            } catch (...) {
-                                newSample = 0.0f;
-                            }
-                        }
-
-                        // Read from OLD position (continuation)
-                        float oldSampleIndex = static_cast<float>(voice.glideOldPhaseAccumulator);
-                        int oldSampleIndexInt = static_cast<int>(oldSampleIndex);
-                        float oldSampleIndexFrac = oldSampleIndex - oldSampleIndexInt;
-
-                        float oldSample = 0.0f;
-                        if (oldSampleIndexInt >= 0 && oldSampleIndexInt + 1 < maxSamples)
-                        {
-                            try {
-                                float sample1 = currentBuffer.getSample(sourceChannel, oldSampleIndexInt);
-                                float sample2 = currentBuffer.getSample(sourceChannel, oldSampleIndexInt + 1);
-                                oldSample = sample1 + (sample2 - sample1) * oldSampleIndexFrac;
-                            } catch (...) {
-                                oldSample = 0.0f;
-                            }
-                        }
-                        else if (oldSampleIndexInt >= 0 && oldSampleIndexInt < maxSamples)
-                        {
-                            try {
-                                oldSample = currentBuffer.getSample(sourceChannel, oldSampleIndexInt);
-                            } catch (...) {
-                                oldSample = 0.0f;
-                            }
-                        }
-
-                        // Crossfade between old and new
-                        float blend = static_cast<float>(voice.glideCrossfadeSampleCount) / static_cast<float>(voice.GLIDE_CROSSFADE_LENGTH);
-                        pitchedSampleValue = (oldSample * (1.0f - blend)) + (newSample * blend);
-
-                        // Increment old phase accumulator
-                        voice.glideOldPhaseAccumulator += voice.glideOldPitchRatio;
-
-                        // Increment crossfade counter
-                        voice.glideCrossfadeSampleCount++;
-
-                        // Check if crossfade is complete
-                        if (voice.glideCrossfadeSampleCount >= voice.GLIDE_CROSSFADE_LENGTH)
-                        {
-                            voice.isInGlideCrossfade = false;
-                        }
-                    }
-                    else
-                    {
-                        // Normal sample reading (no crossfade)
-                        float sampleIndex = static_cast<float>(voice.phaseAccumulator);
-                        int sampleIndexInt = static_cast<int>(sampleIndex);
-                        float sampleIndexFrac = sampleIndex - sampleIndexInt;
-
-                        // Debug logging for sample reading
-                        if (sample == 0 && channel == 0 && voice.isGliding) {
-                            logger.log("Voice 0 - Sample Index: " + juce::String(sampleIndex) +
-                                      " (int: " + juce::String(sampleIndexInt) +
-                                      ", frac: " + juce::String(sampleIndexFrac) +
-                                      ") - Max Samples: " + juce::String(maxSamples));
-                        }
-
-                        // ULTRA-SAFE pitched sample value with comprehensive bounds checking (like vst-test2)
-                        if (sampleIndexInt >= 0 && sampleIndexInt + 1 < maxSamples)
-                        {
-                            try {
-                                float sample1 = currentBuffer.getSample(sourceChannel, sampleIndexInt);
-                                float sample2 = currentBuffer.getSample(sourceChannel, sampleIndexInt + 1);
-                                pitchedSampleValue = sample1 + (sample2 - sample1) * sampleIndexFrac;
-                            } catch (...) {
-                                pitchedSampleValue = 0.0f; // Safe fallback
-                            }
-                        }
-                        else if (sampleIndexInt >= 0 && sampleIndexInt < maxSamples)
-                        {
-                            try {
-                                pitchedSampleValue = currentBuffer.getSample(sourceChannel, sampleIndexInt);
-                            } catch (...) {
-                                pitchedSampleValue = 0.0f; // Safe fallback
-                            }
-                        }
-                        else if (sampleIndexInt >= maxSamples)
-                        {
-                            // ENVELOPE DISABLED - one-shot sample has ended, deactivate voice
-                            voice.isActive = false;
-                            voice.isGliding = false;
-                            pitchedSampleValue = 0.0f;
-                        }
-                    }
-                    
-                    // Apply cached gain values instead of calculating per sample
-                    voiceSampleValue = pitchedSampleValue * masterGainLinear * perSampleGainLinear * voice.velocity;
-
-                    // Apply ADSR envelope
-                    float envelopeValue = voice.adsr.getNextSample();
-                    voiceSampleValue *= envelopeValue;
-
-                    sampleValue = voiceSampleValue;
-                }
-
-            // Write output (like vst-test2)
-            if (hasActiveVoices) {
-                channelData[sample] = sampleValue;
-            } else {
-                channelData[sample] = 0.0f;
-            }
-        }
-    }
+    // Only the oversampling filter changes the latency; every factor reports the 4x latency.
+    // Hosts treat each call as a latency change, so only report a new value.
+    if (engine.getLatencySamples() != getLatencySamples())
+        setLatencySamples(engine.getLatencySamples());
+}
 
-    // Clear any remaining channels
-    for (int channel = buffer.getNumChannels(); channel < buffer.getNumChannels(); ++channel)
-    {
-        buffer.clear(channel, 0, buffer.getNumSamples());
-    }
+GliderEngine::Parameters GliderAudioProcessor::getEngineParameters() const
+{
+    GliderEngine::Parameters parameters;
+    parameters.attack = parameterManager.getAttack();
+    parameters.decay = parameterManager.getDecay();
+    parameters.sustain = parameterManager.getSustain();
+    parameters.release = parameterManager.getRelease();
+    parameters.masterGainDb = parameterManager.getSampleGain();
+    parameters.voiceCount = parameterManager.getVoiceCount();
+    parameters.glideTimeMs = parameterManager.getGlideTime();
+    parameters.glideSteps = parameterManager.getGlideSteps();
+    parameters.glideMode = parameterManager.getGlideMode();
+    parameters.glideSlew = parameterManager.getGlideSlew();
+    parameters.legato = parameterManager.isLegatoEnabled();
+    parameters.oversamplingIndex = parameterManager.getOversamplingIndex();
+    parameters.oversamplingFilter = parameterManager.getOversamplingFilter();
+    parameters.interpolation = parameterManager.getInterpolation();
+    parameters.transpose = parameterManager.getTranspose();
+    parameters.fineTune = parameterManager.getFineTune();
+    parameters.sampleChain = parameterManager.getSampleChain();
+    return parameters;
 }
 
+
 juce::AudioProcessorEditor* GliderAudioProcessor::createEditor()
 {
     return new PluginEditor(*this);
@@ -565,18 +194,40 @@ void GliderAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
     auto state = parameterManager.getAPVTS().copyState();
     std::unique_ptr<juce::XmlElement> xml(state.createXml());
 
-    // Save sample bank information
+    // Save sample bank information from one snapshot, so a concurrent edit can't tear it
+    const auto sampleBank = sampleManager.getBank();
     auto* sampleBankElement = xml->createNewChildElement("SampleBank");
-    int sampleCount = sampleManager.getSampleCount();
-    sampleBankElement->setAttribute("count", sampleCount);
-
-    for (int i = 0; i < sampleCount; ++i)
+    sampleBankElement->setAttribute("count", sampleBank->size());
+
+    const auto conditioning = sampleManager.getConditioning();
+    auto* conditioningElement = sampleBankElement->createNewChildElement("Conditioning");
+    conditioningElement->setAttribute("enabled", conditioning.enabled);
+    conditioningElement->setAttribute("trimSilence", conditioning.trimSilence);
+    conditioningElement->setAttribute("silenceThresholdDb", conditioning.silenceThresholdDb);
+    conditioningElement->setAttribute("removeDc", conditioning.removeDc);
+    conditioningElement->setAttribute("normalisation", static_cast<int>(conditioning.normalisation));
+    conditioningElement->setAttribute("targetDb", conditioning.targetDb);
+    conditioningElement->setAttribute("collapseDualMono", conditioning.collapseDualMono);
+
+    for (const auto& sample : sampleBank->getSamples())
     {
         auto* sampleElement = sampleBankElement->createNewChildElement("Sample");
-        sampleElement->setAttribute("path", sampleManager.getSamplePath(i));
-        sampleElement->setAttribute("name", sampleManager.getSampleName(i));
-        sampleElement->setAttribute("gain", sampleManager.getSampleGain(i));
-        sampleElement->setAttribute("transpose", sampleManager.getSampleTranspose(i));
+        sampleElement->setAttribute("path", sample.path);
+        sampleElement->setAttribute("name", sample.name);
+        sampleElement->setAttribute("gain", sample.gain);
+        sampleElement->setAttribute("transpose", sample.transpose);
+        sampleElement->setAttribute("start", sample.loop.start);
+        sampleElement->setAttribute("end", sample.loop.end);
+        sampleElement->setAttribute("loopMode", static_cast<int>(sample.loop.mode));
+        sampleElement->setAttribute("loopStart", sample.loop.loopStart);
+        sampleElement->setAttribute("loopEnd", sample.loop.loopEnd);
+        sampleElement->setAttribute("loopCrossfade", sample.loop.crossfade);
+        sampleElement->setAttribute("rootNote", sample.mapping.rootNote);
+        sampleElement->setAttribute("lowNote", sample.mapping.lowNote);
+        sampleElement->setAttribute("highNote", sample.mapping.highNote);
+        sampleElement->setAttribute("lowVelocity", sample.mapping.lowVelocity);
+        sampleElement->setAttribute("highVelocity", sample.mapping.highVelocity);
+        sampleElement->setAttribute("roundRobinGroup", sample.mapping.roundRobinGroup);
     }
 
     copyXmlToBinary(*xml, destData);
@@ -584,6 +235,8 @@ void GliderAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 
 void GliderAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    ESKILATOR_TRACE_SCOPE("setStateInformation", "state");
+
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
 
     if (xmlState.get() != nullptr)
@@ -597,37 +250,63 @@ void GliderAudioProcessor::setStateInformation(const void* data, int sizeInBytes
         auto* sampleBankElement = xmlState->getChildByName("SampleBank");
         if (sampleBankElement != nullptr)
         {
-            // Clear existing samples first
-            sampleManager.clearSampleBank();
+            // Conditioning applies to the loads below (states from before it have it off)
+            ConditioningSettings conditioning;
+            if (auto* conditioningElement = sampleBankElement->getChildByName("Conditioning"))
+            {
+                conditioning.enabled = conditioningElement->getBoolAttribute("enabled", conditioning.enabled);
+                conditioning.trimSilence = conditioningElement->getBoolAttribute("trimSilence", conditioning.trimSilence);
+                conditioning.silenceThresholdDb = static_cast<float>(conditioningElement->getDoubleAttribute("silenceThresholdDb", conditioning.silenceThresholdDb));
+                conditioning.removeDc = conditioningElement->getBoolAttribute("removeDc", conditioning.removeDc);
+                conditioning.normalisation = static_cast<ConditioningSettings::Normalisation>(
+                    juce::jlimit(0, 2, conditioningElement->getIntAttribute("normalisation", static_cast<int>(conditioning.normalisation))));
+                conditioning.targetDb = static_cast<float>(conditioningElement->getDoubleAttribute("targetDb", conditioning.targetDb));
+                conditioning.collapseDualMono = conditioningElement->getBoolAttribute("collapseDualMono", conditioning.collapseDualMono);
+            }
+            sampleManager.setConditioning(conditioning);
 
-            // Load each saved sample
-            for (auto* sampleElement : sampleBankElement->getChildIterator())
+            // The saved entries; samples without a path and the built-in sample are not restored
+            std::vector<SampleState> sampleStates;
+            for (auto* sampleElement : sampleBankElement->getChildWithTagNameIterator("Sample"))
             {
-                juce::String samplePath = sampleElement->getStringAttribute("path");
+                SampleState sampleState;
+                sampleState.path = sampleElement->getStringAttribute("path");
+                if (sampleState.path.isEmpty() || sampleState.path == "Built-in")
+                    continue;
 
-                // Only load samples that have a valid path and aren't the built-in sample
-                if (samplePath.isNotEmpty() && samplePath != "Built-in")
+                sampleState.gain = static_cast<float>(sampleElement->getDoubleAttribute("gain", 0.0));
+                sampleState.transpose = static_cast<float>(sampleElement->getDoubleAttribute("transpose", 0.0));
+
+                // Playback points (states from before loops keep the file's own loop)
+                sampleState.hasLoop = sampleElement->hasAttribute("loopMode");
+                if (sampleState.hasLoop)
                 {
-                    juce::File sampleFile(samplePath);
-                    if (sampleFile.existsAsFile())
-                    {
-                        // Load the sample
-                        if (sampleManager.loadSample(sampleFile, currentSampleRate))
-                        {
-                            // Restore per-sample parameters
-                            int index = sampleManager.getSampleCount() - 1; // Just loaded sample is the last one
-                            sampleManager.setSampleGain(index, sampleElement->getDoubleAttribute("gain", 0.0));
-                            sampleManager.setSampleTranspose(index, sampleElement->getDoubleAttribute("transpose", 0.0));
-                        }
-                    }
+                    auto& loop = sampleState.loop;
+                    loop.start = sampleElement->getIntAttribute("start", loop.start);
+                    loop.end = sampleElement->getIntAttribute("end", loop.end);
+                    loop.mode = static_cast<SampleLoop::Mode>(juce::jlimit(0, 2, sampleElement->getIntAttribute("loopMode")));
+                    loop.loopStart = sampleElement->getIntAttribute("loopStart", loop.loopStart);
+                    loop.loopEnd = sampleElement->getIntAttribute("loopEnd", loop.loopEnd);
+                    loop.crossfade = sampleElement->getIntAttribute("loopCrossfade", loop.crossfade);
                 }
-            }
 
-            // If no samples were loaded, load the default sample
-            if (!sampleManager.hasSample())
-            {
-                loadDefaultSample(currentSampleRate);
+                // Keymap (states from before keymaps get the full-range default)
+                auto& mapping = sampleState.mapping;
+                mapping.rootNote = sampleElement->getIntAttribute("rootNote", mapping.rootNote);
+                mapping.lowNote = sampleElement->getIntAttribute("lowNote", mapping.lowNote);
+                mapping.highNote = sampleElement->getIntAttribute("highNote", mapping.highNote);
+                mapping.lowVelocity = sampleElement->getIntAttribute("lowVelocity", mapping.lowVelocity);
+                mapping.highVelocity = sampleElement->getIntAttribute("highVelocity", mapping.highVelocity);
+                mapping.roundRobinGroup = sampleElement->getIntAttribute("roundRobinGroup", mapping.roundRobinGroup);
+
+                sampleStates.push_back(sampleState);
             }
+
+            // Samples whose files are unchanged keep their audio, so undo, A/B compare and
+            // preset browsing only reload what actually differs, and the bank is swapped in
+            // one step without interrupting playback. When no samples are restored, the
+            // default sample is part of that step.
+            sampleManager.restoreBank(sampleStates, engine.getSampleRate());
         }
     }
 
@@ -640,7 +319,7 @@ void GliderAudioProcessor::setStateInformation(const void* data, int sizeInBytes
 
 void GliderAudioProcessor::loadSample(const juce::File& audioFile)
 {
-    sampleManager.loadSample(audioFile, currentSampleRate);
+    sampleManager.loadSample(audioFile, engine.getSampleRate());
 }
 
 void GliderAudioProcessor::loadDefaultSample(double sampleRate)
@@ -656,24 +335,22 @@ juce::String GliderAudioProcessor::getCurrentSampleName() const
 
 double GliderAudioProcessor::getSampleDuration(int index) const
 {
-    if (!sampleManager.hasSampleAtIndex(index))
+    const auto sampleBank = sampleManager.getBank();
+    if (!sampleBank->isValidIndex(index))
         return 0.0;
 
-    const auto& buffer = sampleManager.getSampleBuffer(index);
-    double sampleRate = sampleManager.getOriginalSampleRate(index);
+    const auto& sample = (*sampleBank)[index];
+    double sampleRate = sample.originalSampleRate;
 
     if (sampleRate <= 0.0)
         return 0.0;
 
-    return static_cast<double>(buffer.getNumSamples()) / sampleRate;
+    return static_cast<double>(sample.buffer->getNumSamples()) / sampleRate;
 }
 
-const juce::AudioBuffer<float>* GliderAudioProcessor::getSampleBufferForDisplay(int index) const
+std::shared_ptr<const juce::AudioBuffer<float>> GliderAudioProcessor::getSampleBufferForDisplay(int index) const
 {
-    if (!sampleManager.hasSampleAtIndex(index))
-        return nullptr;
-
-    return &sampleManager.getSampleBuffer(index);
+    return sampleManager.getSampleBuffer(index);
 }
 
 void GliderAudioProcessor::removeSample(int index)
@@ -688,128 +365,7 @@ void GliderAudioProcessor::clearSampleBank()
 
 bool GliderAudioProcessor::reloadSampleFromPath()
 {
-    return sampleManager.reloadSampleFromPath(currentSampleRate);
-}
-
-int GliderAudioProcessor::allocateVoice()
-{
-    int currentVoiceCount = getVoiceCount();
-    
-    logger.log("allocateVoice() called - VoiceCount=" + juce::String(currentVoiceCount) + 
-              ", Voice0 active=" + juce::String(sampleVoices[0].isActive ? "true" : "false"));
-    
-    // First, try to find an inactive voice (works for both mono and poly)
-    for (int i = 0; i < currentVoiceCount && i < MAX_VOICES; ++i)
-    {
-        if (!sampleVoices[i].isActive)
-        {
-            logger.log("Found inactive voice " + juce::String(i) + " for allocation");
-            return i;
-        }
-    }
-    
-    // If no inactive voices, steal the oldest one within the allowed voice count
-    int oldestVoice = 0;
-    juce::uint64 oldestTime = sampleVoices[0].voiceStartTime;
-    
-    for (int i = 1; i < currentVoiceCount && i < MAX_VOICES; ++i)
-    {
-        if (sampleVoices[i].voiceStartTime < oldestTime)
-        {
-            oldestTime = sampleVoices[i].voiceStartTime;
-            oldestVoice = i;
-        }
-    }
-    
-    // CROSSFADE DISABLED - immediately deactivate stolen voice
-    auto& stolenVoice = sampleVoices[oldestVoice];
-    if (stolenVoice.isActive)
-    {
-        logger.log("Voice " + juce::String(oldestVoice) + " stolen and deactivated");
-        stolenVoice.isActive = false;
-        stolenVoice.isGliding = false;
-    }
-
-    return oldestVoice;
-}
-
-void GliderAudioProcessor::startVoice(int voiceIndex, float velocity, float pitch)
-{
-    if (voiceIndex < 0 || voiceIndex >= MAX_VOICES)
-        return;
-
-    auto& voice = sampleVoices[voiceIndex];
-
-    // Debug logging for pitch
-    logger.log("startVoice - Input pitch: " + juce::String(pitch) +
-              ", Velocity: " + juce::String(velocity));
-
-    // Initialize voice parameters (like vst-test2)
-    voice.samplePosition = 0;
-    voice.phaseAccumulator = 0.0;  // Initialize phase accumulator for continuous reading
-    voice.velocity = juce::jlimit(0.0f, 1.0f, velocity); // Store and clamp velocity
-    
-    // Get current sample index and apply per-sample transpose (like vst-test2)
-    int currentSampleIndex = sampleManager.getCurrentSampleIndex();
-    float sampleTranspose = 0.0f; // TODO: Implement getSampleTranspose if needed
-    float finalPitch = pitch + sampleTranspose;  // No pitch limit - allow full range
-
-    // Simple voice initialization - no glide logic here
-    voice.isGliding = false;
-    voice.pitch = finalPitch;
-    voice.cachedPitchRatio = 0.0f; // Force recalculation
-    
-    // Use processed sample buffer if available, otherwise original (like vst-test2)
-    int bufferLength = sampleManager.getCurrentSampleBuffer().getNumSamples();
-    voice.noteOffCountdown = juce::jmin(bufferLength, static_cast<int>(currentSampleRate * 2.0));
-    
-    // Initialize voice and reset all glide state
-    voice.isActive = true;
-    voice.isGliding = false;
-    voice.glideCurrentStep = 0;
-    voice.glideSampleCounter = 0;
-    voice.cachedPitchRatio = 0.0f; // Force recalculation
-
-    // ENVELOPE DISABLED - no envelope initialization needed
-    // CROSSFADE DISABLED - no crossfade state initialization needed
-
-    // Debug logging for voice start
-    logger.log("Voice " + juce::String(voiceIndex) + " STARTED - Velocity=" + juce::String(velocity) +
-              ", Pitch=" + juce::String(finalPitch) +
-              ", NoteOffCountdown=" + juce::String(voice.noteOffCountdown));
-    
-    // Track when this voice started for voice stealing (like vst-test2)
-    voice.voiceStartTime = ++voiceAllocationCounter;
-}
-
-void GliderAudioProcessor::parameterChanged(const juce::String& parameterID, float newValue)
-{
-    // Handle parameter changes if needed
-    logger.log("Parameter changed: " + parameterID + " = " + juce::String(newValue));
-
-    // Update ADSR parameters when they change
-    if (parameterID == "attack" || parameterID == "decay" ||
-        parameterID == "sustain" || parameterID == "release")
-    {
-        // Update ADSR for voice 0 (monophonic)
-        juce::ADSR::Parameters adsrParams;
-        adsrParams.attack = getAttack();
-        adsrParams.decay = getDecay();
-        adsrParams.sustain = getSustain();
-        adsrParams.release = getRelease();
-
-        sampleVoices[0].adsr.setParameters(adsrParams);
-
-        logger.log("ADSR updated - A:" + juce::String(adsrParams.attack) +
-                  " D:" + juce::String(adsrParams.decay) +
-                  " S:" + juce::String(adsrParams.sustain) +
-                  " R:" + juce::String(adsrParams.release));
-    }
-}
-
-void GliderAudioProcessor::updateParametersFromUI()
-{
-    // Update cached parameter values if needed
+    return sampleManager.reloadSampleFromPath(engine.getSampleRate());
 }
 
 juce::AudioProcessor::BusesProperties GliderAudioProcessor::getBusesLayout()
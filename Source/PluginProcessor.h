@@ -2,20 +2,24 @@
 
 #include <JuceHeader.h>
 #include <functional>
-#include "PluginLogger.h"
-#include "SampleManager.h"
+#include "GliderEngine.h"
 #include "ParameterManager.h"
+#include "InstrumentationReader.h"
 
-class GliderAudioProcessor : public juce::AudioProcessor,
-                                     private juce::AudioProcessorValueTreeState::Listener
+// Plugin adapter over GliderEngine: APVTS parameters, host MIDI and buses, state and
+// latency reporting. All rendering happens in the engine.
+class GliderAudioProcessor : public juce::AudioProcessor
 {
+    // Declared first: the logger, sample bank and instrumentation references point into it
+    GliderEngine engine;
+
 public:
 
     GliderAudioProcessor();
     ~GliderAudioProcessor() override;
     
-    // Logger instance
-    PluginLogger logger;
+    // Logger instance (owned by the engine)
+    PluginLogger& logger { engine.getLogger() };
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
@@ -23,6 +27,8 @@ public:
     bool isBusesLayoutSupported(const BusesLayout& busesLayout) const override;
 
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -65,12 +71,25 @@ public:
     float getSampleGain(int index) const { return sampleManager.getSampleGain(index); }
     void setSampleTranspose(int index, float semitones) { sampleManager.setSampleTranspose(index, semitones); }
     float getSampleTranspose(int index) const { return sampleManager.getSampleTranspose(index); }
+    void setSampleMapping(int index, const SampleMapping& mapping) { sampleManager.setSampleMapping(index, mapping); }
+    SampleMapping getSampleMapping(int index) const { return sampleManager.getSampleMapping(index); }
+    void setSampleLoop(int index, const SampleLoop& loop) { sampleManager.setSampleLoop(index, loop); }
+    SampleLoop getSampleLoop(int index) const { return sampleManager.getSampleLoop(index); }
+
+    // Import conditioning (saved with the session, applied to samples loaded afterwards)
+    void setSampleConditioning(const ConditioningSettings& settings) { sampleManager.setConditioning(settings); }
+    ConditioningSettings getSampleConditioning() const { return sampleManager.getConditioning(); }
+    ConditioningReport getSampleConditioningReport(int index) const { return sampleManager.getConditioningReport(index); }
+
+    // Load-time analysis: waveform overview and detected root key
+    std::shared_ptr<const WaveformPeaks> getSampleWaveform(int index = 0) const { return sampleManager.getSamplePeaks(index); }
+    int getDetectedRootNote(int index) const { return sampleManager.getDetectedRootNote(index); }
     
     // Get current sample information
     int getCurrentSampleIndex() const { return sampleManager.getCurrentSampleIndex(); }
     juce::String getCurrentSampleName() const;
     double getSampleDuration(int index = 0) const; // Get duration in seconds
-    const juce::AudioBuffer<float>* getSampleBufferForDisplay(int index = 0) const;
+    std::shared_ptr<const juce::AudioBuffer<float>> getSampleBufferForDisplay(int index = 0) const;
     
     // State change callback
     std::function<void()> onStateRestored;
@@ -96,119 +115,54 @@ public:
     // Glide controls
     float getGlideTime() const { return parameterManager.getGlideTime(); }
     int getGlideSteps() const { return parameterManager.getGlideSteps(); }
+    ParameterManager::GlideMode getGlideMode() const { return parameterManager.getGlideMode(); }
+    float getGlideSlew() const { return parameterManager.getGlideSlew(); }
+    bool isLegatoEnabled() const { return parameterManager.isLegatoEnabled(); }
 
     // Transpose control
     float getTranspose() const { return parameterManager.getTranspose(); }
     float getFineTune() const { return parameterManager.getFineTune(); }
 
     // Get current sample rate
-    double getSampleRate() const { return currentSampleRate; }
-    
+    double getSampleRate() const { return engine.getSampleRate(); }
 
-    
-    // Voice management methods
-    int allocateVoice(); // Returns voice index, with proper voice stealing
-    void startVoice(int voiceIndex, float velocity, float pitch = 0.0f); // Start a voice with current sample and velocity
+    // Kernel instruction set - the override (for testing) takes effect on the next prepareToPlay
+    void setInstructionSetOverride(KernelDispatch::InstructionSet instructionSet) { engine.setInstructionSetOverride(instructionSet); }
+    KernelDispatch::InstructionSet getActiveInstructionSet() const { return engine.getActiveInstructionSet(); }
+
+    // CPU governor state (safe to read from any thread)
+    CpuGovernor::QualityTier getQualityTier() const { return engine.getQualityTier(); }
+    float getCpuLoad() const { return engine.getCpuLoad(); }
+
+    // Hot-path timing histograms, read out by a background thread
+    const InstrumentationReader& getInstrumentationReader() const { return instrumentationReader; }
+    bool writeTimingReport(const juce::File& file) const { return instrumentationReader.writeReport(file); }
 
-    // AudioProcessorValueTreeState::Listener implementation
-    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    // The voice engine, for tools that drive it directly
+    GliderEngine& getEngine() { return engine; }
 
 private:
-    // Sample-accurate audio rendering
-    void renderAudioSegment(juce::AudioBuffer<float>& buffer, int startSample, int endSample);
+    // Engine parameters from the current APVTS values
+    GliderEngine::Parameters getEngineParameters() const;
 
+    template <typename SampleType>
+    void processBlockInternal(juce::AudioBuffer<SampleType>& buffer, juce::MidiBuffer& midiMessages);
+
+    SampleManager& sampleManager { engine.getSampleManager() };
 
     // Modern parameter management
     ParameterManager parameterManager;
-    
-    // Audio synthesis variables
-    bool noteIsPlaying = false;
-    int noteOffCountdown = 0;
-    int noteStartSample = 0; // Track when within the buffer the note should start
-    double currentSampleRate = 44100.0; // Store sample rate for AU compatibility
-    
-    // ADSR envelope state (legacy enum kept for compatibility)
-    enum class EnvelopeState { Idle, Attack, Decay, Sustain, Release };
-    
-    SampleManager sampleManager;
-    
+
     std::atomic<bool> isPluginReady{false};
-    
-    // Multiple sample voices for overlapping playback
-    struct SampleVoice
-    {
-        int samplePosition = 0;
-        int noteOffCountdown = 0;
-        EnvelopeState currentEnvelopeState = EnvelopeState::Idle;
-        float currentEnvelopeValue = 0.0f;
-        int envelopeSampleCounter = 0;
-        bool isActive = false;
-        juce::uint64 voiceStartTime = 0; // For voice stealing - track when voice started
-        float velocity = 1.0f; // Velocity value for this voice (0.0 to 1.0)
-        float pitch = 0.0f; // Pitch value for this voice (-12.0 to +12.0 semitones)
-        float cachedPitchRatio = 0.0f; // Cache pitch ratio to avoid repeated std::pow() calls
-        float releaseMultiplier = 0.0f; // Cached release multiplier for smooth fadeouts
-        
-        // Voice stealing crossfade
-        bool isBeingStolen = false; // Whether this voice is being faded out due to stealing
-        float stolenFadeOutValue = 1.0f; // Fadeout multiplier for stolen voices
-        int stolenFadeOutSamples = 0; // Counter for stolen voice fadeout
-        int stolenFadeOutDuration = 512; // Duration in samples for stolen voice fadeout (~11.6ms at 44.1kHz)
-        
-        // Glide state for stepped portamento
-        bool isGliding = false;           // Whether this voice is currently gliding
-        float glideStartPitch = 0.0f;     // Starting pitch for glide
-        float glideTargetPitch = 0.0f;    // Target pitch for glide
-        int glideCurrentStep = 0;         // Current step in the glide process
-        int glideTotalSteps = 0;          // Total number of steps for the glide
-        int glideSamplesPerStep = 0;      // Samples per step
-        int glideSampleCounter = 0;       // Counter for current step duration
-
-        // Phase continuity for stepped portamento (prevents clicks)
-        double phaseAccumulator = 0.0;  // Continuous phase position for sample reading
-
-        // Glide crossfade state (prevents clicks when restarting sample)
-        bool isInGlideCrossfade = false;       // Whether voice is crossfading at glide start
-        int glideCrossfadeSampleCount = 0;     // Counter for crossfade progress
-        double glideOldPhaseAccumulator = 0.0; // Old phase position to crossfade from
-        float glideOldPitchRatio = 0.0f;       // Old pitch ratio for old position playback
-        static constexpr int GLIDE_CROSSFADE_LENGTH = 256; // ~5.8ms at 44.1kHz (increased from 64)
-
-        // ADSR envelope using JUCE's built-in class
-        juce::ADSR adsr;  // Exponential envelope with proper legato support
-    };
-    
-    static constexpr int MAX_VOICES = 64; // Allow up to 64 overlapping samples (like vst-test2)
-    std::array<SampleVoice, MAX_VOICES> sampleVoices;
-    juce::uint64 voiceAllocationCounter = 0; // For tracking voice allocation order
-    
-    // All parameters are now managed by APVTS
-    
-    // Parameter update callback
-    void updateParametersFromUI();
-    
-    // ADSR envelope state (legacy - now handled per voice)
-    EnvelopeState currentEnvelopeState = EnvelopeState::Idle;
-    float currentEnvelopeValue = 0.0f;
-    int envelopeSampleCounter = 0;
-    
-    // ADSR envelope parameters
-    float attackTimeSeconds = 0.01f;      // 10ms default
-    float decayTimeSeconds = 0.05f;       // 50ms default
-    float sustainLevelNormalized = 0.7f;  // 70% default
-    float releaseTimeSeconds = 0.1f;      // 100ms default
-    
-    // Sample volume gain control
-    float sampleGainDb = -6.0f; // Default gain
-    
-    // Glide state for monophonic mode
-    float lastMonophonicPitch = 0.0f;     // Last pitch used in monophonic mode
-    bool hasLastPitch = false;            // Whether we have a previous pitch to glide from
-    
+
+    // Hot-path timing histograms of the engine, read by a background thread
+    InstrumentationReader instrumentationReader { engine.getInstrumentation() };
+
+    // Trace file requested through ESKILATOR_TRACE_FILE (tracing builds), written on destruction
+    juce::String traceFilePath;
+
     // Bus layout configuration
     static juce::AudioProcessor::BusesProperties getBusesLayout();
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GliderAudioProcessor)
 };
-
-
@@ -0,0 +1,270 @@
+#include "RealtimeCheck.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#if !defined (__linux__) || !defined (__GLIBC__)
+ #error "The real-time safety checker interposes glibc symbols and only supports Linux"
+#endif
+
+// glibc's allocator entry points, so the interposed versions never depend on dlsym
+extern "C"
+{
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* pointer, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+    void __libc_free(void* pointer);
+}
+
+namespace
+{
+    using RealtimeCheck::Violation;
+
+    // initial-exec TLS lives in the static TLS block, so reading it from inside malloc never allocates
+    __thread int realtimeDepth __attribute__((tls_model("initial-exec"))) = 0;
+    __thread bool isRecording __attribute__((tls_model("initial-exec"))) = false;
+
+    struct Record
+    {
+        Violation violation;
+        int numFrames;
+        void* frames[RealtimeCheck::MAX_BACKTRACE_FRAMES];
+    };
+
+    Record records[RealtimeCheck::MAX_RECORDED_VIOLATIONS];
+    std::atomic<long long> numViolations { 0 };
+    bool abortOnViolation = false;
+
+    using MutexLockFunction = int (*)(pthread_mutex_t*);
+    using OpenFunction = int (*)(const char*, int, ...);
+    using FopenFunction = FILE* (*)(const char*, const char*);
+    using ReadFunction = ssize_t (*)(int, void*, size_t);
+    using WriteFunction = ssize_t (*)(int, const void*, size_t);
+
+    // Resolved lazily: interposed calls can arrive before static initialisation has run
+    template <typename Function>
+    Function resolve(std::atomic<Function>& function, const char* name)
+    {
+        auto resolved = function.load(std::memory_order_acquire);
+        if (resolved == nullptr)
+        {
+            resolved = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+            function.store(resolved, std::memory_order_release);
+        }
+        return resolved;
+    }
+
+    std::atomic<MutexLockFunction> realMutexLock { nullptr };
+    std::atomic<OpenFunction> realOpen { nullptr };
+    std::atomic<FopenFunction> realFopen { nullptr };
+    std::atomic<ReadFunction> realRead { nullptr };
+    std::atomic<WriteFunction> realWrite { nullptr };
+
+    void recordViolation(Violation violation) noexcept
+    {
+        if (realtimeDepth == 0 || isRecording)
+            return;
+
+        // Unwinding and reporting may allocate or lock themselves
+        isRecording = true;
+
+        const long long index = numViolations.fetch_add(1, std::memory_order_relaxed);
+        if (index < RealtimeCheck::MAX_RECORDED_VIOLATIONS)
+        {
+            auto& record = records[index];
+            record.violation = violation;
+            record.numFrames = backtrace(record.frames, RealtimeCheck::MAX_BACKTRACE_FRAMES);
+        }
+
+        if (abortOnViolation)
+        {
+            RealtimeCheck::writeReport(STDERR_FILENO);
+            std::abort();
+        }
+
+        isRecording = false;
+    }
+
+    void writeText(int fileDescriptor, const char* text)
+    {
+        auto writeFunction = resolve(realWrite, "write");
+        if (writeFunction != nullptr)
+            writeFunction(fileDescriptor, text, std::strlen(text));
+    }
+
+    struct Initialiser
+    {
+        Initialiser()
+        {
+            abortOnViolation = std::getenv("ESKILATOR_RT_CHECK_ABORT") != nullptr;
+
+            // The first backtrace() loads the unwinder, which allocates - do it now
+            void* frames[1];
+            backtrace(frames, 1);
+
+            resolve(realMutexLock, "pthread_mutex_lock");
+            resolve(realOpen, "open");
+            resolve(realFopen, "fopen");
+            resolve(realRead, "read");
+            resolve(realWrite, "write");
+
+            std::atexit([]
+            {
+                if (RealtimeCheck::getViolationCount() > 0)
+                    RealtimeCheck::writeReport(STDERR_FILENO);
+            });
+        }
+    };
+
+    const Initialiser initialiser;
+}
+
+namespace RealtimeCheck
+{
+    ScopedRealtimeThread::ScopedRealtimeThread() noexcept
+    {
+        ++realtimeDepth;
+    }
+
+    ScopedRealtimeThread::~ScopedRealtimeThread()
+    {
+        --realtimeDepth;
+    }
+
+    long long getViolationCount() noexcept
+    {
+        return numViolations.load(std::memory_order_relaxed);
+    }
+
+    void writeReport(int fileDescriptor)
+    {
+        const long long total = getViolationCount();
+        const long long recorded = total < MAX_RECORDED_VIOLATIONS ? total : MAX_RECORDED_VIOLATIONS;
+
+        char line[160];
+        std::snprintf(line, sizeof(line), "Real-time safety check: %lld violation(s) on the audio thread\n", total);
+        writeText(fileDescriptor, line);
+
+        for (long long i = 0; i < recorded; ++i)
+        {
+            const auto& record = records[i];
+            std::snprintf(line, sizeof(line), "\n#%lld %s\n", i + 1, getName(record.violation));
+            writeText(fileDescriptor, line);
+            backtrace_symbols_fd(record.frames, record.numFrames, fileDescriptor);
+        }
+    }
+
+    const char* getName(Violation violation) noexcept
+    {
+        switch (violation)
+        {
+            case Violation::Allocation:     return "allocation";
+            case Violation::Deallocation:   return "deallocation";
+            case Violation::MutexLock:      return "mutex lock";
+            case Violation::FileOpen:       return "file open";
+            case Violation::FileRead:       return "file read";
+            case Violation::FileWrite:      return "file write";
+            default:                        return "unknown";
+        }
+    }
+}
+
+// Interposed symbols - they record, then forward to glibc
+extern "C"
+{
+    void* malloc(size_t size) noexcept
+    {
+        recordViolation(Violation::Allocation);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) noexcept
+    {
+        recordViolation(Violation::Allocation);
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size) noexcept
+    {
+        recordViolation(Violation::Allocation);
+        return __libc_realloc(pointer, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size) noexcept
+    {
+        recordViolation(Violation::Allocation);
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** result, size_t alignment, size_t size) noexcept
+    {
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0 || alignment % sizeof(void*) != 0)
+            return EINVAL;
+
+        recordViolation(Violation::Allocation);
+        void* pointer = __libc_memalign(alignment, size);
+        if (pointer == nullptr)
+            return ENOMEM;
+
+        *result = pointer;
+        return 0;
+    }
+
+    void free(void* pointer) noexcept
+    {
+        if (pointer != nullptr)
+            recordViolation(Violation::Deallocation);
+
+        __libc_free(pointer);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+    {
+        recordViolation(Violation::MutexLock);
+        return resolve(realMutexLock, "pthread_mutex_lock")(mutex);
+    }
+
+    int open(const char* path, int flags, ...)
+    {
+        recordViolation(Violation::FileOpen);
+
+        mode_t mode = 0;
+        if ((flags & O_CREAT) != 0 || (flags & O_TMPFILE) == O_TMPFILE)
+        {
+            va_list arguments;
+            va_start(arguments, flags);
+            mode = static_cast<mode_t>(va_arg(arguments, int));
+            va_end(arguments);
+        }
+
+        return resolve(realOpen, "open")(path, flags, mode);
+    }
+
+    FILE* fopen(const char* path, const char* mode)
+    {
+        recordViolation(Violation::FileOpen);
+        return resolve(realFopen, "fopen")(path, mode);
+    }
+
+    ssize_t read(int fileDescriptor, void* buffer, size_t count)
+    {
+        recordViolation(Violation::FileRead);
+        return resolve(realRead, "read")(fileDescriptor, buffer, count);
+    }
+
+    ssize_t write(int fileDescriptor, const void* buffer, size_t count)
+    {
+        recordViolation(Violation::FileWrite);
+        return resolve(realWrite, "write")(fileDescriptor, buffer, count);
+    }
+}
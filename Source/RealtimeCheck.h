@@ -0,0 +1,58 @@
+#pragma once
+
+// Debug real-time safety checker (Linux only, CMake option ESKILATOR_RT_CHECKS).
+//
+// ESKILATOR_REALTIME_SCOPE() marks the calling thread as real-time until the end of
+// the enclosing scope. RealtimeCheck.cpp interposes malloc / free (and with them
+// operator new / delete), pthread mutex locks and file open / read / write; any of
+// them called from a marked thread is recorded with a backtrace. Violations are
+// printed to stderr at exit, or abort() immediately when ESKILATOR_RT_CHECK_ABORT
+// is set, so a debugger or core dump shows the offending stack.
+//
+// Interposition only works when the checker is linked into the executable (the
+// Standalone build, a test rig or a benchmark). Without the option the macro
+// compiles to nothing and RealtimeCheck.cpp is not built.
+namespace RealtimeCheck
+{
+    enum class Violation
+    {
+        Allocation,
+        Deallocation,
+        MutexLock,
+        FileOpen,
+        FileRead,
+        FileWrite
+    };
+
+    static constexpr int MAX_RECORDED_VIOLATIONS = 256;
+    static constexpr int MAX_BACKTRACE_FRAMES = 24;
+
+    // Marks the calling thread as real-time for its lifetime (nests)
+    class ScopedRealtimeThread
+    {
+    public:
+        ScopedRealtimeThread() noexcept;
+        ~ScopedRealtimeThread();
+
+        ScopedRealtimeThread(const ScopedRealtimeThread&) = delete;
+        ScopedRealtimeThread& operator=(const ScopedRealtimeThread&) = delete;
+    };
+
+    // Violations so far (including any beyond MAX_RECORDED_VIOLATIONS)
+    long long getViolationCount() noexcept;
+
+    // Write the recorded violations and their backtraces to a file descriptor.
+    // Call while no thread is inside a real-time scope.
+    void writeReport(int fileDescriptor);
+
+    const char* getName(Violation violation) noexcept;
+}
+
+#define ESKILATOR_REALTIME_JOIN_(a, b) a##b
+#define ESKILATOR_REALTIME_JOIN(a, b) ESKILATOR_REALTIME_JOIN_(a, b)
+
+#if ESKILATOR_ENABLE_RT_CHECKS
+ #define ESKILATOR_REALTIME_SCOPE() const RealtimeCheck::ScopedRealtimeThread ESKILATOR_REALTIME_JOIN(realtimeScope, __LINE__)
+#else
+ #define ESKILATOR_REALTIME_SCOPE() do {} while (false)
+#endif
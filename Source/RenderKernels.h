@@ -0,0 +1,409 @@
+#pragma once
+
+#include <cstdint>
+#include "FixedPointPhase.h"
+
+// Block renderers for a single sample voice.
+// The specialised kernels are instantiated per source layout, output layout,
+// crossfade, glide and morph state so the inner loop carries no data-dependent
+// branches. The caller (see GliderEngine::renderAudioSegment) splits
+// the block so that a kernel never reads past the end of the source, never
+// runs past the end of a crossfade and never crosses a glide step boundary.
+// Anything that does not fit those rules goes through renderVoiceGeneric().
+namespace RenderKernels
+{
+    static constexpr int MAX_CHANNELS = 2;
+
+    // Read-only view of the sample being played. While morphing, a second sample is read
+    // at the same phase and blended in by morphAmount; numFrames is then the shorter length.
+    // The restart crossfade reads the outgoing sample (fadeOut*) at the old phase, unmorphed.
+    struct Source
+    {
+        const float* channels[MAX_CHANNELS] = { nullptr, nullptr };
+        int numChannels = 0;
+        std::uint32_t numFrames = 0;
+
+        const float* morphChannels[MAX_CHANNELS] = { nullptr, nullptr };
+        float morphAmount = 0.0f;   // 0 = first sample only
+
+        const float* fadeOutChannels[MAX_CHANNELS] = { nullptr, nullptr };
+        std::uint32_t fadeOutNumFrames = 0;
+    };
+
+    // Voice state advanced by the kernels
+    struct VoiceState
+    {
+        FixedPointPhase::Phase phase = 0;
+        FixedPointPhase::Phase phaseIncrement = 0;
+
+        // Restart crossfade (old playback position fading out)
+        FixedPointPhase::Phase oldPhase = 0;
+        FixedPointPhase::Phase oldPhaseIncrement = 0;
+        int crossfadeCount = 0;
+
+        // Continuous glide: ratio multiplied by ratioIncrement every frame
+        double ratio = 1.0;
+        double ratioIncrement = 1.0;
+    };
+
+    // Equal-power crossfade table: fade-in reads [count], fade-out reads [length - count]
+    struct CrossfadeTable
+    {
+        const float* gains = nullptr;
+        int length = 0;
+    };
+
+    using KernelFunction = void (*)(const Source&, float* const*, int, const float*, VoiceState&, const CrossfadeTable&);
+
+    // Windowed-sinc interpolation (offline quality): SINC_PHASES + 1 rows of SINC_TAPS
+    // coefficients, row p holding the filter for a fractional position of p / SINC_PHASES.
+    // Tap k weights source sample (index + k - SINC_TAPS / 2 + 1).
+    static constexpr int SINC_TAPS = 16;
+    static constexpr int SINC_PHASE_BITS = 9;
+    static constexpr int SINC_PHASES = 1 << SINC_PHASE_BITS;
+
+    struct SincTable
+    {
+        const float* coefficients = nullptr;
+    };
+
+// Functions get per-instruction-set symbols (see FixedPointPhase.h / KernelDispatch.h)
+inline namespace ESKILATOR_KERNEL_ISA
+{
+
+    //==============================================================================
+    // Interpolation helpers
+
+    // Unchecked linear interpolation - index + 1 must be inside the source
+    inline float readLinear(const float* data, FixedPointPhase::Phase position)
+    {
+        const std::uint32_t index = FixedPointPhase::getIndex(position);
+        const float fraction = FixedPointPhase::getFraction(position);
+        const float sample1 = data[index];
+        const float sample2 = data[index + 1];
+        return sample1 + (sample2 - sample1) * fraction;
+    }
+
+    // Two-point reads of both samples at the same position, blended by amount
+    inline float readLinearMorph(const float* data, const float* morphData, FixedPointPhase::Phase position, float amount)
+    {
+        const float value = readLinear(data, position);
+        return value + (readLinear(morphData, position) - value) * amount;
+    }
+
+    // Linear interpolation with silence outside the sample bounds
+    inline float readLinearClamped(const float* data, FixedPointPhase::Phase position, std::uint32_t numFrames)
+    {
+        const std::uint32_t index = FixedPointPhase::getIndex(position);
+        if (index >= numFrames)
+            return 0.0f;
+
+        if (index + 1 >= numFrames)
+            return data[index];
+
+        return readLinear(data, position);
+    }
+
+    // Windowed-sinc read with zero padding outside the sample, rows blended by the remaining fraction
+    inline float readSinc(const float* data, FixedPointPhase::Phase position, std::uint32_t numFrames, const SincTable& table)
+    {
+        constexpr int firstOffset = 1 - SINC_TAPS / 2;
+        constexpr int rowShift = FixedPointPhase::FRACTION_BITS - SINC_PHASE_BITS;
+
+        const std::int64_t index = static_cast<std::int64_t>(FixedPointPhase::getIndex(position));
+        const auto fraction = static_cast<std::uint32_t>(position & FixedPointPhase::FRACTION_MASK);
+        const std::uint32_t row = fraction >> rowShift;
+        const float rowBlend = static_cast<float>(fraction & ((1u << rowShift) - 1)) * (1.0f / static_cast<float>(1u << rowShift));
+
+        const float* coefficients1 = table.coefficients + row * SINC_TAPS;
+        const float* coefficients2 = coefficients1 + SINC_TAPS;
+
+        float sum1 = 0.0f;
+        float sum2 = 0.0f;
+        const std::int64_t first = index + firstOffset;
+        if (first >= 0 && first + SINC_TAPS <= static_cast<std::int64_t>(numFrames))
+        {
+            const float* samples = data + first;
+            for (int tap = 0; tap < SINC_TAPS; ++tap)
+            {
+                sum1 += samples[tap] * coefficients1[tap];
+                sum2 += samples[tap] * coefficients2[tap];
+            }
+        }
+        else
+        {
+            for (int tap = 0; tap < SINC_TAPS; ++tap)
+            {
+                const std::int64_t sampleIndex = first + tap;
+                if (sampleIndex >= 0 && sampleIndex < static_cast<std::int64_t>(numFrames))
+                {
+                    sum1 += data[sampleIndex] * coefficients1[tap];
+                    sum2 += data[sampleIndex] * coefficients2[tap];
+                }
+            }
+        }
+
+        return sum1 + (sum2 - sum1) * rowBlend;
+    }
+
+    // Number of frames that can be advanced before a two-point read would leave the source
+    inline int framesBeforeEnd(FixedPointPhase::Phase phase, FixedPointPhase::Phase maxIncrement,
+                               std::uint32_t numFrames, int limit)
+    {
+        if (numFrames < 2 || maxIncrement == 0)
+            return 0;
+
+        // Reads happen after the advance, so every read position must stay below (numFrames - 1)
+        const FixedPointPhase::Phase readLimit = static_cast<FixedPointPhase::Phase>(numFrames - 1) << FixedPointPhase::FRACTION_BITS;
+        if (phase >= readLimit)
+            return 0;
+
+        const FixedPointPhase::Phase frames = (readLimit - 1 - phase) / maxIncrement;
+        return frames < static_cast<FixedPointPhase::Phase>(limit) ? static_cast<int>(frames) : limit;
+    }
+
+    // Same bound for reads that happen before the advance (the fading-out restart position)
+    inline int framesBeforeEndFromCurrent(FixedPointPhase::Phase phase, FixedPointPhase::Phase increment,
+                                          std::uint32_t numFrames, int limit)
+    {
+        if (numFrames < 2)
+            return 0;
+
+        const FixedPointPhase::Phase readLimit = static_cast<FixedPointPhase::Phase>(numFrames - 1) << FixedPointPhase::FRACTION_BITS;
+        if (phase >= readLimit)
+            return 0;
+
+        if (increment == 0)
+            return limit;
+
+        const FixedPointPhase::Phase frames = (readLimit - 1 - phase) / increment + 1;
+        return frames < static_cast<FixedPointPhase::Phase>(limit) ? static_cast<int>(frames) : limit;
+    }
+
+    //==============================================================================
+    // Specialised kernel
+
+    template <int SourceChannels, int OutputChannels, bool Crossfade, bool Gliding, bool Morph>
+    void renderVoice(const Source& source, float* const* outputs, int numFrames,
+                     const float* frameGains, VoiceState& state, const CrossfadeTable& crossfade)
+    {
+        static_assert(SourceChannels >= 1 && SourceChannels <= MAX_CHANNELS, "Unsupported source layout");
+        static_assert(OutputChannels >= 1 && OutputChannels <= MAX_CHANNELS, "Unsupported output layout");
+
+        // Output channel c reads source channel min(c, SourceChannels - 1)
+        const float* const left = source.channels[0];
+        const float* const right = source.channels[SourceChannels - 1];
+        const float* const morphLeft = source.morphChannels[0];
+        const float* const morphRight = source.morphChannels[SourceChannels - 1];
+        const float* const fadeOutLeft = source.fadeOutChannels[0];
+        const float* const fadeOutRight = source.fadeOutChannels[SourceChannels - 1];
+        const float morphAmount = source.morphAmount;
+        float* const outLeft = outputs[0];
+        float* const outRight = outputs[OutputChannels - 1];
+
+        FixedPointPhase::Phase phase = state.phase;
+        FixedPointPhase::Phase phaseIncrement = state.phaseIncrement;
+        FixedPointPhase::Phase oldPhase = state.oldPhase;
+        const FixedPointPhase::Phase oldPhaseIncrement = state.oldPhaseIncrement;
+        double ratio = state.ratio;
+        const double ratioIncrement = state.ratioIncrement;
+        const float* fadeIn = nullptr;
+        const float* fadeOut = nullptr;
+        if constexpr (Crossfade)
+        {
+            fadeIn = crossfade.gains + state.crossfadeCount;
+            fadeOut = crossfade.gains + (crossfade.length - state.crossfadeCount);
+        }
+
+        for (int i = 0; i < numFrames; ++i)
+        {
+            if constexpr (Gliding)
+            {
+                ratio *= ratioIncrement;
+                phaseIncrement = FixedPointPhase::fromDouble(ratio);
+            }
+
+            phase += phaseIncrement;
+
+            // Both samples at the same phase when morphing (second read and blend compiled out otherwise)
+            auto read = [&](const float* data, const float* morphData, FixedPointPhase::Phase position)
+            {
+                if constexpr (Morph)
+                    return readLinearMorph(data, morphData, position, morphAmount);
+                else
+                    return readLinear(data, position);
+            };
+
+            float valueLeft = read(left, morphLeft, phase);
+            float valueRight = (SourceChannels == 2 && OutputChannels == 2) ? read(right, morphRight, phase) : valueLeft;
+
+            if constexpr (Crossfade)
+            {
+                const float gainIn = fadeIn[i];
+                const float gainOut = fadeOut[-i];
+                valueLeft = readLinear(fadeOutLeft, oldPhase) * gainOut + valueLeft * gainIn;
+                if constexpr (SourceChannels == 2 && OutputChannels == 2)
+                    valueRight = readLinear(fadeOutRight, oldPhase) * gainOut + valueRight * gainIn;
+                else
+                    valueRight = valueLeft;
+                oldPhase += oldPhaseIncrement;
+            }
+
+            const float gain = frameGains[i];
+            outLeft[i] = valueLeft * gain;
+            if constexpr (OutputChannels == 2)
+                outRight[i] = valueRight * gain;
+        }
+
+        state.phase = phase;
+        state.phaseIncrement = phaseIncrement;
+        state.ratio = ratio;
+        if constexpr (Crossfade)
+        {
+            state.oldPhase = oldPhase;
+            state.crossfadeCount += numFrames;
+        }
+    }
+
+    //==============================================================================
+    // Generic path: runtime layout/state, bounds-checked reads, any output count
+
+    inline void renderVoiceGeneric(const Source& source, float* const* outputs, int numOutputChannels, int numFrames,
+                                   const float* frameGains, VoiceState& state, bool isCrossfading, bool isGliding,
+                                   const CrossfadeTable& crossfade)
+    {
+        for (int i = 0; i < numFrames; ++i)
+        {
+            if (isGliding)
+            {
+                state.ratio *= state.ratioIncrement;
+                state.phaseIncrement = FixedPointPhase::fromDouble(state.ratio);
+            }
+
+            state.phase += state.phaseIncrement;
+
+            const bool crossfadeFrame = isCrossfading && state.crossfadeCount < crossfade.length;
+            const float gainIn = crossfadeFrame ? crossfade.gains[state.crossfadeCount] : 1.0f;
+            const float gainOut = crossfadeFrame ? crossfade.gains[crossfade.length - state.crossfadeCount] : 0.0f;
+
+            for (int channel = 0; channel < numOutputChannels; ++channel)
+            {
+                const int sourceChannel = channel < source.numChannels ? channel : source.numChannels - 1;
+                const int channelIndex = sourceChannel < MAX_CHANNELS ? sourceChannel : MAX_CHANNELS - 1;
+                const float* data = source.channels[channelIndex];
+                const float* morphData = source.morphChannels[channelIndex];
+                const float* fadeOutData = source.fadeOutChannels[channelIndex];
+
+                auto read = [&](FixedPointPhase::Phase position)
+                {
+                    const float sampleValue = readLinearClamped(data, position, source.numFrames);
+                    if (source.morphAmount <= 0.0f)
+                        return sampleValue;
+                    return sampleValue + (readLinearClamped(morphData, position, source.numFrames) - sampleValue) * source.morphAmount;
+                };
+
+                float value = read(state.phase);
+                if (crossfadeFrame)
+                    value = readLinearClamped(fadeOutData, state.oldPhase, source.fadeOutNumFrames) * gainOut + value * gainIn;
+
+                outputs[channel][i] = value * frameGains[i];
+            }
+
+            if (crossfadeFrame)
+            {
+                state.oldPhase += state.oldPhaseIncrement;
+                state.crossfadeCount++;
+            }
+        }
+    }
+
+    //==============================================================================
+    // Sinc path: same contract as renderVoiceGeneric, windowed-sinc reads
+
+    inline void renderVoiceSinc(const Source& source, float* const* outputs, int numOutputChannels, int numFrames,
+                                const float* frameGains, VoiceState& state, bool isCrossfading, bool isGliding,
+                                const CrossfadeTable& crossfade, const SincTable& sinc)
+    {
+        for (int i = 0; i < numFrames; ++i)
+        {
+            if (isGliding)
+            {
+                state.ratio *= state.ratioIncrement;
+                state.phaseIncrement = FixedPointPhase::fromDouble(state.ratio);
+            }
+
+            state.phase += state.phaseIncrement;
+
+            const bool crossfadeFrame = isCrossfading && state.crossfadeCount < crossfade.length;
+            const float gainIn = crossfadeFrame ? crossfade.gains[state.crossfadeCount] : 1.0f;
+            const float gainOut = crossfadeFrame ? crossfade.gains[crossfade.length - state.crossfadeCount] : 0.0f;
+
+            for (int channel = 0; channel < numOutputChannels; ++channel)
+            {
+                const int sourceChannel = channel < source.numChannels ? channel : source.numChannels - 1;
+                const int channelIndex = sourceChannel < MAX_CHANNELS ? sourceChannel : MAX_CHANNELS - 1;
+                const float* data = source.channels[channelIndex];
+                const float* morphData = source.morphChannels[channelIndex];
+                const float* fadeOutData = source.fadeOutChannels[channelIndex];
+
+                auto read = [&](FixedPointPhase::Phase position)
+                {
+                    const float sampleValue = readSinc(data, position, source.numFrames, sinc);
+                    if (source.morphAmount <= 0.0f)
+                        return sampleValue;
+                    return sampleValue + (readSinc(morphData, position, source.numFrames, sinc) - sampleValue) * source.morphAmount;
+                };
+
+                float value = read(state.phase);
+                if (crossfadeFrame)
+                    value = readSinc(fadeOutData, state.oldPhase, source.fadeOutNumFrames, sinc) * gainOut + value * gainIn;
+
+                outputs[channel][i] = value * frameGains[i];
+            }
+
+            if (crossfadeFrame)
+            {
+                state.oldPhase += state.oldPhaseIncrement;
+                state.crossfadeCount++;
+            }
+        }
+    }
+
+    //==============================================================================
+    // Dispatcher - picks the specialised kernel once per sub-block
+
+    namespace Detail
+    {
+        template <int SourceChannels, int OutputChannels, bool Crossfade, bool Gliding>
+        constexpr KernelFunction selectMorph(bool morph)
+        {
+            return morph ? &renderVoice<SourceChannels, OutputChannels, Crossfade, Gliding, true>
+                         : &renderVoice<SourceChannels, OutputChannels, Crossfade, Gliding, false>;
+        }
+
+        template <int SourceChannels, int OutputChannels>
+        constexpr KernelFunction selectState(bool crossfade, bool gliding, bool morph)
+        {
+            return crossfade ? (gliding ? selectMorph<SourceChannels, OutputChannels, true, true>(morph)
+                                        : selectMorph<SourceChannels, OutputChannels, true, false>(morph))
+                             : (gliding ? selectMorph<SourceChannels, OutputChannels, false, true>(morph)
+                                        : selectMorph<SourceChannels, OutputChannels, false, false>(morph));
+        }
+    }
+
+    // Returns nullptr for layouts without a specialisation (use renderVoiceGeneric).
+    // Morph kernels read source.morphChannels as well and blend by source.morphAmount.
+    inline KernelFunction getKernel(int sourceChannels, int outputChannels, bool crossfade, bool gliding, bool morph = false)
+    {
+        if (sourceChannels < 1 || outputChannels < 1 || outputChannels > MAX_CHANNELS)
+            return nullptr;
+
+        // Sources with more than two channels only ever feed their first two
+        const bool stereoSource = sourceChannels >= 2;
+        if (outputChannels == 1)
+            return stereoSource ? Detail::selectState<2, 1>(crossfade, gliding, morph) : Detail::selectState<1, 1>(crossfade, gliding, morph);
+
+        return stereoSource ? Detail::selectState<2, 2>(crossfade, gliding, morph) : Detail::selectState<1, 2>(crossfade, gliding, morph);
+    }
+} // inline namespace ESKILATOR_KERNEL_ISA
+}
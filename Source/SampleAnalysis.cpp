@@ -0,0 +1,98 @@
+#include "SampleAnalysis.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr double MIN_FREQUENCY = 40.0;
+    constexpr double MAX_FREQUENCY = 2000.0;
+    constexpr int WINDOW_FRAMES = 2048;
+
+    // YIN: the first lag whose normalised difference dips below this is the period
+    constexpr float PERIODICITY_THRESHOLD = 0.15f;
+}
+
+WaveformPeaks SampleAnalysis::makePeaks(const juce::AudioBuffer<float>& audio)
+{
+    WaveformPeaks peaks;
+    peaks.numChannels = audio.getNumChannels();
+    peaks.numFrames = audio.getNumSamples();
+    peaks.numPeaks = (peaks.numFrames + WaveformPeaks::FRAMES_PER_PEAK - 1) / WaveformPeaks::FRAMES_PER_PEAK;
+
+    const auto size = static_cast<size_t>(peaks.numChannels) * static_cast<size_t>(peaks.numPeaks);
+    peaks.minima.resize(size);
+    peaks.maxima.resize(size);
+
+    for (int channel = 0; channel < peaks.numChannels; ++channel)
+    {
+        const float* source = audio.getReadPointer(channel);
+        for (int peak = 0; peak < peaks.numPeaks; ++peak)
+        {
+            const int start = peak * WaveformPeaks::FRAMES_PER_PEAK;
+            const int length = juce::jmin(WaveformPeaks::FRAMES_PER_PEAK, peaks.numFrames - start);
+            const auto range = juce::FloatVectorOperations::findMinAndMax(source + start, length);
+
+            const auto index = static_cast<size_t>(channel * peaks.numPeaks + peak);
+            peaks.minima[index] = range.getStart();
+            peaks.maxima[index] = range.getEnd();
+        }
+    }
+
+    return peaks;
+}
+
+int SampleAnalysis::detectRootNote(const juce::AudioBuffer<float>& audio, double sampleRate)
+{
+    const int minLag = juce::jmax(2, static_cast<int>(sampleRate / MAX_FREQUENCY));
+    const int maxLag = static_cast<int>(sampleRate / MIN_FREQUENCY);
+    const int numFrames = audio.getNumSamples();
+    if (audio.getNumChannels() == 0 || sampleRate <= 0.0 || numFrames < WINDOW_FRAMES + maxLag)
+        return UNPITCHED;
+
+    // The window starts at the loudest frame, past the onset, and is compared with
+    // itself up to maxLag frames later
+    const float* source = audio.getReadPointer(0);
+    const int loudest = static_cast<int>(std::distance(source, std::max_element(source, source + numFrames,
+                                                                                  [](float a, float b) { return std::abs(a) < std::abs(b); })));
+    const int start = juce::jmin(loudest, numFrames - WINDOW_FRAMES - maxLag);
+    const float* window = source + start;
+
+    // Cumulative-mean-normalised difference, stopping at the first dip below the threshold
+    std::vector<float> difference(static_cast<size_t>(maxLag + 1), 1.0f);
+    double runningSum = 0.0;
+    int period = -1;
+    for (int lag = 1; lag <= maxLag; ++lag)
+    {
+        float sum = 0.0f;
+        for (int i = 0; i < WINDOW_FRAMES; ++i)
+        {
+            const float delta = window[i] - window[i + lag];
+            sum += delta * delta;
+        }
+
+        runningSum += sum;
+        difference[static_cast<size_t>(lag)] = runningSum > 0.0 ? static_cast<float>(sum * lag / runningSum) : 1.0f;
+
+        if (lag > minLag && difference[static_cast<size_t>(lag - 1)] < PERIODICITY_THRESHOLD
+            && difference[static_cast<size_t>(lag - 1)] <= difference[static_cast<size_t>(lag)])
+        {
+            period = lag - 1;
+            break;
+        }
+    }
+
+    if (period < minLag)
+        return UNPITCHED;
+
+    // Parabolic interpolation around the dip for a fractional period
+    const float before = difference[static_cast<size_t>(period - 1)];
+    const float at = difference[static_cast<size_t>(period)];
+    const float after = difference[static_cast<size_t>(period + 1)];
+    const float curvature = before - 2.0f * at + after;
+    const double exactPeriod = period + (curvature > 0.0f ? 0.5 * (before - after) / curvature : 0.0);
+
+    const double frequency = sampleRate / exactPeriod;
+    const int note = static_cast<int>(std::lround(69.0 + 12.0 * std::log2(frequency / 440.0)));
+    return juce::jlimit(0, 127, note);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <vector>
+
+// Waveform overview of a sample: the lowest and highest value of every FRAMES_PER_PEAK
+// frames per channel, enough to draw it at any width without touching the audio.
+struct WaveformPeaks
+{
+    static constexpr int FRAMES_PER_PEAK = 512;
+
+    int numChannels = 0;
+    int numPeaks = 0;
+    int numFrames = 0;
+    std::vector<float> minima;   // numChannels rows of numPeaks
+    std::vector<float> maxima;
+
+    const float* getMinima(int channel) const { return minima.data() + channel * numPeaks; }
+    const float* getMaxima(int channel) const { return maxima.data() + channel * numPeaks; }
+};
+
+// Load-time analysis of decoded samples, run on the loading thread and cached with the
+// sample (see SampleCache)
+namespace SampleAnalysis
+{
+    static constexpr int UNPITCHED = -1;
+
+    WaveformPeaks makePeaks(const juce::AudioBuffer<float>& audio);
+
+    // MIDI note nearest the fundamental of the sample's sustained part, or UNPITCHED when
+    // no clear periodicity is found (YIN over one window, 40 Hz to 2 kHz)
+    int detectRootNote(const juce::AudioBuffer<float>& audio, double sampleRate);
+}
@@ -0,0 +1,408 @@
+#include "SampleCache.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD || JUCE_ANDROID
+ #include <sys/mman.h>
+#endif
+
+namespace
+{
+    constexpr int ENTRY_MAGIC = 0x434b5345;   // "ESKC"
+    constexpr int ENTRY_VERSION = 1;
+    constexpr int DATA_ALIGNMENT = 64;
+
+    // Memory-mapped entry file and the buffer whose channels point into it
+    struct MappedBuffer
+    {
+        MappedBuffer(std::unique_ptr<juce::MemoryMappedFile> mappedFile, float* const* channels, int numChannels, int numFrames)
+            : file(std::move(mappedFile)),
+              buffer(channels, numChannels, numFrames)
+        {
+        }
+
+        std::unique_ptr<juce::MemoryMappedFile> file;
+        juce::AudioBuffer<float> buffer;
+    };
+
+    juce::String makeConditioningTag(const ConditioningSettings& settings)
+    {
+        if (!settings.enabled)
+            return "raw";
+
+        const juce::String description = juce::String(static_cast<int>(settings.trimSilence)) + ":" + juce::String(settings.silenceThresholdDb)
+                                         + ":" + juce::String(static_cast<int>(settings.removeDc)) + ":" + juce::String(static_cast<int>(settings.normalisation))
+                                         + ":" + juce::String(settings.targetDb) + ":" + juce::String(static_cast<int>(settings.collapseDualMono));
+        return juce::String::toHexString(description.hashCode64());
+    }
+
+    std::uint64_t rotateLeft(std::uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    // Four independent 64-bit lanes over 32-byte chunks, then a murmur3-style finaliser
+    std::uint64_t hashBytes(const std::uint8_t* data, size_t size)
+    {
+        constexpr std::uint64_t PRIME_1 = 0x9e3779b185ebca87ULL;
+        constexpr std::uint64_t PRIME_2 = 0xc2b2ae3d27d4eb4fULL;
+
+        std::uint64_t lanes[4] = { PRIME_1, PRIME_2, ~PRIME_1, ~PRIME_2 };
+        size_t offset = 0;
+        for (; offset + 32 <= size; offset += 32)
+        {
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                std::uint64_t word;
+                std::memcpy(&word, data + offset + lane * 8, sizeof(word));
+                lanes[lane] = rotateLeft(lanes[lane] + word * PRIME_2, 31) * PRIME_1;
+            }
+        }
+
+        std::uint64_t hash = static_cast<std::uint64_t>(size);
+        for (auto lane : lanes)
+            hash = rotateLeft(hash ^ lane, 27) * PRIME_1;
+
+        for (; offset < size; ++offset)
+            hash = rotateLeft(hash ^ (data[offset] * PRIME_2), 11) * PRIME_1;
+
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    // Read every page of a mapped range in now, on the calling thread
+    void prefaultPages(const void* data, size_t size)
+    {
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD || JUCE_ANDROID
+        madvise(const_cast<void*>(data), size, MADV_WILLNEED);
+#endif
+
+        // Touching one byte per 4 kB page also covers larger pages
+        constexpr size_t PAGE_STRIDE = 4096;
+        const auto* bytes = static_cast<const volatile std::uint8_t*>(data);
+        std::uint8_t sum = 0;
+        for (size_t offset = 0; offset < size; offset += PAGE_STRIDE)
+            sum = static_cast<std::uint8_t>(sum + bytes[offset]);
+        if (size > 0)
+            sum = static_cast<std::uint8_t>(sum + bytes[size - 1]);
+        juce::ignoreUnused(sum);
+    }
+}
+
+juce::String SampleCache::Key::getEntryName() const
+{
+    return contentHash + "_" + juce::String(juce::roundToInt(sampleRate)) + "_" + conditioningTag + ".eskc";
+}
+
+SampleCache::SampleCache(const juce::File& cacheDirectory, juce::int64 maximumSize)
+    : directory(cacheDirectory),
+      sizeLimit(maximumSize)
+{
+}
+
+std::shared_ptr<SampleCache> SampleCache::getShared()
+{
+    static const std::shared_ptr<SampleCache> shared = [] {
+        const auto setting = juce::SystemStats::getEnvironmentVariable("ESKILATOR_SAMPLE_CACHE", {});
+        if (setting.equalsIgnoreCase("off"))
+            return std::shared_ptr<SampleCache>();
+
+        const auto folder = setting.isNotEmpty() && juce::File::isAbsolutePath(setting)
+                                ? juce::File(setting)
+                                : juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+                                      .getChildFile("Eskilator").getChildFile("SampleCache");
+        return std::make_shared<SampleCache>(folder);
+    }();
+    return shared;
+}
+
+juce::String SampleCache::hashFile(const juce::File& file)
+{
+    juce::MemoryMappedFile mapped(file, juce::MemoryMappedFile::readOnly);
+    if (mapped.getData() == nullptr)
+        return {};
+
+    const auto hash = hashBytes(static_cast<const std::uint8_t*>(mapped.getData()), mapped.getSize());
+    return juce::String::toHexString(static_cast<juce::int64>(hash)).paddedLeft('0', 16);
+}
+
+SampleCache::Key SampleCache::makeKey(const juce::File& sourceFile, double sampleRate, const ConditioningSettings& conditioning)
+{
+    Key key;
+    key.contentHash = getContentHash(sourceFile);
+    key.sampleRate = sampleRate;
+    key.conditioningTag = makeConditioningTag(conditioning);
+    return key;
+}
+
+juce::String SampleCache::getContentHash(const juce::File& sourceFile)
+{
+    const auto path = sourceFile.getFullPathName();
+    const auto size = sourceFile.getSize();
+    const auto modificationTime = sourceFile.getLastModificationTime().toMilliseconds();
+
+    {
+        std::lock_guard<std::mutex> lock(indexMutex);
+        loadIndex();
+
+        const auto found = index.find(path);
+        if (found != index.end() && found->second.size == size && found->second.modificationTime == modificationTime)
+            return found->second.contentHash;
+    }
+
+    // New or changed file: hash it outside the lock
+    const auto contentHash = hashFile(sourceFile);
+    if (contentHash.isEmpty())
+        return {};
+
+    // Written once per load pass (saveIndexIfChanged), not per file
+    std::lock_guard<std::mutex> lock(indexMutex);
+    index[path] = { size, modificationTime, contentHash };
+    indexChanged = true;
+    return contentHash;
+}
+
+void SampleCache::saveIndexIfChanged()
+{
+    std::lock_guard<std::mutex> lock(indexMutex);
+    loadIndex();
+
+    for (auto it = index.begin(); it != index.end();)
+    {
+        if (juce::File(it->first).existsAsFile())
+        {
+            ++it;
+            continue;
+        }
+
+        it = index.erase(it);
+        indexChanged = true;
+    }
+
+    if (!indexChanged)
+        return;
+
+    saveIndex();
+    indexChanged = false;
+}
+
+bool SampleCache::load(const Key& key, Entry& entry)
+{
+    if (key.contentHash.isEmpty())
+        return false;
+
+    const auto file = getEntryFile(key);
+    if (!file.existsAsFile())
+        return false;
+
+    auto mapped = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+    if (mapped->getData() == nullptr)
+        return false;
+
+    const auto* data = static_cast<const char*>(mapped->getData());
+    const auto size = mapped->getSize();
+    juce::MemoryInputStream header(data, size, false);
+
+    if (header.readInt() != ENTRY_MAGIC || header.readInt() != ENTRY_VERSION)
+        return false;
+
+    const int numChannels = header.readInt();
+    const int numFrames = header.readInt();
+    entry.originalSampleRate = header.readDouble();
+    entry.bufferSampleRate = header.readDouble();
+
+    entry.loop.start = header.readInt();
+    entry.loop.end = header.readInt();
+    entry.loop.mode = static_cast<SampleLoop::Mode>(juce::jlimit(0, 2, header.readInt()));
+    entry.loop.loopStart = header.readInt();
+    entry.loop.loopEnd = header.readInt();
+    entry.loop.crossfade = header.readInt();
+
+    entry.conditioning.trimmedStart = header.readInt();
+    entry.conditioning.trimmedEnd = header.readInt();
+    entry.conditioning.removedDc = header.readBool();
+    entry.conditioning.collapsedToMono = header.readBool();
+    entry.conditioning.gainDb = header.readFloat();
+    entry.conditioning.bytesBefore = static_cast<size_t>(header.readInt64());
+    entry.conditioning.bytesAfter = static_cast<size_t>(header.readInt64());
+
+    entry.detectedRootNote = header.readInt();
+
+    auto peaks = std::make_shared<WaveformPeaks>();
+    peaks->numChannels = header.readInt();
+    peaks->numPeaks = header.readInt();
+    peaks->numFrames = header.readInt();
+    const auto numPeakValues = static_cast<size_t>(juce::jmax(0, peaks->numChannels)) * static_cast<size_t>(juce::jmax(0, peaks->numPeaks));
+    if (numChannels <= 0 || numFrames <= 0 || numPeakValues * 2 * sizeof(float) > size)
+        return false;
+
+    peaks->minima.resize(numPeakValues);
+    peaks->maxima.resize(numPeakValues);
+    const auto peakBytes = static_cast<int>(numPeakValues * sizeof(float));
+    if (header.read(peaks->minima.data(), peakBytes) != peakBytes || header.read(peaks->maxima.data(), peakBytes) != peakBytes)
+        return false;
+
+    const auto dataOffset = static_cast<size_t>(header.readInt64());
+    const auto channelBytes = static_cast<size_t>(numFrames) * sizeof(float);
+    if (dataOffset < static_cast<size_t>(header.getPosition()) || dataOffset % DATA_ALIGNMENT != 0
+        || dataOffset + static_cast<size_t>(numChannels) * channelBytes > size)
+        return false;
+
+    // The buffer is only ever read (SampleInfo holds it const)
+    std::vector<float*> channels;
+    for (int channel = 0; channel < numChannels; ++channel)
+        channels.push_back(reinterpret_cast<float*>(const_cast<char*>(data + dataOffset + static_cast<size_t>(channel) * channelBytes)));
+
+    // Fault the audio in here; a lazily mapped page would be read on the audio thread
+    prefaultPages(data + dataOffset, static_cast<size_t>(numChannels) * channelBytes);
+
+    auto holder = std::make_shared<MappedBuffer>(std::move(mapped), channels.data(), numChannels, numFrames);
+    entry.buffer = std::shared_ptr<const juce::AudioBuffer<float>>(holder, &holder->buffer);
+    entry.peaks = std::move(peaks);
+
+    // Recently used entries are the last to be evicted
+    file.setLastModificationTime(juce::Time::getCurrentTime());
+    return true;
+}
+
+void SampleCache::store(const Key& key, const Entry& entry)
+{
+    if (key.contentHash.isEmpty() || entry.buffer == nullptr || entry.peaks == nullptr)
+        return;
+
+    if (!directory.createDirectory())
+        return;
+
+    const auto& buffer = *entry.buffer;
+    const auto& peaks = *entry.peaks;
+    const auto target = getEntryFile(key);
+
+    juce::MemoryOutputStream header;
+    header.writeInt(ENTRY_MAGIC);
+    header.writeInt(ENTRY_VERSION);
+    header.writeInt(buffer.getNumChannels());
+    header.writeInt(buffer.getNumSamples());
+    header.writeDouble(entry.originalSampleRate);
+    header.writeDouble(entry.bufferSampleRate);
+
+    header.writeInt(entry.loop.start);
+    header.writeInt(entry.loop.end);
+    header.writeInt(static_cast<int>(entry.loop.mode));
+    header.writeInt(entry.loop.loopStart);
+    header.writeInt(entry.loop.loopEnd);
+    header.writeInt(entry.loop.crossfade);
+
+    header.writeInt(entry.conditioning.trimmedStart);
+    header.writeInt(entry.conditioning.trimmedEnd);
+    header.writeBool(entry.conditioning.removedDc);
+    header.writeBool(entry.conditioning.collapsedToMono);
+    header.writeFloat(entry.conditioning.gainDb);
+    header.writeInt64(static_cast<juce::int64>(entry.conditioning.bytesBefore));
+    header.writeInt64(static_cast<juce::int64>(entry.conditioning.bytesAfter));
+
+    header.writeInt(entry.detectedRootNote);
+
+    header.writeInt(peaks.numChannels);
+    header.writeInt(peaks.numPeaks);
+    header.writeInt(peaks.numFrames);
+    header.write(peaks.minima.data(), peaks.minima.size() * sizeof(float));
+    header.write(peaks.maxima.data(), peaks.maxima.size() * sizeof(float));
+
+    // Audio starts on an aligned offset, so mapped channels are aligned too
+    const auto headerSize = header.getDataSize() + sizeof(juce::int64);
+    const auto dataOffset = (headerSize + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+    header.writeInt64(static_cast<juce::int64>(dataOffset));
+    header.writeRepeatedByte(0, dataOffset - headerSize);
+
+    // Written beside the target and renamed over it, so readers never see a partial entry
+    juce::TemporaryFile temporary(target);
+    {
+        juce::FileOutputStream output(temporary.getFile());
+        if (!output.openedOk())
+            return;
+
+        bool written = output.write(header.getData(), header.getDataSize());
+        for (int channel = 0; channel < buffer.getNumChannels() && written; ++channel)
+            written = output.write(buffer.getReadPointer(channel), static_cast<size_t>(buffer.getNumSamples()) * sizeof(float));
+
+        output.flush();
+        if (!written || output.getStatus().failed())
+            return;
+    }
+
+    if (temporary.overwriteTargetFileWithTemporary())
+        enforceSizeLimit();
+}
+
+void SampleCache::enforceSizeLimit()
+{
+    std::lock_guard<std::mutex> lock(indexMutex);
+
+    auto entries = directory.findChildFiles(juce::File::findFiles, false, "*.eskc");
+    juce::int64 totalSize = 0;
+    for (const auto& file : entries)
+        totalSize += file.getSize();
+
+    if (totalSize <= sizeLimit)
+        return;
+
+    // Least recently used first (loads touch the modification time)
+    std::sort(entries.begin(), entries.end(), [](const juce::File& a, const juce::File& b) {
+        return a.getLastModificationTime() < b.getLastModificationTime();
+    });
+
+    for (const auto& file : entries)
+    {
+        if (totalSize <= sizeLimit)
+            break;
+
+        const auto fileSize = file.getSize();
+        if (file.deleteFile())
+            totalSize -= fileSize;
+    }
+}
+
+void SampleCache::loadIndex()
+{
+    if (indexLoaded)
+        return;
+
+    indexLoaded = true;
+    const auto xml = juce::XmlDocument::parse(getIndexFile());
+    if (xml == nullptr)
+        return;
+
+    for (auto* fileElement : xml->getChildWithTagNameIterator("File"))
+    {
+        IndexEntry entry;
+        entry.size = fileElement->getStringAttribute("size").getLargeIntValue();
+        entry.modificationTime = fileElement->getStringAttribute("modified").getLargeIntValue();
+        entry.contentHash = fileElement->getStringAttribute("hash");
+        index[fileElement->getStringAttribute("path")] = entry;
+    }
+}
+
+void SampleCache::saveIndex()
+{
+    if (!directory.createDirectory())
+        return;
+
+    juce::XmlElement xml("SampleCacheIndex");
+    for (const auto& [path, entry] : index)
+    {
+        auto* fileElement = xml.createNewChildElement("File");
+        fileElement->setAttribute("path", path);
+        fileElement->setAttribute("size", juce::String(entry.size));
+        fileElement->setAttribute("modified", juce::String(entry.modificationTime));
+        fileElement->setAttribute("hash", entry.contentHash);
+    }
+
+    juce::TemporaryFile temporary(getIndexFile());
+    if (xml.writeTo(temporary.getFile()))
+        temporary.overwriteTargetFileWithTemporary();
+}
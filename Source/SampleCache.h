@@ -0,0 +1,98 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "SampleAnalysis.h"
+#include "SampleConditioning.h"
+#include "SampleLoop.h"
+
+// On-disk cache of imported samples, keyed by the content hash of the source file.
+// An entry holds the audio exactly as it was published to the bank for one session
+// rate and conditioning setting, plus the load-time analysis: the loop read from the
+// file, the conditioning report, the waveform peaks and the detected root key.
+//
+// Entries are written once, atomically (temporary file, then rename), and read through
+// a memory map: the cached buffer's channels point into the mapped file, so a warm
+// load does no decoding, resampling or analysis. The loader faults the mapped audio in,
+// so the audio thread doesn't take the page faults. An index of path, size and
+// modification time to content hash means unchanged files are not re-hashed either.
+// Thread-safe; instances sharing a directory in one process should share the object
+// (see getShared).
+class SampleCache
+{
+public:
+    // What a cached load provides
+    struct Entry
+    {
+        double originalSampleRate = 0.0;
+        double bufferSampleRate = 0.0;
+        SampleLoop loop;
+        ConditioningReport conditioning;
+        int detectedRootNote = SampleAnalysis::UNPITCHED;
+        std::shared_ptr<const WaveformPeaks> peaks;
+        std::shared_ptr<const juce::AudioBuffer<float>> buffer;
+    };
+
+    // A source file's content hash together with the session rate and conditioning
+    struct Key
+    {
+        juce::String contentHash;
+        double sampleRate = 0.0;
+        juce::String conditioningTag;
+
+        juce::String getEntryName() const;
+    };
+
+    static constexpr juce::int64 DEFAULT_SIZE_LIMIT = juce::int64(2) << 30;   // 2 GB
+
+    explicit SampleCache(const juce::File& directory, juce::int64 sizeLimit = DEFAULT_SIZE_LIMIT);
+
+    // Process-wide cache in the user's application data folder, or the folder named by
+    // the ESKILATOR_SAMPLE_CACHE environment variable; nullptr when that is "off"
+    static std::shared_ptr<SampleCache> getShared();
+
+    const juce::File& getDirectory() const { return directory; }
+
+    // Cache key for loading a file at a session rate, or an empty hash when the file can't be read
+    Key makeKey(const juce::File& sourceFile, double sampleRate, const ConditioningSettings& conditioning);
+
+    // Memory-map a stored entry and read its pages in; false when there is none (or it is unreadable)
+    bool load(const Key& key, Entry& entry);
+
+    // Write an entry for a freshly imported sample. Evicts the least recently used
+    // entries when the cache is over its size limit.
+    void store(const Key& key, const Entry& entry);
+
+    // Write the path index once a load pass is done, if it hashed new files or indexes
+    // files that no longer exist (those are dropped)
+    void saveIndexIfChanged();
+
+    // Content hash of a file's bytes (64-bit, hex)
+    static juce::String hashFile(const juce::File& file);
+
+private:
+    struct IndexEntry
+    {
+        juce::int64 size = 0;
+        juce::int64 modificationTime = 0;
+        juce::String contentHash;
+    };
+
+    juce::File directory;
+    juce::int64 sizeLimit;
+
+    std::mutex indexMutex;
+    std::map<juce::String, IndexEntry> index;   // By full path
+    bool indexLoaded = false;
+    bool indexChanged = false;
+
+    juce::String getContentHash(const juce::File& sourceFile);
+    void loadIndex();
+    void saveIndex();
+    void enforceSizeLimit();
+
+    juce::File getIndexFile() const { return directory.getChildFile("index.xml"); }
+    juce::File getEntryFile(const Key& key) const { return directory.getChildFile(key.getEntryName()); }
+};
@@ -0,0 +1,193 @@
+#include "SampleConditioning.h"
+
+#include <cmath>
+
+namespace
+{
+    // Offsets smaller than this (-100 dB) are left alone
+    constexpr float DC_THRESHOLD = 1.0e-5f;
+
+    // The silence scan checks blocks of this many frames, then the frames of the first loud one
+    constexpr int TRIM_BLOCK = 64;
+
+    size_t getBufferBytes(int numChannels, int numFrames)
+    {
+        return static_cast<size_t>(numChannels) * static_cast<size_t>(numFrames) * sizeof(float);
+    }
+
+    bool isLoud(const juce::AudioBuffer<float>& audio, const KernelDispatch::KernelTable& kernels,
+                int start, int length, float threshold)
+    {
+        for (int channel = 0; channel < audio.getNumChannels(); ++channel)
+            if (kernels.findPeak(audio.getReadPointer(channel, start), length) > threshold)
+                return true;
+        return false;
+    }
+
+    // First frame above the threshold, or numFrames when there is none
+    int findFirstLoudFrame(const juce::AudioBuffer<float>& audio, const KernelDispatch::KernelTable& kernels, float threshold)
+    {
+        const int numFrames = audio.getNumSamples();
+        for (int blockStart = 0; blockStart < numFrames; blockStart += TRIM_BLOCK)
+        {
+            const int blockEnd = juce::jmin(numFrames, blockStart + TRIM_BLOCK);
+            if (!isLoud(audio, kernels, blockStart, blockEnd - blockStart, threshold))
+                continue;
+
+            for (int frame = blockStart; frame < blockEnd; ++frame)
+                if (isLoud(audio, kernels, frame, 1, threshold))
+                    return frame;
+        }
+        return numFrames;
+    }
+
+    // One past the last frame above the threshold, or 0 when there is none
+    int findLoudEnd(const juce::AudioBuffer<float>& audio, const KernelDispatch::KernelTable& kernels, float threshold)
+    {
+        for (int blockEnd = audio.getNumSamples(); blockEnd > 0; blockEnd -= TRIM_BLOCK)
+        {
+            const int blockStart = juce::jmax(0, blockEnd - TRIM_BLOCK);
+            if (!isLoud(audio, kernels, blockStart, blockEnd - blockStart, threshold))
+                continue;
+
+            for (int frame = blockEnd - 1; frame >= blockStart; --frame)
+                if (isLoud(audio, kernels, frame, 1, threshold))
+                    return frame + 1;
+        }
+        return 0;
+    }
+}
+
+bool ConditioningSettings::operator==(const ConditioningSettings& other) const
+{
+    return enabled == other.enabled && trimSilence == other.trimSilence && silenceThresholdDb == other.silenceThresholdDb
+           && removeDc == other.removeDc && normalisation == other.normalisation && targetDb == other.targetDb
+           && collapseDualMono == other.collapseDualMono;
+}
+
+juce::String ConditioningReport::toString() const
+{
+    juce::StringArray steps;
+    if (trimmedStart > 0 || trimmedEnd > 0)
+        steps.add("trimmed " + juce::String(trimmedStart) + " + " + juce::String(trimmedEnd) + " frames");
+    if (removedDc)
+        steps.add("DC removed");
+    if (collapsedToMono)
+        steps.add("dual mono stored as mono");
+    if (gainDb != 0.0f)
+        steps.add("gain " + juce::String(gainDb, 1) + " dB");
+    steps.add("saved " + juce::String(static_cast<double>(getBytesSaved()) / 1024.0, 1) + " kB");
+    return steps.joinIntoString(", ");
+}
+
+ConditioningReport SampleConditioning::process(juce::AudioBuffer<float>& audio, const ConditioningSettings& settings,
+                                               const KernelDispatch::KernelTable& kernels, int keepStart, int keepEnd)
+{
+    const int numChannels = audio.getNumChannels();
+    const int numFrames = audio.getNumSamples();
+
+    ConditioningReport report;
+    report.bytesBefore = getBufferBytes(numChannels, numFrames);
+    report.bytesAfter = report.bytesBefore;
+
+    if (!settings.enabled || numChannels == 0 || numFrames == 0)
+        return report;
+
+    // Silence at either end (a silent sample is kept whole). This runs before DC removal,
+    // which would move true silence to minus the mean of a one-sided sound.
+    int firstFrame = 0;
+    int endFrame = numFrames;
+    if (settings.trimSilence)
+    {
+        const float threshold = juce::Decibels::decibelsToGain(settings.silenceThresholdDb);
+        const int loudStart = findFirstLoudFrame(audio, kernels, threshold);
+        if (loudStart < numFrames)
+        {
+            firstFrame = loudStart;
+            endFrame = findLoudEnd(audio, kernels, threshold);
+        }
+
+        if (keepStart < keepEnd)
+        {
+            firstFrame = juce::jmin(firstFrame, juce::jmax(0, keepStart));
+            endFrame = juce::jmax(endFrame, juce::jmin(numFrames, keepEnd));
+        }
+    }
+
+    const int keptFrames = endFrame - firstFrame;
+
+    // Dual mono: every channel matches the first
+    int keptChannels = numChannels;
+    if (settings.collapseDualMono && numChannels > 1)
+    {
+        bool identical = true;
+        for (int channel = 1; channel < numChannels && identical; ++channel)
+            identical = kernels.findDifferencePeak(audio.getReadPointer(0, firstFrame), audio.getReadPointer(channel, firstFrame),
+                                                   keptFrames) <= SampleConditioning::DUAL_MONO_TOLERANCE;
+
+        if (identical)
+        {
+            keptChannels = 1;
+            report.collapsedToMono = true;
+        }
+    }
+
+    // DC offset of what is kept
+    if (settings.removeDc)
+    {
+        for (int channel = 0; channel < keptChannels; ++channel)
+        {
+            double sum = 0.0;
+            double sumOfSquares = 0.0;
+            kernels.findSums(audio.getReadPointer(channel, firstFrame), keptFrames, &sum, &sumOfSquares);
+
+            const auto mean = static_cast<float>(sum / keptFrames);
+            if (std::abs(mean) > DC_THRESHOLD)
+            {
+                kernels.addOffset(audio.getWritePointer(channel, firstFrame), -mean, keptFrames);
+                report.removedDc = true;
+            }
+        }
+    }
+
+    // Level of what is kept, as a gain in the SampleInfo::gain range
+    if (settings.normalisation != ConditioningSettings::Normalisation::Off)
+    {
+        float level = 0.0f;
+        if (settings.normalisation == ConditioningSettings::Normalisation::Peak)
+        {
+            for (int channel = 0; channel < keptChannels; ++channel)
+                level = juce::jmax(level, kernels.findPeak(audio.getReadPointer(channel, firstFrame), keptFrames));
+        }
+        else
+        {
+            double total = 0.0;
+            for (int channel = 0; channel < keptChannels; ++channel)
+            {
+                double sum = 0.0;
+                double sumOfSquares = 0.0;
+                kernels.findSums(audio.getReadPointer(channel, firstFrame), keptFrames, &sum, &sumOfSquares);
+                total += sumOfSquares;
+            }
+            level = static_cast<float>(std::sqrt(total / (static_cast<double>(keptChannels) * keptFrames)));
+        }
+
+        if (level > 0.0f)
+            report.gainDb = juce::jlimit(-24.0f, 24.0f, settings.targetDb - juce::Decibels::gainToDecibels(level));
+    }
+
+    // Copy what is kept into a buffer of its own, so the memory is actually released
+    if (keptFrames < numFrames || keptChannels < numChannels)
+    {
+        juce::AudioBuffer<float> compact(keptChannels, keptFrames);
+        for (int channel = 0; channel < keptChannels; ++channel)
+            compact.copyFrom(channel, 0, audio, channel, firstFrame, keptFrames);
+        audio = std::move(compact);
+
+        report.trimmedStart = firstFrame;
+        report.trimmedEnd = numFrames - endFrame;
+        report.bytesAfter = getBufferBytes(keptChannels, keptFrames);
+    }
+
+    return report;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "KernelDispatch.h"
+
+// Optional clean-up of decoded samples, run by SampleManager on the loading thread after
+// decode and before the sample is published. Each stage can be switched off.
+struct ConditioningSettings
+{
+    enum class Normalisation
+    {
+        Off = 0,
+        Peak,       // Loudest sample to targetDb
+        Loudness    // RMS of the trimmed audio to targetDb (unweighted, ungated)
+    };
+
+    bool enabled = false;
+    bool trimSilence = true;
+    float silenceThresholdDb = -60.0f;     // Leading and trailing frames below this are cut
+    bool removeDc = true;
+    Normalisation normalisation = Normalisation::Peak;
+    float targetDb = -1.0f;
+    bool collapseDualMono = true;          // Channels that match to within -120 dB are stored once
+
+    bool operator==(const ConditioningSettings& other) const;
+    bool operator!=(const ConditioningSettings& other) const { return !(*this == other); }
+};
+
+// What conditioning did to one sample
+struct ConditioningReport
+{
+    int trimmedStart = 0;         // Frames removed from the front
+    int trimmedEnd = 0;           // Frames removed from the back
+    bool removedDc = false;
+    bool collapsedToMono = false;
+    float gainDb = 0.0f;          // Normalisation gain (applied through SampleInfo::gain)
+    size_t bytesBefore = 0;
+    size_t bytesAfter = 0;
+
+    size_t getBytesSaved() const { return bytesBefore - bytesAfter; }
+    juce::String toString() const;
+};
+
+namespace SampleConditioning
+{
+    static constexpr float DUAL_MONO_TOLERANCE = 1.0e-6f;   // -120 dB
+
+    // Condition a decoded buffer in place; it is replaced by a smaller one when frames
+    // or channels are dropped. When keepStart < keepEnd, frames in [keepStart, keepEnd)
+    // are never trimmed (a loop stored in the file). The gain is reported, not applied.
+    ConditioningReport process(juce::AudioBuffer<float>& audio, const ConditioningSettings& settings,
+                               const KernelDispatch::KernelTable& kernels, int keepStart, int keepEnd);
+}
@@ -0,0 +1,92 @@
+#include "SampleLoop.h"
+#include "RenderKernels.h"
+
+#include <cmath>
+
+static_assert(LoopRegion::GUARD_FRAMES >= RenderKernels::SINC_TAPS, "Sinc reads must stay inside the guard frames");
+
+bool SampleLoop::operator==(const SampleLoop& other) const
+{
+    return start == other.start && end == other.end && mode == other.mode
+           && loopStart == other.loopStart && loopEnd == other.loopEnd && crossfade == other.crossfade;
+}
+
+LoopRegion::LoopRegion(const juce::AudioBuffer<float>& buffer, const SampleLoop& loop, double framesPerSourceFrame, int trimmedFrames)
+{
+    const int numFrames = buffer.getNumSamples();
+    auto toBuffer = [numFrames, framesPerSourceFrame, trimmedFrames](int sourceFrame) {
+        return juce::jlimit(0, numFrames, static_cast<int>(std::lround(sourceFrame * framesPerSourceFrame)) - trimmedFrames);
+    };
+
+    // Start and end keep at least one interpolated read between them
+    const int firstFrame = juce::jlimit(0, juce::jmax(0, numFrames - 2), toBuffer(loop.start));
+    const int lastFrame = loop.end < 0 ? numFrames : juce::jlimit(juce::jmin(numFrames, firstFrame + 2), numFrames, toBuffer(loop.end));
+    start = static_cast<std::uint32_t>(firstFrame);
+    end = static_cast<std::uint32_t>(lastFrame);
+
+    // The loop sits between the start and end points
+    const int loopEndFrame = loop.loopEnd < 0 ? lastFrame : juce::jlimit(firstFrame, lastFrame, toBuffer(loop.loopEnd));
+    const int loopStartFrame = juce::jlimit(firstFrame, loopEndFrame, toBuffer(loop.loopStart));
+    const int length = loopEndFrame - loopStartFrame;
+
+    looping = loop.mode != SampleLoop::Mode::Off && length >= 2;
+    if (!looping)
+        return;
+
+    // A forward crossfade blends in as many frames from before the loop start
+    const bool pingPong = loop.mode == SampleLoop::Mode::PingPong;
+    const int crossfadeFrames = pingPong ? 0 : juce::jlimit(0, juce::jmin(length, loopStartFrame),
+                                                                static_cast<int>(std::lround(loop.crossfade * framesPerSourceFrame)));
+    const int blendStart = loopEndFrame - crossfadeFrames;
+
+    const int wrap = pingPong ? loopEndFrame + length : loopEndFrame;
+    const int jump = pingPong ? 2 * length : length;
+    const int firstRegionFrame = juce::jmax(0, blendStart - 2 * GUARD_FRAMES);
+
+    loopEnd = static_cast<std::uint32_t>(loopEndFrame);
+    loopLength = static_cast<std::uint32_t>(length);
+    wrapPoint = static_cast<std::uint32_t>(wrap);
+    wrapLength = static_cast<std::uint32_t>(jump);
+    regionStart = static_cast<std::uint32_t>(firstRegionFrame);
+
+    // The buffer and the region agree for GUARD_FRAMES either side of the switch, so
+    // reads near it (sinc taps included) see the same data from both
+    switchPoint = firstRegionFrame == 0 ? 0 : static_cast<std::uint32_t>(firstRegionFrame + GUARD_FRAMES);
+
+    // Voice positions from the region start to past the wrap point, as they sound
+    const int regionLength = wrap + GUARD_FRAMES - firstRegionFrame;
+    region.setSize(buffer.getNumChannels(), regionLength);
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        const float* source = buffer.getReadPointer(channel);
+        float* destination = region.getWritePointer(channel);
+        auto original = [source, numFrames](int frame) { return frame >= 0 && frame < numFrames ? source[frame] : 0.0f; };
+
+        for (int i = 0; i < regionLength; ++i)
+        {
+            int position = firstRegionFrame + i;
+            while (position >= wrap)
+                position -= jump;
+
+            if (position >= loopEndFrame)
+            {
+                // Ping-pong: the reversed pass
+                destination[i] = original(2 * loopEndFrame - 1 - position);
+            }
+            else if (position >= blendStart)
+            {
+                // Equal power: the loop end fades out as the frames before the loop start fade
+                // in, so the last frame leads straight into the loop start
+                const double progress = static_cast<double>(position - blendStart + 1) / crossfadeFrames;
+                const auto fadeOut = static_cast<float>(std::cos(progress * juce::MathConstants<double>::halfPi));
+                const auto fadeIn = static_cast<float>(std::sin(progress * juce::MathConstants<double>::halfPi));
+                destination[i] = original(position) * fadeOut + original(position - length) * fadeIn;
+            }
+            else
+            {
+                destination[i] = original(position);
+            }
+        }
+    }
+}
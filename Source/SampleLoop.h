@@ -0,0 +1,76 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <cstdint>
+
+// Playback points of a sample, in frames of the source file: where playback starts and
+// ends, and the loop a held note sustains in. Forward loops can crossfade their last
+// frames into the ones before the loop start; ping-pong loops turn around at both ends.
+struct SampleLoop
+{
+    enum class Mode
+    {
+        Off = 0,
+        Forward,
+        PingPong
+    };
+
+    int start = 0;
+    int end = -1;           // Exclusive, -1 = end of the sample
+    Mode mode = Mode::Off;
+    int loopStart = 0;
+    int loopEnd = -1;       // Exclusive, -1 = the end point
+    int crossfade = 0;      // Forward loops only
+
+    bool operator==(const SampleLoop& other) const;
+    bool operator!=(const SampleLoop& other) const { return !(*this == other); }
+};
+
+// A sample's playback points resolved against its decoded buffer, with the loop wrap
+// pre-rendered. A looping voice reads the buffer below getSwitchPoint() and the region
+// from there up to getWrapPoint(), where its phase jumps back by getWrapLength(). The
+// region holds the crossfade already blended (forward) or the loop reversed (ping-pong)
+// plus guard frames either side, so both reads are contiguous and the voice kernels
+// need no per-frame blend. Built off the audio thread whenever the points or the audio
+// change; immutable afterwards.
+class LoopRegion
+{
+public:
+    // Guard frames either side of the region, enough for the widest interpolator
+    static constexpr int GUARD_FRAMES = 16;
+
+    // framesPerSourceFrame converts the points to buffer frames (buffer rate / file rate);
+    // trimmedFrames were cut from the front of the buffer at import
+    LoopRegion(const juce::AudioBuffer<float>& buffer, const SampleLoop& loop, double framesPerSourceFrame, int trimmedFrames = 0);
+
+    // Buffer frames: first frame played and the end of one-shot playback
+    std::uint32_t getStart() const { return start; }
+    std::uint32_t getEnd() const { return end; }
+
+    bool isLooping() const { return looping; }
+
+    // Loop bounds in the buffer (a fading-out restart position wraps inside them)
+    std::uint32_t getLoopEnd() const { return loopEnd; }
+    std::uint32_t getLoopLength() const { return loopLength; }
+
+    // Voice positions: the buffer below the switch point, the region (offset by
+    // getRegionStart()) from there, and a jump back by the wrap length at the wrap point.
+    // Ping-pong positions past the loop end are the reversed pass.
+    std::uint32_t getSwitchPoint() const { return switchPoint; }
+    std::uint32_t getWrapPoint() const { return wrapPoint; }
+    std::uint32_t getWrapLength() const { return wrapLength; }
+    std::uint32_t getRegionStart() const { return regionStart; }
+    const juce::AudioBuffer<float>& getRegion() const { return region; }
+
+private:
+    std::uint32_t start = 0;
+    std::uint32_t end = 0;
+    bool looping = false;
+    std::uint32_t loopEnd = 0;
+    std::uint32_t loopLength = 0;
+    std::uint32_t switchPoint = 0;
+    std::uint32_t wrapPoint = 0;
+    std::uint32_t wrapLength = 0;
+    std::uint32_t regionStart = 0;
+    juce::AudioBuffer<float> region;
+};
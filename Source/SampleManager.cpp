@@ -1,120 +1,423 @@
 #include "SampleManager.h"
 
+#include "BinaryData.h"
 #include "PluginLogger.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    std::vector<SampleMapping> getMappings(const std::vector<SampleInfo>& samples)
+    {
+        std::vector<SampleMapping> mappings;
+        mappings.reserve(samples.size());
+        for (const auto& sample : samples)
+            mappings.push_back(sample.mapping);
+        return mappings;
+    }
+}
+
+SampleBank::SampleBank(std::vector<SampleInfo> bankSamples, const SampleBank& previous)
+    : samples(std::move(bankSamples)),
+      mappings(getMappings(samples)),
+      // Gain, transpose and loop edits keep every mapping, so the compiled keymap carries over
+      keymap(mappings == previous.mappings ? previous.keymap : std::make_shared<const Keymap>(mappings))
+{
+}
 
 SampleManager::SampleManager()
 {
     // Constructor - default values are set in header
-    initializeRandomGenerator();
 }
 
-void SampleManager::initializeRandomGenerator()
+void SampleManager::setRandomSeed(std::uint64_t seed)
 {
-    std::random_device rd;
-    randomGenerator.seed(rd());
-    randomDistribution = std::uniform_int_distribution<int>(0, 0);
+    randomGenerator.setSeed(seed);
+    roundRobinCounters.fill(0);
 }
 
-void SampleManager::setSampleGain(int index, float gainDb)
+SampleBank::Ptr SampleManager::getBank() const
+{
+    const juce::SpinLock::ScopedLockType lock(bankLock);
+    return bank;
+}
+
+void SampleManager::modifyBank(const std::function<void(std::vector<SampleInfo>&)>& edit)
+{
+    std::lock_guard<std::mutex> lock(writerMutex);
+
+    const auto previousBank = getBank();
+    auto samples = previousBank->getSamples();
+    edit(samples);
+    SampleBank::Ptr newBank(new SampleBank(std::move(samples), *previousBank));
+
+    {
+        const juce::SpinLock::ScopedLockType swapLock(bankLock);
+        std::swap(bank, newBank);
+    }
+
+    // newBank now holds the replaced snapshot. Free the ones only this list still references.
+    retiredBanks.push_back(std::move(newBank));
+    retiredBanks.erase(std::remove_if(retiredBanks.begin(), retiredBanks.end(),
+                                      [](const SampleBank::Ptr& retired) { return retired->getReferenceCount() == 1; }),
+                       retiredBanks.end());
+}
+
+void SampleManager::updateLoopRegion(SampleInfo& info)
+{
+    if (info.buffer == nullptr || info.originalSampleRate <= 0.0) {
+        info.loopRegion = nullptr;
+        return;
+    }
+
+    info.loopRegion = std::make_shared<const LoopRegion>(*info.buffer, info.loop, info.bufferSampleRate / info.originalSampleRate,
+                                                         info.conditioning.trimmedStart);
+}
+
+void SampleManager::conditionSample(SampleInfo& info, juce::AudioBuffer<float>& audio) const
+{
+    const auto settings = getConditioning();
+    info.conditionedWith = settings;
+    if (!settings.enabled || info.isDefault) {
+        return;
+    }
+
+    ESKILATOR_TRACE_SCOPE("loadSample: condition", "loader");
+
+    // A loop stored in the file is never trimmed into
+    int keepStart = 0;
+    int keepEnd = 0;
+    if (info.loop.mode != SampleLoop::Mode::Off && info.originalSampleRate > 0.0) {
+        const double framesPerSourceFrame = info.bufferSampleRate / info.originalSampleRate;
+        keepStart = static_cast<int>(std::lround(info.loop.loopStart * framesPerSourceFrame));
+        keepEnd = info.loop.loopEnd < 0 ? audio.getNumSamples()
+                                        : static_cast<int>(std::lround(info.loop.loopEnd * framesPerSourceFrame));
+    }
+
+    info.conditioning = SampleConditioning::process(audio, settings, *kernels.load(), keepStart, keepEnd);
+    info.gain = juce::jlimit(-24.0f, 24.0f, info.gain + info.conditioning.gainDb);
+
+    PluginLogger::conditionalLog("Conditioned " + info.name + ": " + info.conditioning.toString());
+}
+
+void SampleManager::prepareSample(SampleInfo& info, std::shared_ptr<juce::AudioBuffer<float>> audio,
+                                  const SampleCache::Key* cacheKey)
 {
-    std::lock_guard<std::mutex> lock(sampleBankMutex);
-    if (index >= 0 && index < static_cast<int>(sampleBank.size())) {
-        sampleBank[index].gain = juce::jlimit(-24.0f, 24.0f, gainDb);
+    conditionSample(info, *audio);
+
+    {
+        ESKILATOR_TRACE_SCOPE("loadSample: analyse", "loader");
+        info.peaks = std::make_shared<const WaveformPeaks>(SampleAnalysis::makePeaks(*audio));
+        info.detectedRootNote = SampleAnalysis::detectRootNote(*audio, info.bufferSampleRate);
     }
+
+    info.buffer = std::move(audio);
+
+    if (const auto sampleCache = getCache(); sampleCache != nullptr && cacheKey != nullptr) {
+        ESKILATOR_TRACE_SCOPE("loadSample: cache store", "loader");
+        SampleCache::Entry entry;
+        entry.originalSampleRate = info.originalSampleRate;
+        entry.bufferSampleRate = info.bufferSampleRate;
+        entry.loop = info.loop;
+        entry.conditioning = info.conditioning;
+        entry.detectedRootNote = info.detectedRootNote;
+        entry.peaks = info.peaks;
+        entry.buffer = info.buffer;
+        sampleCache->store(*cacheKey, entry);
+    }
+}
+
+void SampleManager::publishSample(SampleInfo info)
+{
+    updateLoopRegion(info);
+
+    ESKILATOR_TRACE_SCOPE("loadSample: publish", "loader");
+    modifyBank([&info](std::vector<SampleInfo>& samples) { samples.push_back(std::move(info)); });
+}
+
+void SampleManager::setSampleGain(int index, float gainDb)
+{
+    modifyBank([index, gainDb](std::vector<SampleInfo>& samples) {
+        if (index >= 0 && index < static_cast<int>(samples.size())) {
+            samples[static_cast<size_t>(index)].gain = juce::jlimit(-24.0f, 24.0f, gainDb);
+        }
+    });
 }
 
 float SampleManager::getSampleGain(int index) const
 {
-    std::lock_guard<std::mutex> lock(sampleBankMutex);
-    if (index >= 0 && index < static_cast<int>(sampleBank.size())) {
-        return sampleBank[index].gain;
+    const auto currentBank = getBank();
+    if (currentBank->isValidIndex(index)) {
+        return (*currentBank)[index].gain;
     }
     return 0.0f;
 }
 
 void SampleManager::setSampleTranspose(int index, float semitones)
 {
-    std::lock_guard<std::mutex> lock(sampleBankMutex);
-    if (index >= 0 && index < static_cast<int>(sampleBank.size())) {
-        sampleBank[index].transpose = juce::jlimit(-12.0f, 12.0f, semitones);
-    }
+    modifyBank([index, semitones](std::vector<SampleInfo>& samples) {
+        if (index >= 0 && index < static_cast<int>(samples.size())) {
+            samples[static_cast<size_t>(index)].transpose = juce::jlimit(-12.0f, 12.0f, semitones);
+        }
+    });
 }
 
 float SampleManager::getSampleTranspose(int index) const
 {
-    std::lock_guard<std::mutex> lock(sampleBankMutex);
-    if (index >= 0 && index < static_cast<int>(sampleBank.size())) {
-        return sampleBank[index].transpose;
+    const auto currentBank = getBank();
+    if (currentBank->isValidIndex(index)) {
+        return (*currentBank)[index].transpose;
     }
     return 0.0f;
 }
 
+void SampleManager::setSampleMapping(int index, const SampleMapping& mapping)
+{
+    modifyBank([index, validated = mapping.getValidated()](std::vector<SampleInfo>& samples) {
+        if (index >= 0 && index < static_cast<int>(samples.size())) {
+            samples[static_cast<size_t>(index)].mapping = validated;
+        }
+    });
+}
+
+SampleMapping SampleManager::getSampleMapping(int index) const
+{
+    const auto currentBank = getBank();
+    if (currentBank->isValidIndex(index)) {
+        return (*currentBank)[index].mapping;
+    }
+    return {};
+}
+
+void SampleManager::setSampleLoop(int index, const SampleLoop& loop)
+{
+    modifyBank([index, &loop](std::vector<SampleInfo>& samples) {
+        if (index >= 0 && index < static_cast<int>(samples.size())) {
+            auto& sample = samples[static_cast<size_t>(index)];
+            sample.loop = loop;
+            updateLoopRegion(sample);
+        }
+    });
+}
+
+SampleLoop SampleManager::getSampleLoop(int index) const
+{
+    const auto currentBank = getBank();
+    if (currentBank->isValidIndex(index)) {
+        return (*currentBank)[index].loop;
+    }
+    return {};
+}
+
+void SampleManager::setConditioning(const ConditioningSettings& settings)
+{
+    std::lock_guard<std::mutex> lock(loadSettingsMutex);
+    conditioningSettings = settings;
+}
+
+ConditioningSettings SampleManager::getConditioning() const
+{
+    std::lock_guard<std::mutex> lock(loadSettingsMutex);
+    return conditioningSettings;
+}
+
+ConditioningReport SampleManager::getConditioningReport(int index) const
+{
+    const auto currentBank = getBank();
+    if (currentBank->isValidIndex(index)) {
+        return (*currentBank)[index].conditioning;
+    }
+    return {};
+}
+
+std::shared_ptr<const WaveformPeaks> SampleManager::getSamplePeaks(int index) const
+{
+    const auto currentBank = getBank();
+    if (currentBank->isValidIndex(index)) {
+        return (*currentBank)[index].peaks;
+    }
+    return nullptr;
+}
+
+int SampleManager::getDetectedRootNote(int index) const
+{
+    const auto currentBank = getBank();
+    if (currentBank->isValidIndex(index)) {
+        return (*currentBank)[index].detectedRootNote;
+    }
+    return SampleAnalysis::UNPITCHED;
+}
+
+void SampleManager::setCache(std::shared_ptr<SampleCache> sampleCache)
+{
+    std::lock_guard<std::mutex> lock(loadSettingsMutex);
+    cache = std::move(sampleCache);
+}
+
+std::shared_ptr<SampleCache> SampleManager::getCache() const
+{
+    std::lock_guard<std::mutex> lock(loadSettingsMutex);
+    return cache;
+}
+
 bool SampleManager::loadSample(const juce::File& audioFile, double currentSampleRate)
 {
-    std::lock_guard<std::mutex> lock(sampleBankMutex);
+    ESKILATOR_TRACE_SCOPE("SampleManager::loadSample", "loader");
+
     this->currentSampleRate = currentSampleRate;
+
+    SampleInfo newSample;
+    const bool read = readSample(audioFile, currentSampleRate, newSample);
+    if (const auto sampleCache = getCache())
+        sampleCache->saveIndexIfChanged();
+
+    if (!read)
+        return false;
+
+    publishSample(std::move(newSample));
+    return true;
+}
+
+bool SampleManager::readSample(const juce::File& audioFile, double currentSampleRate, SampleInfo& newSample)
+{
+    // Stamp first: a file changed while it is read is treated as changed next time
+    newSample.fileSize = audioFile.getSize();
+    newSample.fileModificationTime = audioFile.getLastModificationTime().toMilliseconds();
+    newSample.name = audioFile.getFileNameWithoutExtension();
+    newSample.path = audioFile.getFullPathName();
+    newSample.isDefault = false;
+
+    // A file imported before at this rate and conditioning is mapped from the cache
+    const auto sampleCache = getCache();
+    SampleCache::Key cacheKey;
+    if (sampleCache != nullptr) {
+        ESKILATOR_TRACE_SCOPE("loadSample: cache lookup", "loader");
+        const auto conditioning = getConditioning();
+        cacheKey = sampleCache->makeKey(audioFile, currentSampleRate, conditioning);
+
+        SampleCache::Entry cached;
+        if (sampleCache->load(cacheKey, cached)) {
+            newSample.conditionedWith = conditioning;
+            newSample.originalSampleRate = cached.originalSampleRate;
+            newSample.bufferSampleRate = cached.bufferSampleRate;
+            newSample.loop = cached.loop;
+            newSample.conditioning = cached.conditioning;
+            newSample.gain = juce::jlimit(-24.0f, 24.0f, cached.conditioning.gainDb);
+            newSample.peaks = std::move(cached.peaks);
+            newSample.detectedRootNote = cached.detectedRootNote;
+            newSample.buffer = std::move(cached.buffer);
+            return true;
+        }
+    }
     
     juce::AudioFormatManager formatManager;
-    formatManager.registerBasicFormats(); // WAV, AIFF, etc.
-    
-    auto reader = formatManager.createReaderFor(audioFile);
-    if (reader != nullptr)
+    std::unique_ptr<juce::AudioFormatReader> reader;
     {
-        SampleInfo newSample;
-        newSample.originalSampleRate = reader->sampleRate;
-        newSample.name = audioFile.getFileNameWithoutExtension();
-        newSample.path = audioFile.getFullPathName();
-        newSample.isDefault = false;
+        ESKILATOR_TRACE_SCOPE("loadSample: open", "loader");
+        formatManager.registerBasicFormats(); // WAV, AIFF, etc.
+        reader.reset(formatManager.createReaderFor(audioFile));
+    }
+
+    if (reader == nullptr)
+        return false;
+
+    newSample.originalSampleRate = reader->sampleRate;
+    newSample.bufferSampleRate = reader->sampleRate;
+
+    // Loop points stored in the file (WAV 'smpl' chunk); its loop end is inclusive
+    const auto& metadata = reader->metadataValues;
+    if (metadata.getValue("NumSampleLoops", "0").getIntValue() > 0) {
+        newSample.loop.mode = metadata.getValue("Loop0Type", "0").getIntValue() == 1 ? SampleLoop::Mode::PingPong
+                                                                                       : SampleLoop::Mode::Forward;
+        newSample.loop.loopStart = metadata.getValue("Loop0Start", "0").getIntValue();
+        newSample.loop.loopEnd = metadata.getValue("Loop0End", "-1").getIntValue() + 1;
+    }
+
+    // Decoding runs before the bank is touched, so loads never block readers
+    auto audio = std::make_shared<juce::AudioBuffer<float>>();
+    
+    // Check if we need sample rate conversion
+    if (std::abs(newSample.originalSampleRate - currentSampleRate) > 0.1) {
+        // Create temporary buffer for original data
+        juce::AudioBuffer<float> tempBuffer(static_cast<int>(reader->numChannels), 
+                                          static_cast<int>(reader->lengthInSamples));
         
-        // Check if we need sample rate conversion
-        if (std::abs(newSample.originalSampleRate - currentSampleRate) > 0.1) {
-            // If sample rates differ significantly calculate the required buffer size after resampling
-            double conversionRatio = currentSampleRate / newSample.originalSampleRate;
-            int resampledLength = static_cast<int>(reader->lengthInSamples * conversionRatio);
-            
-            // Create temporary buffer for original data
-            juce::AudioBuffer<float> tempBuffer(static_cast<int>(reader->numChannels), 
-                                              static_cast<int>(reader->lengthInSamples));
-            
-            // Read original data
-            reader->read(&tempBuffer, 0, static_cast<int>(reader->lengthInSamples), 0, true, true);
-            
-            // Perform resampling
-            if (!performSampleRateConversion(tempBuffer, newSample.originalSampleRate, currentSampleRate, newSample.buffer)) {
-                delete reader;
-                return false;
-            }
-        }
-        else
+        // Read original data
         {
-            // No resampling needed - load directly
-            newSample.buffer.setSize(static_cast<int>(reader->numChannels), 
-                                   static_cast<int>(reader->lengthInSamples));
-            reader->read(&newSample.buffer, 0, static_cast<int>(reader->lengthInSamples), 0, true, true);
+            ESKILATOR_TRACE_SCOPE("loadSample: decode", "loader");
+            reader->read(&tempBuffer, 0, static_cast<int>(reader->lengthInSamples), 0, true, true);
         }
         
-        // Add the new sample to the bank
-        sampleBank.push_back(newSample);
-        
-        // Initialize processed buffer for this sample
-        processedBuffers.emplace_back();
-        
-        // Update random distribution for new sample count
-        if (sampleBank.size() > 1) {
-            randomDistribution = std::uniform_int_distribution<int>(0, static_cast<int>(sampleBank.size()) - 1);
+        // Perform resampling
+        ESKILATOR_TRACE_SCOPE("loadSample: SRC", "loader");
+        if (!performSampleRateConversion(tempBuffer, newSample.originalSampleRate, currentSampleRate, *audio)) {
+            return false;
         }
-        
-        delete reader;
-        
-        // Trigger timestretch update for the new sample
-        
-        return true;
+        newSample.bufferSampleRate = currentSampleRate;
     }
-    
-    return false;
+    else
+    {
+        // No resampling needed - load directly
+        ESKILATOR_TRACE_SCOPE("loadSample: decode", "loader");
+        audio->setSize(static_cast<int>(reader->numChannels), 
+                       static_cast<int>(reader->lengthInSamples));
+        reader->read(audio.get(), 0, static_cast<int>(reader->lengthInSamples), 0, true, true);
+    }
+
+    prepareSample(newSample, std::move(audio), sampleCache != nullptr ? &cacheKey : nullptr);
+    return true;
+}
+
+bool SampleManager::loadSample(const juce::AudioBuffer<float>& audio, double sourceSampleRate,
+                               const juce::String& name, double currentSampleRate)
+{
+    ESKILATOR_TRACE_SCOPE("SampleManager::loadSample (memory)", "loader");
+
+    if (audio.getNumChannels() == 0 || audio.getNumSamples() == 0 || sourceSampleRate <= 0.0)
+        return false;
+
+    this->currentSampleRate = currentSampleRate;
+
+    SampleInfo newSample;
+    newSample.originalSampleRate = sourceSampleRate;
+    newSample.bufferSampleRate = sourceSampleRate;
+    newSample.name = name;
+    newSample.isDefault = false;
+
+    auto converted = std::make_shared<juce::AudioBuffer<float>>();
+    if (std::abs(sourceSampleRate - currentSampleRate) > 0.1)
+    {
+        if (!performSampleRateConversion(audio, sourceSampleRate, currentSampleRate, *converted))
+            return false;
+        newSample.bufferSampleRate = currentSampleRate;
+    }
+    else
+    {
+        converted->makeCopyOf(audio);
+    }
+
+    prepareSample(newSample, std::move(converted));
+    publishSample(std::move(newSample));
+    return true;
 }
 
 bool SampleManager::loadDefaultSample(double currentSampleRate)
+{
+    SampleInfo info;
+    if (!readDefaultSample(info))
+        return false;
+
+    // Set current sample rate
+    this->currentSampleRate = currentSampleRate;
+
+    // Add to sample bank
+    publishSample(std::move(info));
+    return true;
+}
+
+bool SampleManager::readDefaultSample(SampleInfo& info)
 {
     // Load the default sample from binary data
     const char* sampleData = BinaryData::DefaultSample_wav;
@@ -122,9 +425,6 @@ bool SampleManager::loadDefaultSample(double currentSampleRate)
     
     if (sampleData != nullptr && sampleDataSize > 0)
     {
-        // Create a memory input stream from the binary data
-        juce::MemoryInputStream inputStream(sampleData, sampleDataSize, false);
-        
         // Create an audio format reader
         juce::AudioFormatManager formatManager;
         formatManager.registerBasicFormats();
@@ -133,49 +433,20 @@ bool SampleManager::loadDefaultSample(double currentSampleRate)
         if (reader != nullptr)
         {
             // Create sample info
-            SampleInfo info;
             info.name = "Gliding Squares";
             info.path = "Built-in";
             info.originalSampleRate = reader->sampleRate;
+            info.bufferSampleRate = reader->sampleRate;
             info.isDefault = true;
             
             // Create a buffer for the audio data
-            info.buffer.setSize(static_cast<int>(reader->numChannels), 
-                               static_cast<int>(reader->lengthInSamples));
+            auto audio = std::make_shared<juce::AudioBuffer<float>>(static_cast<int>(reader->numChannels), 
+                                                                    static_cast<int>(reader->lengthInSamples));
             
             // Read the audio data
-            if (reader->read(&info.buffer, 0, static_cast<int>(reader->lengthInSamples), 0, true, true))
+            if (reader->read(audio.get(), 0, static_cast<int>(reader->lengthInSamples), 0, true, true))
             {
-                // Add to sample bank
-                sampleBank.push_back(info);
-                
-                // Initialize processed buffer for this sample
-                processedBuffers.emplace_back();
-                
-                // Set current sample rate
-                this->currentSampleRate = currentSampleRate;
-                
-                // Resample if necessary
-                if (std::abs(currentSampleRate - reader->sampleRate) > 0.1)
-                {
-                    if (!performSampleRateConversion(info.buffer, info.originalSampleRate, currentSampleRate, processedBuffers.back())) {
-                        // If resampling fails, use original buffer
-                        processedBuffers.back() = info.buffer;
-                    }
-                }
-                else
-                {
-                    // No resampling needed
-                    processedBuffers.back() = info.buffer;
-                }
-                
-                // Update random distribution for new sample count
-                if (sampleBank.size() > 1) {
-                    randomDistribution = std::uniform_int_distribution<int>(0, static_cast<int>(sampleBank.size()) - 1);
-                }
-                
-                // Trigger timestretch update for the new sample
-                        
+                prepareSample(info, std::move(audio));
                 return true;
             }
         }
@@ -186,12 +457,13 @@ bool SampleManager::loadDefaultSample(double currentSampleRate)
 
 bool SampleManager::reloadSampleFromPath(double currentSampleRate)
 {
-    if (sampleBank.empty()) {
+    const auto currentBank = getBank();
+    if (currentBank->isEmpty()) {
         return false;
     }
     
     // Try to reload the first sample from its path
-    juce::File sampleFile(sampleBank[0].path);
+    juce::File sampleFile((*currentBank)[0].path);
     if (!sampleFile.existsAsFile()) {
         return false;
     }
@@ -200,152 +472,267 @@ bool SampleManager::reloadSampleFromPath(double currentSampleRate)
     return loadSample(sampleFile, currentSampleRate);
 }
 
-void SampleManager::setProcessedSampleBuffer(const juce::AudioBuffer<float>& buffer, int index)
+void SampleManager::removeSample(int index)
 {
-    std::lock_guard<std::mutex> lock(sampleBankMutex);
-    if (index >= 0 && index < static_cast<int>(processedBuffers.size())) {
-        processedBuffers[index] = buffer;
-    }
+    modifyBank([index](std::vector<SampleInfo>& samples) {
+        if (index >= 0 && index < static_cast<int>(samples.size())) {
+            samples.erase(samples.begin() + index);
+        }
+    });
 }
 
-void SampleManager::clearProcessedBuffer(int index)
+void SampleManager::clearSampleBank()
 {
-    std::lock_guard<std::mutex> lock(sampleBankMutex);
-    if (index >= 0 && index < static_cast<int>(processedBuffers.size())) {
-        processedBuffers[index].clear();
-    }
+    modifyBank([](std::vector<SampleInfo>& samples) {
+        samples.clear();
+    });
 }
 
-void SampleManager::removeSample(int index)
+int SampleManager::restoreBank(const std::vector<SampleState>& states, double currentSampleRate)
 {
-    std::lock_guard<std::mutex> lock(sampleBankMutex);
-    if (index >= 0 && index < static_cast<int>(sampleBank.size())) {
-        sampleBank.erase(sampleBank.begin() + index);
-        processedBuffers.erase(processedBuffers.begin() + index);
-        
-        // Update random distribution for new sample count
-        if (sampleBank.size() > 1) {
-            randomDistribution = std::uniform_int_distribution<int>(0, static_cast<int>(sampleBank.size()) - 1);
-        } else {
-            randomDistribution = std::uniform_int_distribution<int>(0, 0);
+    ESKILATOR_TRACE_SCOPE("SampleManager::restoreBank", "loader");
+
+    this->currentSampleRate = currentSampleRate;
+
+    const auto currentBank = getBank();
+    const auto& loadedSamples = currentBank->getSamples();
+    const auto conditioning = getConditioning();
+
+    // Whether a loaded sample holds what reading the file now would give
+    auto isCurrent = [&conditioning, currentSampleRate](const SampleInfo& sample, const juce::String& path,
+                                                        juce::int64 size, juce::int64 modificationTime) {
+        const double expectedRate = std::abs(sample.originalSampleRate - currentSampleRate) > 0.1 ? currentSampleRate
+                                                                                                  : sample.originalSampleRate;
+        const bool sameConditioning = sample.conditionedWith == conditioning
+                                      || (!sample.conditionedWith.enabled && !conditioning.enabled);
+        return !sample.isDefault && sample.path == path && sample.fileSize == size
+               && sample.fileModificationTime == modificationTime
+               && std::abs(sample.bufferSampleRate - expectedRate) < 1.0e-6 && sameConditioning;
+    };
+
+    std::vector<SampleInfo> samples;
+    samples.reserve(states.size());
+    int filesRead = 0;
+
+    for (const auto& state : states) {
+        if (!juce::File::isAbsolutePath(state.path)) {
+            continue;
         }
-        
-        // Adjust chain selector if it's now out of bounds
-        if (chainSelector >= static_cast<int>(sampleBank.size())) {
-            chainSelector = static_cast<int>(sampleBank.size()) - 1;
-            if (chainSelector < 0) chainSelector = 0;
+
+        const juce::File file(state.path);
+        if (!file.existsAsFile()) {
+            continue;
+        }
+
+        const auto path = file.getFullPathName();
+        const auto size = file.getSize();
+        const auto modificationTime = file.getLastModificationTime().toMilliseconds();
+        const auto match = std::find_if(loadedSamples.begin(), loadedSamples.end(), [&](const SampleInfo& sample) {
+            return isCurrent(sample, path, size, modificationTime);
+        });
+
+        SampleInfo sample;
+        if (match != loadedSamples.end()) {
+            sample = *match;
         }
+        else {
+            if (!readSample(file, currentSampleRate, sample)) {
+                continue;
+            }
+            ++filesRead;
+        }
+
+        sample.gain = juce::jlimit(-24.0f, 24.0f, state.gain);
+        sample.transpose = juce::jlimit(-12.0f, 12.0f, state.transpose);
+        sample.mapping = state.mapping.getValidated();
+        if (state.hasLoop && state.loop != sample.loop) {
+            sample.loop = state.loop;
+            sample.loopRegion = nullptr;
+        }
+        if (sample.loopRegion == nullptr) {
+            updateLoopRegion(sample);
+        }
+
+        samples.push_back(std::move(sample));
     }
-}
 
-void SampleManager::clearSampleBank()
-{
-    std::lock_guard<std::mutex> lock(sampleBankMutex);
-    sampleBank.clear();
-    processedBuffers.clear();
-    chainSelector = 0;
-    randomDistribution = std::uniform_int_distribution<int>(0, 0);
+    // Files hashed in this pass are indexed in one write
+    if (const auto sampleCache = getCache()) {
+        sampleCache->saveIndexIfChanged();
+    }
+
+    // Nothing restored: a loaded built-in sample stays, with its parameters reset, or one
+    // is read into this snapshot, so playback never sees an empty bank in between
+    if (samples.empty()) {
+        const auto builtIn = std::find_if(loadedSamples.begin(), loadedSamples.end(),
+                                          [](const SampleInfo& sample) { return sample.isDefault; });
+        if (builtIn != loadedSamples.end()) {
+            SampleInfo sample = *builtIn;
+            sample.gain = 0.0f;
+            sample.transpose = 0.0f;
+            sample.mapping = {};
+            if (sample.loop != SampleLoop {}) {
+                sample.loop = {};
+                updateLoopRegion(sample);
+            }
+            samples.push_back(std::move(sample));
+        }
+        else {
+            SampleInfo sample;
+            if (readDefaultSample(sample)) {
+                updateLoopRegion(sample);
+                samples.push_back(std::move(sample));
+            }
+        }
+    }
+
+    // Same audio and parameters in the same order: nothing to publish
+    auto isUnchanged = [](const SampleInfo& restored, const SampleInfo& loaded) {
+        return restored.buffer == loaded.buffer && restored.path == loaded.path && restored.gain == loaded.gain
+               && restored.transpose == loaded.transpose && restored.mapping == loaded.mapping
+               && restored.loopRegion == loaded.loopRegion;
+    };
+    if (std::equal(samples.begin(), samples.end(), loadedSamples.begin(), loadedSamples.end(), isUnchanged)) {
+        return filesRead;
+    }
+
+    {
+        ESKILATOR_TRACE_SCOPE("restoreBank: publish", "loader");
+        modifyBank([&samples](std::vector<SampleInfo>& bankSamples) { bankSamples = std::move(samples); });
+    }
+
+    PluginLogger::conditionalLog("Restored " + juce::String(static_cast<int>(states.size())) + " samples, "
+                                 + juce::String(filesRead) + " read from disk");
+    return filesRead;
 }
 
 juce::String SampleManager::getSampleName(int index) const
 {
-    std::lock_guard<std::mutex> lock(sampleBankMutex);
-    if (index >= 0 && index < static_cast<int>(sampleBank.size())) {
-        return sampleBank[index].name;
+    const auto currentBank = getBank();
+    if (currentBank->isValidIndex(index)) {
+        return (*currentBank)[index].name;
     }
     return "";
 }
 
 double SampleManager::getOriginalSampleRate(int index) const
 {
-    std::lock_guard<std::mutex> lock(sampleBankMutex);
-    if (index >= 0 && index < static_cast<int>(sampleBank.size())) {
-        return sampleBank[index].originalSampleRate;
+    const auto currentBank = getBank();
+    if (currentBank->isValidIndex(index)) {
+        return (*currentBank)[index].originalSampleRate;
     }
     return 44100.0;
 }
 
-const juce::String& SampleManager::getSamplePath(int index) const
+juce::String SampleManager::getSamplePath(int index) const
 {
-    std::lock_guard<std::mutex> lock(sampleBankMutex);
-    if (index >= 0 && index < static_cast<int>(sampleBank.size())) {
-        return sampleBank[index].path;
+    const auto currentBank = getBank();
+    if (currentBank->isValidIndex(index)) {
+        return (*currentBank)[index].path;
     }
-    static const juce::String emptyString;
-    return emptyString;
+    return {};
 }
 
-const juce::AudioBuffer<float>& SampleManager::getSampleBuffer(int index) const
+std::shared_ptr<const juce::AudioBuffer<float>> SampleManager::getSampleBuffer(int index) const
 {
-    std::lock_guard<std::mutex> lock(sampleBankMutex);
-    if (index >= 0 && index < static_cast<int>(sampleBank.size())) {
-        return sampleBank[index].buffer;
+    const auto currentBank = getBank();
+    if (currentBank->isValidIndex(index)) {
+        return (*currentBank)[index].buffer;
     }
-    static const juce::AudioBuffer<float> emptyBuffer;
-    return emptyBuffer;
+    return nullptr;
 }
 
-const juce::AudioBuffer<float>& SampleManager::getProcessedSampleBuffer(int index) const
+int SampleManager::getChainSelectedIndex(int sampleCount) const
 {
-    std::lock_guard<std::mutex> lock(sampleBankMutex);
-    if (index >= 0 && index < static_cast<int>(processedBuffers.size())) {
-        return processedBuffers[index];
+    if (sampleCount <= 1) {
+        return 0;
     }
-    static const juce::AudioBuffer<float> emptyBuffer;
-    return emptyBuffer;
+
+    // Map the chain position (0-1) to the nearest index (0 to sampleCount-1)
+    return juce::jlimit(0, sampleCount - 1, static_cast<int>(chainPosition.load() * static_cast<float>(sampleCount - 1) + 0.5f));
+}
+
+int SampleManager::getChoiceSampleIndex(const SampleBank& sampleBank, const Keymap::Choice& choice, std::uint32_t rotation) const
+{
+    const int member = choice.roundRobinGroup > 0 ? static_cast<int>(rotation % choice.numMembers) : 0;
+    return sampleBank.getKeymap().getSampleIndex(choice, member);
 }
 
-int SampleManager::getCurrentSampleIndexInternal() const
+int SampleManager::selectSampleIndex(const SampleBank& sampleBank, int noteNumber, int velocity, bool* followsChain) const
 {
-    if (sampleBank.empty()) {
+    const auto choices = sampleBank.getKeymap().getChoices(noteNumber, velocity);
+    if (choices.size == 0) {
         return -1;
     }
-    
-    // If we haven't made a randomization decision for this trigger yet, make it now
-    if (!randomizationDecisionMade) {
-        randomizationDecisionMade = true;
-        
-        // If randomization is enabled, decide whether to use random or chain selector
-        if (randomizationAmount > 0.0f) {
-            // Use randomization amount to determine probability of random selection
-            float randomValue = static_cast<float>(randomGenerator()) / static_cast<float>(std::mt19937::max());
-            if (randomValue < randomizationAmount) {
-                // Use random selection
-                cachedSampleIndex = randomDistribution(randomGenerator);
-                return cachedSampleIndex;
-            }
-        }
-        
-        // Use chain selector
-        int sampleCount = static_cast<int>(sampleBank.size());
-        if (sampleCount <= 1) {
-            cachedSampleIndex = 0;
-        } else {
-            // Map chain selector value (0-63) to sample index (0 to sampleCount-1)
-            float normalizedSelector = static_cast<float>(chainSelector) / 63.0f;
-            cachedSampleIndex = static_cast<int>(normalizedSelector * (sampleCount - 1) + 0.5f);
-            cachedSampleIndex = juce::jlimit(0, sampleCount - 1, cachedSampleIndex);
-        }
+
+    int choiceIndex = -1;
+
+    // If randomization is enabled, decide whether to use random or chain selector
+    const float amount = randomizationAmount;
+    if (amount > 0.0f && randomGenerator.nextFloat() < amount) {
+        choiceIndex = randomGenerator.nextInt(choices.size);
     }
-    
-    return cachedSampleIndex;
+
+    if (followsChain != nullptr) {
+        *followsChain = choiceIndex < 0;
+    }
+
+    // Use the chain position
+    if (choiceIndex < 0) {
+        choiceIndex = getChainSelectedIndex(choices.size);
+    }
+
+    // A round-robin group plays its members in turn
+    const auto& choice = choices[choiceIndex];
+    std::uint32_t rotation = 0;
+    if (choice.roundRobinGroup > 0) {
+        rotation = roundRobinCounters[static_cast<size_t>(choice.roundRobinGroup)]++;
+    }
+
+    const int selectedIndex = getChoiceSampleIndex(sampleBank, choice, rotation);
+    cachedSampleIndex = selectedIndex;
+    return selectedIndex;
 }
 
-int SampleManager::getCurrentSampleIndex() const
+SampleManager::ChainBlend SampleManager::getChainBlend(const SampleBank& sampleBank, int noteNumber, int velocity, float position) const
 {
-    std::lock_guard<std::mutex> lock(sampleBankMutex);
-    return getCurrentSampleIndexInternal();
+    ChainBlend blend;
+    const auto choices = sampleBank.getKeymap().getChoices(noteNumber, velocity);
+    if (choices.size == 0) {
+        return blend;
+    }
+
+    // Groups resolve to the member their last trigger played
+    auto lastPlayed = [this, &sampleBank](const Keymap::Choice& choice) {
+        const auto counter = choice.roundRobinGroup > 0 ? roundRobinCounters[static_cast<size_t>(choice.roundRobinGroup)] : 0u;
+        return getChoiceSampleIndex(sampleBank, choice, counter > 0 ? counter - 1 : 0);
+    };
+
+    const float scaledPosition = juce::jlimit(0.0f, 1.0f, position) * static_cast<float>(choices.size - 1);
+    const int lower = juce::jlimit(0, choices.size - 1, static_cast<int>(scaledPosition));
+    blend.sampleIndex = lastPlayed(choices[lower]);
+
+    const float fraction = scaledPosition - static_cast<float>(lower);
+    if (fraction > 0.0f && lower + 1 < choices.size) {
+        const int upperIndex = lastPlayed(choices[lower + 1]);
+        if (upperIndex != blend.sampleIndex) {
+            blend.morphIndex = upperIndex;
+            blend.morphAmount = fraction;
+        }
+    }
+
+    return blend;
 }
 
-const juce::AudioBuffer<float>& SampleManager::getCurrentSampleBuffer() const
+int SampleManager::getCurrentSampleIndex() const
 {
-    std::lock_guard<std::mutex> lock(sampleBankMutex);
-    int currentIndex = getCurrentSampleIndexInternal();
-    if (currentIndex >= 0 && currentIndex < static_cast<int>(sampleBank.size())) {
-        return sampleBank[currentIndex].buffer;
+    const int sampleCount = getSampleCount();
+    if (sampleCount == 0) {
+        return -1;
     }
-    static const juce::AudioBuffer<float> emptyBuffer(1, 1); // Initialize with 1 channel, 1 sample
-    return emptyBuffer;
+
+    const int cached = cachedSampleIndex;
+    return cached >= 0 ? juce::jmin(cached, sampleCount - 1) : getChainSelectedIndex(sampleCount);
 }
 
 bool SampleManager::performSampleRateConversion(const juce::AudioBuffer<float>& sourceBuffer, 
@@ -360,30 +747,11 @@ bool SampleManager::performSampleRateConversion(const juce::AudioBuffer<float>&
     // Resize destination buffer for resampled data
     destBuffer.setSize(sourceBuffer.getNumChannels(), resampledLength);
     
-    // Perform simple linear interpolation resampling
+    // Perform simple linear interpolation resampling (kernel picked for this CPU)
+    const auto* kernelTable = kernels.load();
     for (int channel = 0; channel < sourceBuffer.getNumChannels(); ++channel) {
-        auto* sourceData = sourceBuffer.getReadPointer(channel);
-        auto* destData = destBuffer.getWritePointer(channel);
-        
-        for (int destSample = 0; destSample < resampledLength; ++destSample) {
-            // Calculate source position with linear interpolation
-            double sourcePos = destSample / conversionRatio;
-            int sourceSample = static_cast<int>(sourcePos);
-            double fraction = sourcePos - sourceSample;
-            
-            if (sourceSample < sourceBuffer.getNumSamples() - 1) {
-                // Linear interpolation between two samples
-                float sample1 = sourceData[sourceSample];
-                float sample2 = sourceData[sourceSample + 1];
-                destData[destSample] = sample1 + fraction * (sample2 - sample1);
-            } else if (sourceSample < sourceBuffer.getNumSamples()) {
-                // Use last sample if at the end
-                destData[destSample] = sourceData[sourceSample];
-            } else {
-                // Silence if beyond source
-                destData[destSample] = 0.0f;
-            }
-        }
+        kernelTable->resampleLinear(sourceBuffer.getReadPointer(channel), sourceBuffer.getNumSamples(),
+                                    destBuffer.getWritePointer(channel), resampledLength, 1.0 / conversionRatio);
     }
     
     return true;
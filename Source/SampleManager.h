@@ -1,23 +1,94 @@
 #pragma once
 
-#include <JuceHeader.h>
+#include <juce_audio_formats/juce_audio_formats.h>
 #include <functional>
+#include <memory>
 #include <vector>
-#include <random>
+#include <array>
 #include <atomic>
 #include <mutex>
+#include "KernelDispatch.h"
+#include "Keymap.h"
+#include "SampleLoop.h"
+#include "SampleConditioning.h"
+#include "SampleAnalysis.h"
+#include "SampleCache.h"
+#include "FastRandom.h"
 
 struct SampleInfo
 {
-    juce::AudioBuffer<float> buffer;
+    // Decoded audio, shared by every bank snapshot that holds this sample and never
+    // modified after loading
+    std::shared_ptr<const juce::AudioBuffer<float>> buffer;
     juce::String name;
     juce::String path;
     double originalSampleRate = 44100.0;
+    double bufferSampleRate = 44100.0;   // Rate the buffer holds (the session rate after resampling)
     bool isDefault = false;
     
     // Per-sample parameters
     float gain = 0.0f;        // Gain in dB (-24 to +24)
     float transpose = 0.0f;   // Transpose in semitones (-12 to +12)
+
+    // Root key, key and velocity range, round-robin group
+    SampleMapping mapping;
+
+    // Start, end and loop points (source-file frames) and their pre-rendered wrap region,
+    // rebuilt whenever the points change
+    SampleLoop loop;
+    std::shared_ptr<const LoopRegion> loopRegion;
+
+    // What import conditioning did (trimmed frames, memory saved); all zero when it was off
+    ConditioningReport conditioning;
+    ConditioningSettings conditionedWith;
+
+    // Size and modification time (ms) of the file when it was read, to detect changes
+    juce::int64 fileSize = 0;
+    juce::int64 fileModificationTime = 0;
+
+    // Load-time analysis: waveform overview and the detected pitch (not applied to the mapping)
+    std::shared_ptr<const WaveformPeaks> peaks;
+    int detectedRootNote = SampleAnalysis::UNPITCHED;
+
+    bool isLooping() const { return loopRegion != nullptr && loopRegion->isLooping(); }
+};
+
+// A bank entry as saved in the plugin state (see SampleManager::restoreBank)
+struct SampleState
+{
+    juce::String path;
+    float gain = 0.0f;
+    float transpose = 0.0f;
+    bool hasLoop = false;     // States from before loop points keep the file's own loop
+    SampleLoop loop;
+    SampleMapping mapping;
+};
+
+// Immutable snapshot of the sample bank. Every change publishes a new snapshot, so the
+// audio thread and the editor can read one without locks while other threads load,
+// remove or clear samples. The keymap is compiled with the snapshot, or shared with the
+// previous one when no mapping changed.
+class SampleBank : public juce::ReferenceCountedObject
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<SampleBank>;
+
+    SampleBank() = default;
+    SampleBank(std::vector<SampleInfo> bankSamples, const SampleBank& previous);
+
+    int size() const { return static_cast<int>(samples.size()); }
+    bool isEmpty() const { return samples.empty(); }
+    bool isValidIndex(int index) const { return index >= 0 && index < size(); }
+
+    const SampleInfo& operator[](int index) const { return samples[static_cast<size_t>(index)]; }
+    const std::vector<SampleInfo>& getSamples() const { return samples; }
+
+    const Keymap& getKeymap() const { return *keymap; }
+
+private:
+    const std::vector<SampleInfo> samples;
+    const std::vector<SampleMapping> mappings;
+    const std::shared_ptr<const Keymap> keymap = std::make_shared<const Keymap>();
 };
 
 class SampleManager
@@ -28,36 +99,36 @@ public:
     
     // Load sample from file
     bool loadSample(const juce::File& audioFile, double currentSampleRate);
+
+    // Load decoded audio from memory (resampled to currentSampleRate). The sample has no
+    // path, so it is not saved with the plugin state.
+    bool loadSample(const juce::AudioBuffer<float>& audio, double sourceSampleRate,
+                    const juce::String& name, double currentSampleRate);
     
     // Load default click sample from binary data
     bool loadDefaultSample(double currentSampleRate);
     
     // Reload sample from previously stored path
     bool reloadSampleFromPath(double currentSampleRate);
+
+    // Current bank snapshot. Real-time safe: a short spin lock and a reference count
+    // increment. Hold the pointer for as long as references into the bank are used.
+    SampleBank::Ptr getBank() const;
     
     // Check if any samples are loaded
-    bool hasSample() const { return !sampleBank.empty(); }
+    bool hasSample() const { return !getBank()->isEmpty(); }
     
     // Check if a specific sample exists
-    bool hasSampleAtIndex(int index) const { return index >= 0 && index < static_cast<int>(sampleBank.size()); }
+    bool hasSampleAtIndex(int index) const { return getBank()->isValidIndex(index); }
     
     // Get sample information
     juce::String getSampleName(int index = 0) const;
     double getOriginalSampleRate(int index = 0) const;
-    const juce::String& getSamplePath(int index = 0) const;
-    
-    // Get sample buffers
-    const juce::AudioBuffer<float>& getSampleBuffer(int index = 0) const;
-    const juce::AudioBuffer<float>& getProcessedSampleBuffer(int index = 0) const;
+    juce::String getSamplePath(int index = 0) const;
     
-    // Set processed sample buffer (for timestretch) - thread-safe
-    void setProcessedSampleBuffer(const juce::AudioBuffer<float>& buffer, int index = 0);
-    
-    // Thread-safe buffer copy method
-    bool copyBufferSafely(const juce::AudioBuffer<float>& source, juce::AudioBuffer<float>& dest) const;
-    
-    // Clear processed buffer
-    void clearProcessedBuffer(int index = 0);
+    // Get sample audio (nullptr if the index is out of range). The buffer stays valid
+    // while the returned pointer is held, even if the sample is removed meanwhile.
+    std::shared_ptr<const juce::AudioBuffer<float>> getSampleBuffer(int index = 0) const;
     
     // Set sample rate (for resampling)
     void setSampleRate(double sampleRate) { currentSampleRate = sampleRate; }
@@ -65,73 +136,152 @@ public:
     // Get current sample rate
     double getSampleRate() const { return currentSampleRate; }
 
+    // Kernel set used for import resampling (selected by the processor in prepareToPlay)
+    void setKernels(const KernelDispatch::KernelTable& table) { kernels = &table; }
+
     // Sample bank management
-    int getSampleCount() const { return static_cast<int>(sampleBank.size()); }
+    int getSampleCount() const { return getBank()->size(); }
     void removeSample(int index);
     void clearSampleBank();
+
+    // Make the bank match a saved state, replacing it in one publish so playback never sees
+    // it empty. Samples whose file is unchanged since it was read (path, size and
+    // modification time, read at this session rate and conditioning) keep their audio and
+    // only take the saved parameters; the rest are read again. Missing files are skipped,
+    // and when nothing is restored a loaded built-in sample stays, or the built-in sample is
+    // read into the same publish. A state that matches the bank publishes nothing. Returns
+    // the number of files read.
+    int restoreBank(const std::vector<SampleState>& states, double currentSampleRate);
     
-    // Chain selection and randomization
-    void setChainSelector(int selector) { 
-        // Keep full 0-63 range, mapping happens in getCurrentSampleIndex()
-        chainSelector = juce::jlimit(0, 63, selector); 
-        
-        // Reset randomization cache so the new selection takes effect immediately
-        resetRandomizationCache();
-    }
-    int getChainSelector() const { return chainSelector; }
+    // Chain position: 0-1 across the choices covering a key (the sampleChain parameter,
+    // set by the engine every block). Triggers pick the nearest choice; a sounding voice
+    // morphs between the two either side of it (see getChainBlend).
+    void setChainPosition(float position) { chainPosition = juce::jlimit(0.0f, 1.0f, position); }
+    float getChainPosition() const { return chainPosition; }
     
     void setRandomizationAmount(float amount) { randomizationAmount = juce::jlimit(0.0f, 1.0f, amount); }
     float getRandomizationAmount() const { return randomizationAmount; }
+
+    // Restart the random sequence and the round-robin rotation. Call while no render is
+    // in progress (prepare); the same seed gives the same selections.
+    void setRandomSeed(std::uint64_t seed);
     
-    // Reset randomization cache for new triggers
-    void resetRandomizationCache() const { randomizationDecisionMade = false; cachedSampleIndex = -1; }
-    
-    // Get the currently selected sample based on chain selector and randomization
+    // Audio thread, at a trigger: the sample for a note and velocity from the snapshot's
+    // keymap, or -1 when no sample covers them. Where several do, the chain position or
+    // randomization picks one, and a round-robin group rotates to its next member.
+    // followsChain (optional) is set when the chain position made the pick.
+    int selectSampleIndex(const SampleBank& bank, int noteNumber, int velocity, bool* followsChain = nullptr) const;
+
+    // The choices either side of a chain position (0-1, the engine passes its smoothed
+    // one) for a note and velocity: the sample at or below it, the next one and the
+    // fraction between them. morphIndex is -1 when the position sits on a choice (or both
+    // sides are the same sample). Round-robin choices resolve to the member played last.
+    struct ChainBlend
+    {
+        int sampleIndex = -1;
+        int morphIndex = -1;
+        float morphAmount = 0.0f;
+    };
+
+    // Audio thread only (reads the round-robin positions)
+    ChainBlend getChainBlend(const SampleBank& bank, int noteNumber, int velocity, float position) const;
+
+    // Any thread: the sample last selected for playback, or the chain position's pick
+    // before the first trigger. Never makes a decision.
     int getCurrentSampleIndex() const;
     
-    // Get current sample buffer considering chain selection and randomization
-    const juce::AudioBuffer<float>& getCurrentSampleBuffer() const;
-    
     // Per-sample parameter management
     void setSampleGain(int index, float gainDb);
     float getSampleGain(int index) const;
     void setSampleTranspose(int index, float semitones);
     float getSampleTranspose(int index) const;
+    void setSampleMapping(int index, const SampleMapping& mapping);
+    SampleMapping getSampleMapping(int index) const;
+
+    // Start, end and loop points; the loop's wrap region is rendered here, off the audio thread
+    void setSampleLoop(int index, const SampleLoop& loop);
+    SampleLoop getSampleLoop(int index) const;
+
+    // Import conditioning, applied to samples loaded from now on (off by default; the
+    // built-in sample is never conditioned)
+    void setConditioning(const ConditioningSettings& settings);
+    ConditioningSettings getConditioning() const;
+    ConditioningReport getConditioningReport(int index) const;
+
+    // Load-time analysis results (nullptr / UNPITCHED if the index is out of range)
+    std::shared_ptr<const WaveformPeaks> getSamplePeaks(int index) const;
+    int getDetectedRootNote(int index) const;
+
+    // On-disk cache for file loads (none by default): a file imported before at the same
+    // session rate and conditioning is memory-mapped instead of decoded
+    void setCache(std::shared_ptr<SampleCache> sampleCache);
+    std::shared_ptr<SampleCache> getCache() const;
 
 private:
-    std::vector<SampleInfo> sampleBank;
-    std::vector<juce::AudioBuffer<float>> processedBuffers;
+    // Published snapshot; swapped under bankLock, which is only held for a pointer copy
+    SampleBank::Ptr bank { new SampleBank() };
+    mutable juce::SpinLock bankLock;
+
+    // Serialises writers, so concurrent edits are never lost. Decoding happens before
+    // taking it.
+    std::mutex writerMutex;
+
+    // Replaced snapshots, freed by writers once nobody else holds them. The audio thread
+    // may still be reading a snapshot when it is replaced; this way it never frees one.
+    std::vector<SampleBank::Ptr> retiredBanks;
     
-    // Thread synchronization for buffer access
-    mutable juce::CriticalSection bufferLock;
-    mutable std::atomic<bool> bufferInUse{false};
+    std::atomic<double> currentSampleRate { 44100.0 };
+
+    std::atomic<const KernelDispatch::KernelTable*> kernels { &KernelDispatch::selectKernels() };
     
-    double currentSampleRate = 44100.0;
+    // Import settings, read by every load
+    ConditioningSettings conditioningSettings;
+    std::shared_ptr<SampleCache> cache;
+    mutable std::mutex loadSettingsMutex;
     
     // Chain selection and randomization
-    int chainSelector = 0;           // Which sample to play (0 = first sample)
-    float randomizationAmount = 0.0f; // 0.0 = no randomization, 1.0 = full random
+    std::atomic<float> chainPosition { 0.0f };        // 0.0 = first choice, 1.0 = last
+    std::atomic<float> randomizationAmount { 0.0f };  // 0.0 = no randomization, 1.0 = full random
     
-    // Random number generation for sample selection
-    mutable std::mt19937 randomGenerator;
-    mutable std::uniform_int_distribution<int> randomDistribution;
+    // Random number generation and round-robin positions for sample selection (audio thread only)
+    mutable FastRandom randomGenerator;
+    mutable std::array<std::uint32_t, SampleMapping::MAX_ROUND_ROBIN_GROUPS + 1> roundRobinCounters {};
     
-    // Cache for randomization decision (to prevent rapid switching within a single trigger)
-    mutable int cachedSampleIndex = -1;
-    mutable bool randomizationDecisionMade = false;
-
-    // Thread safety for sample bank modifications
-    mutable std::mutex sampleBankMutex;
+    // Sample picked at the last trigger, for display
+    mutable std::atomic<int> cachedSampleIndex { -1 };
     
     // Helper methods
     bool performSampleRateConversion(const juce::AudioBuffer<float>& sourceBuffer, 
                                    double sourceSampleRate, 
                                    double targetSampleRate,
                                    juce::AudioBuffer<float>& destBuffer);
-    
-    // Internal version without mutex lock (for use within already-locked methods)
-    int getCurrentSampleIndexInternal() const;
 
-    // Initialize random generator
-    void initializeRandomGenerator();
+    // Read a file (from the cache or by decoding) into a sample ready to publish
+    bool readSample(const juce::File& audioFile, double currentSampleRate, SampleInfo& newSample);
+
+    // Condition and analyse decoded audio, hand it to the sample and store it in the cache
+    // (when a key is given)
+    void prepareSample(SampleInfo& info, std::shared_ptr<juce::AudioBuffer<float>> audio,
+                       const SampleCache::Key* cacheKey = nullptr);
+
+    // Decode the built-in sample into a sample ready to publish
+    bool readDefaultSample(SampleInfo& info);
+
+    // Add a ready sample to the end of the bank
+    void publishSample(SampleInfo info);
+
+    // Run the conditioning pipeline on a sample's decoded audio before it is published
+    void conditionSample(SampleInfo& info, juce::AudioBuffer<float>& audio) const;
+
+    // Render the wrap region for the sample's current points
+    static void updateLoopRegion(SampleInfo& info);
+
+    // Publish the result of applying an edit to a copy of the current bank
+    void modifyBank(const std::function<void(std::vector<SampleInfo>&)>& edit);
+
+    // The chain position's pick (the nearest) among the given number of choices
+    int getChainSelectedIndex(int sampleCount) const;
+
+    // Bank index a choice plays: a round-robin group's member at the given rotation
+    int getChoiceSampleIndex(const SampleBank& bank, const Keymap::Choice& choice, std::uint32_t rotation) const;
 };
@@ -0,0 +1,196 @@
+#include "Trace.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <thread>
+
+namespace
+{
+    struct Event
+    {
+        const char* name;
+        const char* category;
+        std::uint64_t startNs;
+        std::uint64_t endNs;
+    };
+
+    struct ThreadBuffer
+    {
+        std::unique_ptr<Event[]> events;
+        std::atomic<int> count { 0 };
+        std::atomic<std::uint64_t> dropped { 0 };
+        std::atomic<const char*> name { nullptr };
+        std::atomic<bool> claimed { false };
+        std::thread::id threadId;               // Written before 'claimed' is released
+    };
+
+    // Buffers are allocated once and live until exit, so a thread still inside a
+    // scope when tracing stops or restarts never writes to freed memory
+    std::array<ThreadBuffer, Trace::MAX_THREADS> buffers;
+    std::atomic<int> numClaimed { 0 };
+    int capacity = 0;
+    std::uint64_t originNs = 0;
+
+    // Lock-free lookup: scan the claimed slots for this thread, claim a new one on first use
+    ThreadBuffer* getThreadBuffer() noexcept
+    {
+        const auto threadId = std::this_thread::get_id();
+        const int numSlots = std::min(numClaimed.load(std::memory_order_acquire), Trace::MAX_THREADS);
+
+        for (int slot = 0; slot < numSlots; ++slot)
+        {
+            auto& buffer = buffers[static_cast<size_t>(slot)];
+            if (buffer.claimed.load(std::memory_order_acquire) && buffer.threadId == threadId)
+                return &buffer;
+        }
+
+        const int slot = numClaimed.fetch_add(1, std::memory_order_acq_rel);
+        if (slot >= Trace::MAX_THREADS)
+            return nullptr;
+
+        auto& buffer = buffers[static_cast<size_t>(slot)];
+        buffer.threadId = threadId;
+        buffer.claimed.store(true, std::memory_order_release);
+        return &buffer;
+    }
+
+    void writeString(std::ostream& stream, const char* text)
+    {
+        stream << '"';
+        for (const char* c = text; *c != '\0'; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+                stream << '\\';
+            stream << *c;
+        }
+        stream << '"';
+    }
+}
+
+namespace Trace
+{
+    namespace Detail
+    {
+        std::atomic<bool> enabled { false };
+    }
+
+    bool start(int eventsPerThread)
+    {
+        if (isEnabled())
+            return false;
+
+        if (capacity == 0)
+        {
+            capacity = eventsPerThread > 0 ? eventsPerThread : DEFAULT_EVENTS_PER_THREAD;
+            for (auto& buffer : buffers)
+                buffer.events = std::make_unique<Event[]>(static_cast<size_t>(capacity));
+        }
+
+        for (auto& buffer : buffers)
+        {
+            buffer.claimed.store(false, std::memory_order_relaxed);
+            buffer.count.store(0, std::memory_order_relaxed);
+            buffer.dropped.store(0, std::memory_order_relaxed);
+            buffer.name.store(nullptr, std::memory_order_relaxed);
+        }
+
+        numClaimed.store(0, std::memory_order_relaxed);
+        originNs = now();
+        Detail::enabled.store(true, std::memory_order_release);
+        return true;
+    }
+
+    void stop()
+    {
+        Detail::enabled.store(false, std::memory_order_release);
+    }
+
+    void setThreadName(const char* name) noexcept
+    {
+        if (auto* buffer = getThreadBuffer())
+            buffer->name.store(name, std::memory_order_relaxed);
+    }
+
+    std::uint64_t now() noexcept
+    {
+        const auto sinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch).count());
+    }
+
+    void record(const char* name, const char* category, std::uint64_t startNs, std::uint64_t endNs) noexcept
+    {
+        auto* buffer = getThreadBuffer();
+        if (buffer == nullptr || capacity == 0)
+            return;
+
+        const int index = buffer->count.load(std::memory_order_relaxed);
+        if (index >= capacity)
+        {
+            buffer->dropped.store(buffer->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return;
+        }
+
+        buffer->events[static_cast<size_t>(index)] = { name, category, startNs, endNs };
+        buffer->count.store(index + 1, std::memory_order_release);
+    }
+
+    bool writeChromeJson(std::ostream& stream)
+    {
+        const int numSlots = std::min(numClaimed.load(std::memory_order_acquire), MAX_THREADS);
+        std::uint64_t totalDropped = 0;
+        bool first = true;
+
+        // Microsecond timestamps with nanosecond resolution
+        const auto previousFlags = stream.flags();
+        const auto previousPrecision = stream.precision();
+        stream << std::fixed << std::setprecision(3);
+
+        stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        for (int slot = 0; slot < numSlots; ++slot)
+        {
+            const auto& buffer = buffers[static_cast<size_t>(slot)];
+            if (!buffer.claimed.load(std::memory_order_acquire))
+                continue;
+
+            const int tid = slot + 1;
+            totalDropped += buffer.dropped.load(std::memory_order_relaxed);
+
+            const std::string threadName = buffer.name.load(std::memory_order_relaxed) != nullptr
+                ? buffer.name.load(std::memory_order_relaxed) : "Thread " + std::to_string(tid);
+            stream << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+                   << ",\"args\":{\"name\":";
+            writeString(stream, threadName.c_str());
+            stream << "}}";
+            first = false;
+
+            const int count = buffer.count.load(std::memory_order_acquire);
+            for (int i = 0; i < count; ++i)
+            {
+                const auto& event = buffer.events[static_cast<size_t>(i)];
+                const double startUs = static_cast<double>(event.startNs - std::min(event.startNs, originNs)) * 1.0e-3;
+                const double durationUs = static_cast<double>(event.endNs - std::min(event.endNs, event.startNs)) * 1.0e-3;
+
+                stream << ",\n{\"name\":";
+                writeString(stream, event.name);
+                stream << ",\"cat\":";
+                writeString(stream, event.category);
+                stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid << ",\"ts\":" << startUs << ",\"dur\":" << durationUs << "}";
+            }
+        }
+
+        stream << "\n],\"otherData\":{\"droppedEvents\":" << totalDropped << "}}\n";
+        stream.flags(previousFlags);
+        stream.precision(previousPrecision);
+        return stream.good();
+    }
+
+    bool writeChromeJson(const std::string& path)
+    {
+        std::ofstream file(path, std::ios::out | std::ios::trunc);
+        return file.is_open() && writeChromeJson(file);
+    }
+}
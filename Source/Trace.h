@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Optional timeline tracing for dropouts and load stalls, exported as Chrome trace
+// JSON (chrome://tracing, ui.perfetto.dev).
+//
+// Only compiled in when ESKILATOR_ENABLE_TRACING is set (CMake option
+// ESKILATOR_TRACING); otherwise the macros below expand to nothing. When compiled
+// in but not started, a scope costs one relaxed atomic load.
+//
+// Each thread records into its own fixed-size buffer (single writer, no locks or
+// allocation); a buffer that fills up drops further events and counts them.
+// start(), stop() and the writers must not be called from the audio thread.
+// Event names and categories must be string literals.
+namespace Trace
+{
+    static constexpr int MAX_THREADS = 32;
+    static constexpr int DEFAULT_EVENTS_PER_THREAD = 1 << 16;
+
+    // Allocate the per-thread buffers (first call only) and start recording.
+    // Returns false if tracing was already running.
+    bool start(int eventsPerThread = DEFAULT_EVENTS_PER_THREAD);
+    void stop();
+
+    // Name the calling thread in the exported trace
+    void setThreadName(const char* name) noexcept;
+
+    // Write everything recorded since start() as Chrome trace JSON
+    bool writeChromeJson(std::ostream& stream);
+    bool writeChromeJson(const std::string& path);
+
+    namespace Detail
+    {
+        extern std::atomic<bool> enabled;
+    }
+
+    inline bool isEnabled() noexcept { return Detail::enabled.load(std::memory_order_relaxed); }
+
+    // Nanoseconds on the steady clock
+    std::uint64_t now() noexcept;
+
+    // Record a complete event on the calling thread's buffer
+    void record(const char* name, const char* category, std::uint64_t startNs, std::uint64_t endNs) noexcept;
+
+    class Scope
+    {
+    public:
+        Scope(const char* eventName, const char* eventCategory) noexcept
+            : name(eventName), category(eventCategory), active(isEnabled()), startNs(active ? now() : 0)
+        {
+        }
+
+        ~Scope()
+        {
+            if (active)
+                record(name, category, startNs, now());
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* name;
+        const char* category;
+        bool active;
+        std::uint64_t startNs;
+    };
+}
+
+#define ESKILATOR_TRACE_JOIN_(a, b) a##b
+#define ESKILATOR_TRACE_JOIN(a, b) ESKILATOR_TRACE_JOIN_(a, b)
+
+#if ESKILATOR_ENABLE_TRACING
+ #define ESKILATOR_TRACE_SCOPE(name, category) const Trace::Scope ESKILATOR_TRACE_JOIN(traceScope, __LINE__) (name, category)
+ #define ESKILATOR_TRACE_THREAD_NAME(name) do { if (Trace::isEnabled()) Trace::setThreadName(name); } while (false)
+#else
+ #define ESKILATOR_TRACE_SCOPE(name, category) do {} while (false)
+ #define ESKILATOR_TRACE_THREAD_NAME(name) do {} while (false)
+#endif
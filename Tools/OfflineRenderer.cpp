@@ -0,0 +1,227 @@
+#include "OfflineRenderer.h"
+#include "PluginProcessor.h"
+
+#include <cmath>
+
+namespace
+{
+    juce::Result applySetup(GliderAudioProcessor& processor, const OfflineRenderer::Setup& setup, double sampleRate)
+    {
+        if (setup.stateFile != juce::File())
+        {
+            auto xml = juce::XmlDocument::parse(setup.stateFile);
+            if (xml == nullptr)
+                return juce::Result::fail("Could not parse state " + setup.stateFile.getFullPathName());
+
+            juce::MemoryBlock stateData;
+            juce::AudioProcessor::copyXmlToBinary(*xml, stateData);
+            processor.setStateInformation(stateData.getData(), static_cast<int>(stateData.getSize()));
+        }
+
+        if (setup.sampleFile != juce::File())
+        {
+            processor.clearSampleBank();
+            processor.loadSample(setup.sampleFile);
+            if (!processor.hasSample())
+                return juce::Result::fail("Could not load sample " + setup.sampleFile.getFullPathName());
+        }
+        else if (setup.stateFile == juce::File())
+        {
+            // The constructor loaded the built-in sample before the render rate was known
+            processor.clearSampleBank();
+            const int numCopies = juce::jmax(1, static_cast<int>(setup.builtInSamples.size()));
+            for (int index = 0; index < numCopies; ++index)
+                processor.loadDefaultSample(sampleRate);
+
+            if (processor.getSampleCount() != numCopies)
+                return juce::Result::fail("Could not load the built-in sample");
+
+            for (int index = 0; index < static_cast<int>(setup.builtInSamples.size()); ++index)
+            {
+                const auto& builtIn = setup.builtInSamples[static_cast<size_t>(index)];
+                processor.setSampleMapping(index, builtIn.mapping);
+                processor.setSampleLoop(index, builtIn.loop);
+            }
+        }
+
+        for (const auto& parameterValue : setup.parameters)
+        {
+            auto* parameter = processor.getAPVTS().getParameter(parameterValue.name.toString());
+            if (parameter == nullptr)
+                return juce::Result::fail("Unknown parameter " + parameterValue.name.toString());
+
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(static_cast<float>(parameterValue.value)));
+        }
+
+        return juce::Result::ok();
+    }
+
+    template <typename SampleType>
+    void renderBlocks(GliderAudioProcessor& processor, const juce::MidiMessageSequence& sequence,
+                      const OfflineRenderer::Settings& settings, juce::AudioBuffer<float>& output)
+    {
+        const int numChannels = output.getNumChannels();
+        const auto outputFrames = static_cast<juce::int64>(output.getNumSamples());
+        juce::AudioBuffer<SampleType> block(numChannels, settings.blockSize);
+        juce::MidiBuffer midi;
+
+        int nextEvent = 0;
+        juce::int64 latency = -1;       // Known once the first block has applied the state's engine settings
+        juce::int64 position = 0;
+
+        while (latency < 0 || position < outputFrames + latency)
+        {
+            const int numFrames = latency < 0 ? settings.blockSize
+                                              : static_cast<int>(juce::jmin<juce::int64>(settings.blockSize, outputFrames + latency - position));
+
+            midi.clear();
+            for (; nextEvent < sequence.getNumEvents(); ++nextEvent)
+            {
+                const auto& message = sequence.getEventPointer(nextEvent)->message;
+                const auto eventFrame = static_cast<juce::int64>(std::llround(message.getTimeStamp() * settings.sampleRate));
+                if (eventFrame >= position + numFrames)
+                    break;
+
+                midi.addEvent(message, static_cast<int>(juce::jmax<juce::int64>(0, eventFrame - position)));
+            }
+
+            juce::AudioBuffer<SampleType> view(block.getArrayOfWritePointers(), numChannels, numFrames);
+            view.clear();
+            processor.processBlock(view, midi);
+
+            if (latency < 0)
+                latency = processor.getLatencySamples();
+
+            // Drop the first 'latency' frames so the output lines up with the MIDI
+            const auto first = juce::jmax<juce::int64>(position, latency);
+            const auto last = juce::jmin<juce::int64>(position + numFrames, outputFrames + latency);
+            for (auto frame = first; frame < last; ++frame)
+                for (int channel = 0; channel < numChannels; ++channel)
+                    output.setSample(channel, static_cast<int>(frame - latency),
+                                     static_cast<float>(view.getSample(channel, static_cast<int>(frame - position))));
+
+            position += numFrames;
+        }
+    }
+}
+
+namespace OfflineRenderer
+{
+    juce::Result readMidiFile(const juce::File& midiFile, juce::MidiMessageSequence& sequence)
+    {
+        juce::FileInputStream stream(midiFile);
+        if (!stream.openedOk())
+            return juce::Result::fail("Could not open " + midiFile.getFullPathName());
+
+        juce::MidiFile file;
+        if (!file.readFrom(stream))
+            return juce::Result::fail(midiFile.getFullPathName() + " is not a Standard MIDI File");
+
+        file.convertTimestampTicksToSeconds();
+
+        sequence.clear();
+        for (int track = 0; track < file.getNumTracks(); ++track)
+            sequence.addSequence(*file.getTrack(track), 0.0);
+
+        // Tempo, time signature and other meta events mean nothing to the processor
+        for (int i = sequence.getNumEvents(); --i >= 0;)
+            if (sequence.getEventPointer(i)->message.isMetaEvent())
+                sequence.deleteEvent(i, false);
+
+        sequence.updateMatchedPairs();
+        return juce::Result::ok();
+    }
+
+    juce::Result render(const juce::MidiMessageSequence& sequence, const Setup& setup,
+                        const Settings& settings, juce::AudioBuffer<float>& output)
+    {
+        if (settings.sampleRate <= 0.0 || settings.blockSize <= 0)
+            return juce::Result::fail("Invalid sample rate or block size");
+
+        GliderAudioProcessor processor;
+
+        const auto channelSet = settings.numChannels == 1 ? juce::AudioChannelSet::mono() : juce::AudioChannelSet::stereo();
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(channelSet);
+        layout.outputBuses.add(channelSet);
+        if (!processor.setBusesLayout(layout))
+            return juce::Result::fail("Unsupported channel count " + juce::String(settings.numChannels));
+
+        processor.setNonRealtime(!settings.realtimeEngine);
+        processor.getEngine().setFullQualityPinned(settings.pinFullQuality);
+        processor.setProcessingPrecision(settings.doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                                  : juce::AudioProcessor::singlePrecision);
+        processor.setRateAndBufferSizeDetails(settings.sampleRate, settings.blockSize);
+        processor.prepareToPlay(settings.sampleRate, settings.blockSize);
+
+        const auto setupResult = applySetup(processor, setup, settings.sampleRate);
+        if (setupResult.failed())
+            return setupResult;
+
+        const double endSeconds = sequence.getEndTime() + settings.tailSeconds;
+        const auto numFrames = static_cast<int>(std::ceil(juce::jmax(0.0, endSeconds) * settings.sampleRate));
+        output.setSize(settings.numChannels, numFrames);
+        output.clear();
+
+        if (settings.doublePrecision)
+            renderBlocks<double>(processor, sequence, settings, output);
+        else
+            renderBlocks<float>(processor, sequence, settings, output);
+
+        processor.releaseResources();
+        return juce::Result::ok();
+    }
+
+    juce::Result writeWav(const juce::File& file, const juce::AudioBuffer<float>& audio,
+                          double sampleRate, int bitsPerSample)
+    {
+        file.getParentDirectory().createDirectory();
+        file.deleteFile();
+
+        // The writer owns the stream once created; on failure the stream is still ours
+        juce::WavAudioFormat wavFormat;
+        auto stream = std::make_unique<juce::FileOutputStream>(file);
+        if (!stream->openedOk())
+            return juce::Result::fail("Could not create " + file.getFullPathName());
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(
+            wavFormat.createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(audio.getNumChannels()),
+                                      bitsPerSample, {}, 0));
+        if (writer == nullptr)
+            return juce::Result::fail("Unsupported WAV format (" + juce::String(bitsPerSample) + "-bit)");
+        stream.release();
+
+        if (!writer->writeFromAudioSampleBuffer(audio, 0, audio.getNumSamples()))
+            return juce::Result::fail("Could not write " + file.getFullPathName());
+
+        return juce::Result::ok();
+    }
+
+    juce::Result readWav(const juce::File& file, juce::AudioBuffer<float>& audio, double& sampleRate)
+    {
+        juce::WavAudioFormat wavFormat;
+        std::unique_ptr<juce::AudioFormatReader> reader(wavFormat.createReaderFor(file.createInputStream().release(), true));
+        if (reader == nullptr)
+            return juce::Result::fail("Could not read " + file.getFullPathName());
+
+        audio.setSize(static_cast<int>(reader->numChannels), static_cast<int>(reader->lengthInSamples));
+        reader->read(&audio, 0, audio.getNumSamples(), 0, true, true);
+        sampleRate = reader->sampleRate;
+        return juce::Result::ok();
+    }
+
+    juce::Result renderJob(const Job& job, const Settings& settings)
+    {
+        juce::MidiMessageSequence sequence;
+        auto result = readMidiFile(job.midiFile, sequence);
+
+        juce::AudioBuffer<float> audio;
+        if (result.wasOk())
+            result = render(sequence, job.setup, settings, audio);
+
+        if (result.wasOk())
+            result = writeWav(job.outputFile, audio, settings.sampleRate, settings.bitsPerSample);
+
+        return result;
+    }
+}
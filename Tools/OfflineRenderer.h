@@ -0,0 +1,64 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "Keymap.h"
+#include "SampleLoop.h"
+
+// Headless offline rendering through GliderAudioProcessor::processBlock, used by the
+// Eskilator_Render command-line tool. Every render builds its own processor, so any
+// number can run in parallel on worker threads.
+namespace OfflineRenderer
+{
+    struct Settings
+    {
+        double sampleRate = 48000.0;
+        int blockSize = 512;
+        int numChannels = 2;
+        int bitsPerSample = 24;             // 16, 24 or 32 (float) for written files
+        double tailSeconds = 2.0;           // Rendered after the last MIDI event
+        bool doublePrecision = false;       // Render through the double-precision path
+        bool realtimeEngine = false;        // Live engine configuration instead of the offline one
+        bool pinFullQuality = false;        // Keep the live engine off the CPU governor's lower tiers
+    };
+
+    // A copy of the built-in sample with its own mapping and playback points
+    struct BuiltInSample
+    {
+        SampleMapping mapping;
+        SampleLoop loop;
+    };
+
+    // What the processor is set up with before rendering. The state is applied first;
+    // a sample replaces the state's bank. With neither, the built-in sample plays, once
+    // per builtInSamples entry when there are any. Parameters are applied last.
+    struct Setup
+    {
+        juce::File sampleFile;
+        juce::File stateFile;               // XML as written by getStateInformation
+        std::vector<BuiltInSample> builtInSamples;
+        juce::NamedValueSet parameters;     // Parameter ID -> plain (unnormalised) value
+    };
+
+    struct Job
+    {
+        juce::File midiFile;
+        juce::File outputFile;
+        Setup setup;
+    };
+
+    // Merge every track of a Standard MIDI File into one sequence timed in seconds
+    juce::Result readMidiFile(const juce::File& midiFile, juce::MidiMessageSequence& sequence);
+
+    // Render a sequence (timestamps in seconds) plus the tail into output. Reported
+    // latency is compensated, so output lines up with the MIDI.
+    juce::Result render(const juce::MidiMessageSequence& sequence, const Setup& setup,
+                        const Settings& settings, juce::AudioBuffer<float>& output);
+
+    juce::Result writeWav(const juce::File& file, const juce::AudioBuffer<float>& audio,
+                          double sampleRate, int bitsPerSample);
+
+    juce::Result readWav(const juce::File& file, juce::AudioBuffer<float>& audio, double& sampleRate);
+
+    // MIDI file in, WAV out
+    juce::Result renderJob(const Job& job, const Settings& settings);
+}
@@ -0,0 +1,302 @@
+#include "OfflineRenderer.h"
+#include "RenderScenarios.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iostream>
+
+// Eskilator_Render: plays Standard MIDI Files through GliderAudioProcessor faster
+// than real time and writes WAV files, or renders the built-in regression scenarios
+// and compares them with reference WAVs. Jobs run in parallel on a thread pool, one
+// processor instance per job.
+namespace
+{
+    const char* const USAGE =
+        "Usage: Eskilator_Render [options] <input.mid> <output.wav>\n"
+        "       Eskilator_Render [options] --jobs=<list>\n"
+        "\n"
+        "Options:\n"
+        "  --sample=<file>   Sample to play (replaces the bank from --state)\n"
+        "  --state=<file>    Plugin state XML as saved by getStateInformation\n"
+        "  --rate=<Hz>       Sample rate (default 48000)\n"
+        "  --block=<frames>  Block size (default 512)\n"
+        "  --channels=<1|2>  Output channels (default 2)\n"
+        "  --bits=<16|24|32> WAV bit depth, 32 = float (default 24)\n"
+        "  --tail=<seconds>  Rendered after the last MIDI event (default 2)\n"
+        "  --double          Use the double-precision processing path\n"
+        "  --live            Use the live engine configuration instead of the offline one\n"
+        "  --threads=<n>     Jobs rendered in parallel (default: number of cores)\n"
+        "\n"
+        "Regression scenarios (fixed settings; the options above don't apply):\n"
+        "  --scenarios=<dir>     Compare each scenario with <dir>/<name>.wav\n"
+        "  --update-references   Write the references instead of comparing\n"
+        "  --tolerance=<value>   Largest accepted per-sample difference (default 1e-4)\n"
+        "  --filter=<text>       Only scenarios whose name contains the text\n"
+        "  --failures=<dir>      Write renders that don't match to <dir>/<name>.wav\n"
+        "  --list-scenarios      List the scenarios and exit\n"
+        "\n"
+        "A job list has one job per line: <input.mid> <output.wav> [sample=<file>] [state=<file>]\n"
+        "Quote paths containing spaces. Relative paths are resolved against the list's folder,\n"
+        "and --sample / --state apply to jobs that don't set their own. Lines starting with # are skipped.\n";
+
+    int fail(const juce::String& message)
+    {
+        std::cerr << message << "\n\n" << USAGE;
+        return 1;
+    }
+
+    juce::Result readJobList(const juce::File& listFile, const OfflineRenderer::Setup& defaults,
+                             juce::Array<OfflineRenderer::Job>& jobs)
+    {
+        juce::StringArray lines;
+        listFile.readLines(lines);
+        const auto directory = listFile.getParentDirectory();
+
+        for (int lineNumber = 0; lineNumber < lines.size(); ++lineNumber)
+        {
+            const auto line = lines[lineNumber].trim();
+            if (line.isEmpty() || line.startsWithChar('#'))
+                continue;
+
+            const auto tokens = juce::StringArray::fromTokens(line, " \t", "\"");
+            juce::StringArray fields;
+            for (const auto& token : tokens)
+                if (token.isNotEmpty())
+                    fields.add(token.unquoted());
+
+            if (fields.size() < 2)
+                return juce::Result::fail(listFile.getFileName() + ":" + juce::String(lineNumber + 1)
+                                          + ": expected <input.mid> <output.wav>");
+
+            OfflineRenderer::Job job;
+            job.midiFile = directory.getChildFile(fields[0]);
+            job.outputFile = directory.getChildFile(fields[1]);
+            job.setup = defaults;
+
+            for (int i = 2; i < fields.size(); ++i)
+            {
+                const auto key = fields[i].upToFirstOccurrenceOf("=", false, false);
+                const auto value = fields[i].fromFirstOccurrenceOf("=", false, false).unquoted();
+
+                if (key == "sample")
+                    job.setup.sampleFile = directory.getChildFile(value);
+                else if (key == "state")
+                    job.setup.stateFile = directory.getChildFile(value);
+                else
+                    return juce::Result::fail(listFile.getFileName() + ":" + juce::String(lineNumber + 1)
+                                              + ": unknown field '" + fields[i] + "'");
+            }
+
+            jobs.add(job);
+        }
+
+        return jobs.isEmpty() ? juce::Result::fail(listFile.getFullPathName() + " contains no jobs")
+                              : juce::Result::ok();
+    }
+
+    int getNumThreads(const juce::ArgumentList& arguments)
+    {
+        return arguments.containsOption("--threads")
+            ? juce::jmax(1, arguments.getValueForOption("--threads").getIntValue())
+            : juce::jmax(1, juce::SystemStats::getNumCpus());
+    }
+
+    // Runs task(0 .. numTasks - 1) on a thread pool and returns how many failed
+    int runInParallel(int numThreads, int numTasks, const std::function<bool(int)>& task)
+    {
+        if (numTasks == 0)
+            return 0;
+
+        juce::ThreadPool pool(juce::jmin(numThreads, numTasks));
+        juce::WaitableEvent allDone;
+        std::atomic<int> remaining { numTasks };
+        std::atomic<int> numFailed { 0 };
+
+        for (int index = 0; index < numTasks; ++index)
+        {
+            pool.addJob([index, &task, &allDone, &remaining, &numFailed]
+            {
+                if (!task(index))
+                    ++numFailed;
+                if (--remaining == 0)
+                    allDone.signal();
+            });
+        }
+
+        allDone.wait();
+        return numFailed;
+    }
+
+    int runScenarios(const juce::ArgumentList& arguments)
+    {
+        auto scenarios = RenderScenarios::createScenarios();
+
+        const auto filter = arguments.getValueForOption("--filter");
+        if (filter.isNotEmpty())
+            scenarios.erase(std::remove_if(scenarios.begin(), scenarios.end(),
+                                           [&filter](const auto& scenario) { return !scenario.name.contains(filter); }),
+                            scenarios.end());
+
+        if (arguments.containsOption("--list-scenarios"))
+        {
+            for (const auto& scenario : scenarios)
+                std::cout << scenario.name.paddedRight(' ', 32) << scenario.description << "\n";
+            return 0;
+        }
+
+        const auto referenceDirectory = arguments.getFileForOption("--scenarios");
+        const auto failureDirectory = arguments.containsOption("--failures") ? arguments.getFileForOption("--failures") : juce::File();
+        const bool updateReferences = arguments.containsOption("--update-references");
+        const float tolerance = arguments.containsOption("--tolerance")
+            ? arguments.getValueForOption("--tolerance").getFloatValue() : RenderScenarios::DEFAULT_TOLERANCE;
+
+        if (scenarios.empty())
+            return fail("No scenario matches --filter=" + filter);
+
+        juce::CriticalSection outputLock;
+        const int numFailed = runInParallel(getNumThreads(arguments), static_cast<int>(scenarios.size()), [&](int index)
+        {
+            const auto& scenario = scenarios[static_cast<size_t>(index)];
+            const auto settings = RenderScenarios::getSettings(scenario);
+            const auto referenceFile = referenceDirectory.getChildFile(scenario.name + ".wav");
+
+            juce::AudioBuffer<float> audio;
+            auto result = OfflineRenderer::render(scenario.sequence, scenario.setup, settings, audio);
+            juce::String message;
+
+            if (result.wasOk() && updateReferences)
+            {
+                result = OfflineRenderer::writeWav(referenceFile, audio, settings.sampleRate, settings.bitsPerSample);
+                message = "Wrote " + referenceFile.getFullPathName();
+            }
+            else if (result.wasOk())
+            {
+                juce::AudioBuffer<float> reference;
+                double referenceRate = 0.0;
+                result = referenceFile.existsAsFile()
+                    ? OfflineRenderer::readWav(referenceFile, reference, referenceRate)
+                    : juce::Result::fail("no reference " + referenceFile.getFullPathName() + " (run with --update-references)");
+
+                if (result.wasOk() && referenceRate != settings.sampleRate)
+                    result = juce::Result::fail("reference is at " + juce::String(referenceRate) + " Hz");
+
+                if (result.wasOk())
+                {
+                    const auto comparison = RenderScenarios::compare(audio, reference, settings.sampleRate, tolerance);
+                    if (!comparison.matches)
+                        result = juce::Result::fail(comparison.report);
+                    message = "PASS " + scenario.name + ": " + comparison.report;
+                }
+
+                if (result.failed() && failureDirectory != juce::File())
+                    OfflineRenderer::writeWav(failureDirectory.getChildFile(scenario.name + ".wav"), audio,
+                                              settings.sampleRate, settings.bitsPerSample);
+            }
+
+            const juce::ScopedLock scopedLock(outputLock);
+            if (result.wasOk())
+                std::cout << message << "\n";
+            else
+                std::cerr << "FAIL " << scenario.name << ": " << result.getErrorMessage() << "\n";
+
+            return result.wasOk();
+        });
+
+        std::cout << static_cast<int>(scenarios.size()) - numFailed << " of " << static_cast<int>(scenarios.size())
+                  << (updateReferences ? " references written\n" : " scenarios match\n");
+        return numFailed > 0 ? 1 : 0;
+    }
+
+    int run(const juce::ArgumentList& arguments)
+    {
+        if (arguments.containsOption("--help|-h") || arguments.size() == 0)
+        {
+            std::cout << USAGE;
+            return 0;
+        }
+
+        if (arguments.containsOption("--scenarios") || arguments.containsOption("--list-scenarios"))
+            return runScenarios(arguments);
+
+        OfflineRenderer::Settings settings;
+        if (arguments.containsOption("--rate"))
+            settings.sampleRate = arguments.getValueForOption("--rate").getDoubleValue();
+        if (arguments.containsOption("--block"))
+            settings.blockSize = arguments.getValueForOption("--block").getIntValue();
+        if (arguments.containsOption("--channels"))
+            settings.numChannels = arguments.getValueForOption("--channels").getIntValue();
+        if (arguments.containsOption("--bits"))
+            settings.bitsPerSample = arguments.getValueForOption("--bits").getIntValue();
+        if (arguments.containsOption("--tail"))
+            settings.tailSeconds = arguments.getValueForOption("--tail").getDoubleValue();
+        settings.doublePrecision = arguments.containsOption("--double");
+        settings.realtimeEngine = arguments.containsOption("--live");
+
+        if (settings.sampleRate < 8000.0 || settings.sampleRate > 768000.0)
+            return fail("--rate must be between 8000 and 768000");
+        if (settings.blockSize < 1 || settings.blockSize > 65536)
+            return fail("--block must be between 1 and 65536");
+        if (settings.numChannels != 1 && settings.numChannels != 2)
+            return fail("--channels must be 1 or 2");
+        if (settings.bitsPerSample != 16 && settings.bitsPerSample != 24 && settings.bitsPerSample != 32)
+            return fail("--bits must be 16, 24 or 32");
+        if (settings.tailSeconds < 0.0)
+            return fail("--tail must not be negative");
+
+        OfflineRenderer::Setup defaults;
+        if (arguments.containsOption("--sample"))
+            defaults.sampleFile = arguments.getExistingFileForOption("--sample");
+        if (arguments.containsOption("--state"))
+            defaults.stateFile = arguments.getExistingFileForOption("--state");
+
+        juce::Array<OfflineRenderer::Job> jobs;
+        if (arguments.containsOption("--jobs"))
+        {
+            const auto result = readJobList(arguments.getExistingFileForOption("--jobs"), defaults, jobs);
+            if (result.failed())
+                return fail(result.getErrorMessage());
+        }
+        else
+        {
+            juce::Array<juce::ArgumentList::Argument> paths;
+            for (const auto& argument : arguments.arguments)
+                if (!argument.isOption())
+                    paths.add(argument);
+
+            if (paths.size() != 2)
+                return fail("Expected <input.mid> <output.wav> or --jobs=<list>");
+
+            jobs.add({ paths[0].resolveAsExistingFile(), paths[1].resolveAsFile(), defaults });
+        }
+
+        juce::CriticalSection outputLock;
+        const int numFailed = runInParallel(getNumThreads(arguments), jobs.size(), [&](int index)
+        {
+            const auto& job = jobs.getReference(index);
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+            const auto result = OfflineRenderer::renderJob(job, settings);
+            const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+            const juce::ScopedLock scopedLock(outputLock);
+            if (result.wasOk())
+                std::cout << "Rendered " << job.outputFile.getFullPathName() << " in "
+                          << juce::String(seconds, 2) << " s\n";
+            else
+                std::cerr << "Failed " << job.midiFile.getFullPathName() << ": " << result.getErrorMessage() << "\n";
+
+            return result.wasOk();
+        });
+
+        return numFailed > 0 ? 1 : 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    const juce::ArgumentList arguments(argc, argv);
+
+    // Missing files and option values throw from the ArgumentList helpers; report them and return 1
+    return juce::ConsoleApplication::invokeCatchingFailures([&arguments] { return run(arguments); });
+}
@@ -0,0 +1,242 @@
+#include "RenderScenarios.h"
+#include "ParameterManager.h"
+#include "EngineConfig.h"
+
+#include <cmath>
+
+namespace
+{
+    constexpr double SCENARIO_SAMPLE_RATE = 44100.0;
+    constexpr int SCENARIO_BLOCK_SIZE = 512;
+    constexpr float GLIDE_TIME_MS = 200.0f;
+
+    double frameTime(int frame)
+    {
+        return frame / SCENARIO_SAMPLE_RATE;
+    }
+
+    void addNote(juce::MidiMessageSequence& sequence, int noteNumber, double startSeconds, double endSeconds,
+                 float velocity = 0.8f)
+    {
+        sequence.addEvent(juce::MidiMessage::noteOn(1, noteNumber, velocity), startSeconds);
+        sequence.addEvent(juce::MidiMessage::noteOff(1, noteNumber), endSeconds);
+    }
+
+    RenderScenarios::Scenario makeScenario(const juce::String& name, const juce::String& description,
+                                           float glideTimeMs, int glideSteps = static_cast<int>(ParameterManager::GLIDE_STEPS_DEFAULT),
+                                           ParameterManager::GlideMode glideMode = ParameterManager::GlideMode::Stepped)
+    {
+        RenderScenarios::Scenario scenario;
+        scenario.name = name;
+        scenario.description = description;
+        scenario.setup.parameters.set("glideTime", glideTimeMs);
+        scenario.setup.parameters.set("glideSteps", glideSteps);
+        scenario.setup.parameters.set("glideMode", static_cast<int>(glideMode));
+        return scenario;
+    }
+
+    // Three overlapping notes: up a fifth, then down past the start
+    void addGlidePhrase(juce::MidiMessageSequence& sequence)
+    {
+        addNote(sequence, 60, 0.0, 0.35);
+        addNote(sequence, 67, 0.3, 0.65);
+        addNote(sequence, 55, 0.6, 1.0);
+    }
+}
+
+namespace RenderScenarios
+{
+    std::vector<Scenario> createScenarios()
+    {
+        std::vector<Scenario> scenarios;
+
+        {
+            auto scenario = makeScenario("single-note", "One note at the sample's root, attack to release", 0.0f);
+            addNote(scenario.sequence, 60, 0.0, 1.0);
+            scenarios.push_back(std::move(scenario));
+        }
+
+        {
+            auto scenario = makeScenario("single-note-transposed", "One quiet note an octave and a fifth apart from the root", 0.0f);
+            addNote(scenario.sequence, 79, 0.0, 0.5, 0.3f);
+            addNote(scenario.sequence, 41, 0.6, 1.1, 0.3f);
+            scenarios.push_back(std::move(scenario));
+        }
+
+        for (int steps = static_cast<int>(ParameterManager::GLIDE_STEPS_MIN); steps <= static_cast<int>(ParameterManager::GLIDE_STEPS_MAX); ++steps)
+        {
+            auto scenario = makeScenario("glide-steps-" + juce::String(steps), "Stepped glide over overlapping notes, "
+                                         + juce::String(steps) + " steps", GLIDE_TIME_MS, steps);
+            addGlidePhrase(scenario.sequence);
+            scenarios.push_back(std::move(scenario));
+        }
+
+        const std::pair<const char*, ParameterManager::GlideMode> glideModes[] = {
+            { "glide-linear", ParameterManager::GlideMode::Linear },
+            { "glide-exponential", ParameterManager::GlideMode::Exponential },
+            { "glide-stepped-slew", ParameterManager::GlideMode::SteppedSlew }
+        };
+
+        for (const auto& [name, mode] : glideModes)
+        {
+            auto scenario = makeScenario(name, juce::String("Glide phrase in ") + name + " mode", GLIDE_TIME_MS, 8, mode);
+            addGlidePhrase(scenario.sequence);
+            scenarios.push_back(std::move(scenario));
+        }
+
+        {
+            auto scenario = makeScenario("glide-legato", "8-step glide phrase with legato on", GLIDE_TIME_MS, 8);
+            scenario.setup.parameters.set("legato", 1);
+            addGlidePhrase(scenario.sequence);
+            scenarios.push_back(std::move(scenario));
+        }
+
+        {
+            auto scenario = makeScenario("rapid-retrigger", "Separate 8 ms notes every 10 ms", 0.0f);
+            for (int i = 0; i < 50; ++i)
+                addNote(scenario.sequence, 60 + (i % 5) * 2, i * 0.01, i * 0.01 + 0.008);
+            scenarios.push_back(std::move(scenario));
+        }
+
+        {
+            auto scenario = makeScenario("rapid-retrigger-glide", "Overlapping notes every 10 ms with a short 4-step glide", 50.0f, 4);
+            for (int i = 0; i < 50; ++i)
+                addNote(scenario.sequence, 60 + (i % 5) * 2, i * 0.01, i * 0.01 + 0.015);
+            scenarios.push_back(std::move(scenario));
+        }
+
+        // The restart crossfade starts at the retrigger; these release inside it
+        const int retriggerFrame = 22050;
+        const int crossfadeFrames = static_cast<int>(EngineConfig::LIVE_CROSSFADE_MS * SCENARIO_SAMPLE_RATE / 1000.0);
+
+        {
+            auto scenario = makeScenario("note-off-in-crossfade", "Retrigger, then release halfway through the restart crossfade", 0.0f);
+            addNote(scenario.sequence, 60, 0.0, frameTime(retriggerFrame));
+            addNote(scenario.sequence, 64, frameTime(retriggerFrame), frameTime(retriggerFrame + crossfadeFrames / 2));
+            scenarios.push_back(std::move(scenario));
+        }
+
+        {
+            auto scenario = makeScenario("note-off-at-retrigger", "Retrigger and release one frame later", 0.0f);
+            addNote(scenario.sequence, 60, 0.0, frameTime(retriggerFrame));
+            addNote(scenario.sequence, 64, frameTime(retriggerFrame), frameTime(retriggerFrame + 1));
+            scenarios.push_back(std::move(scenario));
+        }
+
+        {
+            auto scenario = makeScenario("note-off-in-crossfade-glide", "Gliding retrigger released inside the restart crossfade", GLIDE_TIME_MS, 8);
+            addNote(scenario.sequence, 60, 0.0, frameTime(retriggerFrame + crossfadeFrames / 4));
+            addNote(scenario.sequence, 67, frameTime(retriggerFrame), frameTime(retriggerFrame + crossfadeFrames / 2));
+            scenarios.push_back(std::move(scenario));
+        }
+
+        {
+            // Retriggers alternate between two copies of the sample with different playback
+            // points, so every restart crossfade fades out of the other copy
+            auto scenario = makeScenario("round-robin-retrigger", "Repeated notes in a two-sample round-robin group", 0.0f);
+            OfflineRenderer::BuiltInSample fromStart;
+            fromStart.mapping.roundRobinGroup = 1;
+
+            OfflineRenderer::BuiltInSample looping;
+            looping.mapping.roundRobinGroup = 1;
+            looping.loop.start = 44100;
+            looping.loop.mode = SampleLoop::Mode::Forward;
+            looping.loop.loopStart = 88200;
+            looping.loop.loopEnd = 110250;
+            looping.loop.crossfade = 441;
+
+            scenario.setup.builtInSamples = { fromStart, looping };
+            for (int i = 0; i < 8; ++i)
+                addNote(scenario.sequence, 60, i * 0.3, i * 0.3 + 0.35);
+            scenarios.push_back(std::move(scenario));
+        }
+
+        {
+            auto scenario = makeScenario("block-edge-events", "Notes starting and ending on either side of block boundaries", GLIDE_TIME_MS, 4);
+            for (int block = 1; block <= 8; ++block)
+            {
+                const int edge = block * SCENARIO_BLOCK_SIZE * 4;
+                addNote(scenario.sequence, 60 + block, frameTime(edge - 1), frameTime(edge + SCENARIO_BLOCK_SIZE * 2));
+            }
+            scenarios.push_back(std::move(scenario));
+        }
+
+        for (auto& scenario : scenarios)
+            scenario.sequence.updateMatchedPairs();
+
+        return scenarios;
+    }
+
+    OfflineRenderer::Settings getSettings(const Scenario& scenario)
+    {
+        OfflineRenderer::Settings settings;
+        settings.sampleRate = SCENARIO_SAMPLE_RATE;
+        settings.blockSize = SCENARIO_BLOCK_SIZE;
+        settings.numChannels = 2;
+        settings.bitsPerSample = 32;
+        settings.tailSeconds = scenario.tailSeconds;
+        settings.realtimeEngine = true;
+        settings.pinFullQuality = true;
+        return settings;
+    }
+
+    Comparison compare(const juce::AudioBuffer<float>& actual, const juce::AudioBuffer<float>& expected,
+                       double sampleRate, float tolerance)
+    {
+        Comparison comparison;
+
+        if (actual.getNumChannels() != expected.getNumChannels())
+        {
+            comparison.report = "channel count " + juce::String(actual.getNumChannels())
+                              + ", reference has " + juce::String(expected.getNumChannels());
+            return comparison;
+        }
+
+        const int numFrames = juce::jmin(actual.getNumSamples(), expected.getNumSamples());
+        int firstFrame = -1;
+        int firstChannel = 0;
+        float maxDifference = 0.0f;
+        int numDivergent = 0;
+
+        for (int frame = 0; frame < numFrames; ++frame)
+        {
+            bool diverges = false;
+            for (int channel = 0; channel < actual.getNumChannels(); ++channel)
+            {
+                const float difference = std::abs(actual.getSample(channel, frame) - expected.getSample(channel, frame));
+                maxDifference = juce::jmax(maxDifference, difference);
+
+                if (difference > tolerance && !diverges)
+                {
+                    diverges = true;
+                    if (firstFrame < 0)
+                    {
+                        firstFrame = frame;
+                        firstChannel = channel;
+                    }
+                }
+            }
+
+            if (diverges)
+                ++numDivergent;
+        }
+
+        juce::StringArray problems;
+        if (actual.getNumSamples() != expected.getNumSamples())
+            problems.add("length " + juce::String(actual.getNumSamples()) + " frames, reference has "
+                         + juce::String(expected.getNumSamples()));
+
+        if (firstFrame >= 0)
+            problems.add("first divergence at frame " + juce::String(firstFrame)
+                         + " (" + juce::String(firstFrame / sampleRate, 4) + " s), channel " + juce::String(firstChannel)
+                         + ": got " + juce::String(actual.getSample(firstChannel, firstFrame), 6)
+                         + ", expected " + juce::String(expected.getSample(firstChannel, firstFrame), 6)
+                         + "; " + juce::String(numDivergent) + " frames differ by more than " + juce::String(tolerance)
+                         + ", at most " + juce::String(maxDifference));
+
+        comparison.matches = problems.isEmpty();
+        comparison.report = comparison.matches ? "max difference " + juce::String(maxDifference)
+                                               : problems.joinIntoString("; ");
+        return comparison;
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "OfflineRenderer.h"
+
+#include <vector>
+
+// Fixed MIDI scenarios for golden-render regression checks of the glide, restart
+// crossfade and envelope behaviour (Eskilator_Render --scenarios=<dir>).
+//
+// Every scenario plays the built-in sample through the live engine at 44.1 kHz in
+// 512-frame blocks, so the reference WAVs capture what a DAW session hears. The engine
+// is pinned to the CPU governor's Full tier, so a slow block (debug or sanitizer build,
+// loaded CI machine) can't change the render.
+namespace RenderScenarios
+{
+    // Largest per-sample difference accepted by default (about -80 dBFS)
+    static constexpr float DEFAULT_TOLERANCE = 1.0e-4f;
+
+    struct Scenario
+    {
+        juce::String name;                  // Also the reference file name, <name>.wav
+        juce::String description;
+        juce::MidiMessageSequence sequence; // Timestamps in seconds
+        OfflineRenderer::Setup setup;
+        double tailSeconds = 0.5;
+    };
+
+    std::vector<Scenario> createScenarios();
+
+    // Settings a scenario renders with (references are 32-bit float WAVs)
+    OfflineRenderer::Settings getSettings(const Scenario& scenario);
+
+    struct Comparison
+    {
+        bool matches = false;
+        juce::String report;                // First divergent sample and the largest difference
+    };
+
+    Comparison compare(const juce::AudioBuffer<float>& actual, const juce::AudioBuffer<float>& expected,
+                       double sampleRate, float tolerance);
+}
@@ -0,0 +1,298 @@
+#include "PluginProcessor.h"
+
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Eskilator_Stress: concurrency stress test for the sample bank. Editor-style threads
+// load, remove and clear samples, a host-style thread saves and restores the state and
+// a reader polls what the editor displays, all while a render thread calls processBlock
+// back to back. Built with ESKILATOR_SANITIZER=thread or address, any data race
+// or use-after-free the sanitizer reports fails the run.
+
+#if defined (__SANITIZE_THREAD__) || defined (__SANITIZE_ADDRESS__)
+ #define ESKILATOR_SANITIZED 1
+#elif defined (__has_feature)
+ #if __has_feature(thread_sanitizer) || __has_feature(address_sanitizer)
+  #define ESKILATOR_SANITIZED 1
+ #endif
+#endif
+
+#if defined (ESKILATOR_SANITIZED)
+// Stop at the first report with a non-zero exit code. TSAN_OPTIONS / ASAN_OPTIONS
+// from the environment still override these.
+extern "C" const char* __tsan_default_options() { return "halt_on_error=1:second_deadlock_stack=1"; }
+extern "C" const char* __asan_default_options() { return "halt_on_error=1:detect_stack_use_after_return=1"; }
+#endif
+
+namespace
+{
+    const char* const USAGE =
+        "Usage: Eskilator_Stress [options]\n"
+        "\n"
+        "Options:\n"
+        "  --seconds=<n>     How long to run (default 10)\n"
+        "  --editors=<n>     Threads loading, removing and clearing samples (default 3)\n"
+        "  --rate=<Hz>       Sample rate (default 48000)\n"
+        "  --block=<frames>  Block size (default 128)\n"
+        "  --seed=<n>        Seed for the editor threads' choices (default: random)\n"
+        "\n"
+        "Exits with 1 if the render thread produced invalid output or an operation threw.\n";
+
+    // Bank size the editor threads keep below, so state round trips stay quick
+    static constexpr int MAX_BANK_SIZE = 12;
+
+    int fail(const juce::String& message)
+    {
+        std::cerr << message << "\n\n" << USAGE;
+        return 1;
+    }
+
+    struct Counters
+    {
+        std::atomic<std::int64_t> blocks { 0 };
+        std::atomic<std::int64_t> loads { 0 };
+        std::atomic<std::int64_t> removes { 0 };
+        std::atomic<std::int64_t> clears { 0 };
+        std::atomic<std::int64_t> edits { 0 };
+        std::atomic<std::int64_t> stateRoundTrips { 0 };
+        std::atomic<std::int64_t> displayReads { 0 };
+        std::atomic<int> failures { 0 };
+    };
+
+    // Short test tones at several rates and channel counts, so loads take both the
+    // direct and the resampling path
+    juce::Array<juce::File> writeTestSamples(const juce::File& directory, double sessionRate)
+    {
+        struct Spec { double rate; int channels; double seconds; };
+        const Spec specs[] = { { sessionRate, 2, 0.5 }, { 44100.0, 1, 0.25 }, { 96000.0, 2, 0.4 }, { 22050.0, 1, 1.0 } };
+
+        juce::Array<juce::File> files;
+        juce::WavAudioFormat wavFormat;
+
+        for (const auto& spec : specs)
+        {
+            const auto file = directory.getChildFile("tone-" + juce::String(files.size()) + ".wav");
+            juce::AudioBuffer<float> audio(spec.channels, static_cast<int>(spec.rate * spec.seconds));
+            for (int channel = 0; channel < audio.getNumChannels(); ++channel)
+                for (int frame = 0; frame < audio.getNumSamples(); ++frame)
+                    audio.setSample(channel, frame, 0.5f * std::sin(juce::MathConstants<float>::twoPi * 220.0f
+                                                                      * static_cast<float>(frame / spec.rate)));
+
+            auto stream = std::make_unique<juce::FileOutputStream>(file);
+            if (!stream->openedOk())
+                continue;
+
+            std::unique_ptr<juce::AudioFormatWriter> writer(
+                wavFormat.createWriterFor(stream.get(), spec.rate, static_cast<unsigned int>(spec.channels), 24, {}, 0));
+            if (writer == nullptr)
+                continue;
+            stream.release();
+
+            writer->writeFromAudioSampleBuffer(audio, 0, audio.getNumSamples());
+            files.add(file);
+        }
+
+        return files;
+    }
+
+    // Calls fn until 'running' clears, counting exceptions as failures
+    template <typename Function>
+    void runUntilStopped(const std::atomic<bool>& running, Counters& counters, const char* threadName, Function&& fn)
+    {
+        try
+        {
+            while (running.load(std::memory_order_relaxed))
+                fn();
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << threadName << " thread threw: " << e.what() << "\n";
+            ++counters.failures;
+        }
+    }
+
+    int run(const juce::ArgumentList& arguments)
+    {
+        if (arguments.containsOption("--help|-h"))
+        {
+            std::cout << USAGE;
+            return 0;
+        }
+
+        const double seconds = arguments.containsOption("--seconds") ? arguments.getValueForOption("--seconds").getDoubleValue() : 10.0;
+        const int numEditors = arguments.containsOption("--editors") ? arguments.getValueForOption("--editors").getIntValue() : 3;
+        const double sampleRate = arguments.containsOption("--rate") ? arguments.getValueForOption("--rate").getDoubleValue() : 48000.0;
+        const int blockSize = arguments.containsOption("--block") ? arguments.getValueForOption("--block").getIntValue() : 128;
+        const auto seed = arguments.containsOption("--seed") ? static_cast<std::uint32_t>(arguments.getValueForOption("--seed").getLargeIntValue())
+                                                               : std::random_device()();
+
+        if (seconds <= 0.0)
+            return fail("--seconds must be positive");
+        if (numEditors < 1 || numEditors > 64)
+            return fail("--editors must be between 1 and 64");
+        if (sampleRate < 8000.0 || sampleRate > 768000.0)
+            return fail("--rate must be between 8000 and 768000");
+        if (blockSize < 1 || blockSize > 65536)
+            return fail("--block must be between 1 and 65536");
+
+        const auto directory = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                   .getNonexistentChildFile("eskilator-stress", "");
+        directory.createDirectory();
+        const auto files = writeTestSamples(directory, sampleRate);
+        if (files.isEmpty())
+            return fail("Could not write test samples to " + directory.getFullPathName());
+
+        GliderAudioProcessor processor;
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        std::cout << "Stressing the sample bank for " << seconds << " s with " << numEditors
+                  << " editor threads, seed " << seed << "\n";
+
+        Counters counters;
+        std::atomic<bool> running { true };
+        std::vector<std::thread> threads;
+
+        // Audio thread: back-to-back blocks with a note change every few blocks
+        threads.emplace_back([&]
+        {
+            runUntilStopped(running, counters, "Render", [&, block = juce::AudioBuffer<float>(2, blockSize),
+                                                          midi = juce::MidiBuffer(), blockIndex = 0]() mutable
+            {
+                const int noteNumber = 48 + (blockIndex / 4) % 24;
+                midi.clear();
+                if (blockIndex % 4 == 0)
+                    midi.addEvent(juce::MidiMessage::noteOn(1, noteNumber, 0.8f), 0);
+                else if (blockIndex % 4 == 3)
+                    midi.addEvent(juce::MidiMessage::noteOff(1, noteNumber), blockSize / 2);
+                ++blockIndex;
+
+                block.clear();
+                processor.processBlock(block, midi);
+                ++counters.blocks;
+
+                for (int channel = 0; channel < block.getNumChannels(); ++channel)
+                {
+                    const auto range = block.findMinMax(channel, 0, block.getNumSamples());
+                    if (!std::isfinite(range.getStart()) || !std::isfinite(range.getEnd()))
+                    {
+                        std::cerr << "Render thread produced non-finite output in block " << blockIndex << "\n";
+                        ++counters.failures;
+                        running = false;
+                        return;
+                    }
+                }
+            });
+        });
+
+        // Message-thread stand-ins: drag and drop, remove buttons, clear, per-sample edits
+        for (int editor = 0; editor < numEditors; ++editor)
+        {
+            threads.emplace_back([&, editor]
+            {
+                std::mt19937 random(seed + static_cast<std::uint32_t>(editor));
+                runUntilStopped(running, counters, "Editor", [&]
+                {
+                    const int sampleCount = processor.getSampleCount();
+                    const int choice = std::uniform_int_distribution<int>(0, 99)(random);
+                    const int index = std::uniform_int_distribution<int>(0, juce::jmax(0, sampleCount - 1))(random);
+
+                    if (choice < 45 && sampleCount < MAX_BANK_SIZE)
+                    {
+                        processor.loadSample(files[std::uniform_int_distribution<int>(0, files.size() - 1)(random)]);
+                        ++counters.loads;
+                    }
+                    else if (choice < 75)
+                    {
+                        processor.removeSample(index);
+                        ++counters.removes;
+                    }
+                    else if (choice < 80)
+                    {
+                        processor.clearSampleBank();
+                        ++counters.clears;
+                    }
+                    else
+                    {
+                        processor.setSampleGain(index, std::uniform_real_distribution<float>(-24.0f, 24.0f)(random));
+                        processor.setSampleTranspose(index, std::uniform_real_distribution<float>(-12.0f, 12.0f)(random));
+                        ++counters.edits;
+                    }
+                });
+            });
+        }
+
+        // Host state thread: save and restore, as hosts do off the message thread
+        threads.emplace_back([&]
+        {
+            runUntilStopped(running, counters, "State", [&]
+            {
+                juce::MemoryBlock state;
+                processor.getStateInformation(state);
+                processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+                ++counters.stateRoundTrips;
+            });
+        });
+
+        // Editor display: what paint() and the waveform view read
+        threads.emplace_back([&]
+        {
+            runUntilStopped(running, counters, "Display", [&]
+            {
+                for (int index = 0; index < processor.getSampleCount(); ++index)
+                {
+                    juce::ignoreUnused(processor.getSampleName(index), processor.getSampleDuration(index),
+                                       processor.getSampleGain(index), processor.getSampleTranspose(index));
+
+                    if (const auto buffer = processor.getSampleBufferForDisplay(index))
+                        for (int channel = 0; channel < buffer->getNumChannels(); ++channel)
+                            juce::ignoreUnused(buffer->findMinMax(channel, 0, buffer->getNumSamples()));
+
+                    if (const auto waveform = processor.getSampleWaveform(index))
+                        for (int peak = 0; peak < waveform->numPeaks; ++peak)
+                            juce::ignoreUnused(waveform->getMinima(0)[peak], waveform->getMaxima(0)[peak]);
+                }
+
+                juce::ignoreUnused(processor.getCurrentSampleName(), processor.getOriginalSampleRate());
+                ++counters.displayReads;
+            });
+        });
+
+        const auto endTime = juce::Time::getMillisecondCounterHiRes() + seconds * 1000.0;
+        while (running && juce::Time::getMillisecondCounterHiRes() < endTime)
+            juce::Thread::sleep(50);
+
+        running = false;
+        for (auto& thread : threads)
+            thread.join();
+
+        processor.releaseResources();
+        directory.deleteRecursively();
+
+        std::cout << "Rendered " << counters.blocks << " blocks; " << counters.loads << " loads, "
+                  << counters.removes << " removes, " << counters.clears << " clears, "
+                  << counters.edits << " edits, " << counters.stateRoundTrips << " state round trips, "
+                  << counters.displayReads << " display reads\n";
+
+        if (counters.failures > 0)
+        {
+            std::cerr << counters.failures << " failure(s)\n";
+            return 1;
+        }
+
+        std::cout << "OK\n";
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    const juce::ArgumentList arguments(argc, argv);
+
+    return juce::ConsoleApplication::invokeCatchingFailures([&arguments] { return run(arguments); });
+}